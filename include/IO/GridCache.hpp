@@ -0,0 +1,164 @@
+// File: GridCache.hpp
+#ifndef GRID_CACHE_HPP
+#define GRID_CACHE_HPP
+
+#include "map/MapProcessingCommon.h" // For Grid_V3, NormalizationResult
+#include "map/MapProcessor.hpp"      // For ObstacleConfigMap
+#include "map/ElevationRaster.hpp"   // For ElevationRaster
+#include "algoritms/LandmarkHeuristic.hpp" // For LandmarkHeuristic
+#include "algoritms/ContractionHierarchy.hpp" // For ContractionHierarchy
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <optional>
+
+namespace gridcache {
+
+    /** @brief Bump whenever the on-disk layout or the rasterization output changes. */
+    constexpr std::uint32_t GRID_CACHE_FORMAT_VERSION = 1;
+    /** @brief Bump whenever the landmark-table layout or the landmark selection/search changes. */
+    constexpr std::uint32_t LANDMARK_CACHE_FORMAT_VERSION = 2;
+    /** @brief Bump whenever the contraction-hierarchy layout or its (nested-dissection) order changes. */
+    constexpr std::uint32_t CONTRACTION_CACHE_FORMAT_VERSION = 1;
+
+    /**
+     * @brief A grid and its normalization parameters as restored from the cache.
+     */
+    struct CachedGrid {
+        mapgeo::Grid_V3 grid;
+        mapgeo::NormalizationResult normInfo;
+    };
+
+    /**
+     * @brief Computes the cache key for a processed grid.
+     *
+     * The key is a 64-bit FNV-1a hash over the map file *contents*, the grid dimensions,
+     * the layer list, every (symbol, cost) pair of the obstacle configuration, the merge
+     * mode and the cache format version. Any change to one of these yields a new key,
+     * so edited maps or configs never hit a stale entry.
+     *
+     * @return The key, or std::nullopt if the map file cannot be read.
+     */
+    std::optional<std::uint64_t> computeGridCacheKey(
+        const std::string& mapFilePath,
+        int gridWidth,
+        int gridHeight,
+        const std::vector<std::string>& layers,
+        const mapgeo::ObstacleConfigMap& obstacleConfig,
+        bool tileBinnedMerge
+    );
+
+    /**
+     * @brief Key of the inputs a long-lived result (an LPA* replanning session) was built from.
+     *
+     * FNV-1a over the map and controls file *contents*, every MapProcessorConfig field and a
+     * caller-serialized string of further settings (e.g. elevation options). Obstacle costs are
+     * not included: those are what a session absorbs incrementally.
+     *
+     * @return The key, or std::nullopt if either file cannot be read.
+     */
+    std::optional<std::uint64_t> computeSourceKey(
+        const std::string& mapFilePath,
+        const std::string& controlsFilePath,
+        const mapgeo::MapProcessorConfig& processorConfig,
+        const std::string& settings
+    );
+
+    /** @brief Default size limit of a cache directory; the save functions prune to it after writing. */
+    constexpr std::uint64_t DEFAULT_CACHE_BUDGET_BYTES = 4ull << 30;
+
+    /** @brief Default cache directory: <system temp>/omap_grid_cache. */
+    std::string defaultCacheDirectory();
+
+    /**
+     * @brief Bounds the size of a cache directory.
+     *
+     * Removes grid, landmark and contraction entries, least recently written or loaded first, until
+     * the rest fits in maxBytes (the newest entry is always kept), and temporary files older than an
+     * hour, which writers that died mid-write leave behind. Other files are never touched.
+     * @return Number of files removed.
+     */
+    std::size_t pruneCacheDirectory(const std::string& cacheDirectory, std::uint64_t maxBytes = DEFAULT_CACHE_BUDGET_BYTES);
+
+    /** @brief Full path of the cache entry for a key inside a cache directory. */
+    std::string cacheFilePath(const std::string& cacheDirectory, std::uint64_t key);
+
+    /**
+     * @brief Loads a cached grid by memory-mapping its cache entry.
+     *
+     * The header (magic, format version, key, dimensions, payload size) and a checksum over
+     * header and payload are verified before anything is returned. Missing, stale or corrupt
+     * entries yield std::nullopt (corrupt ones are removed) so the caller regenerates the grid.
+     */
+    std::optional<CachedGrid> loadGridCache(const std::string& cacheDirectory, std::uint64_t key);
+
+    /**
+     * @brief Writes a grid to the cache. The entry is written to a temporary file of its own (named
+     *        after the process and a random nonce, so concurrent writers never share one) and renamed
+     *        into place, so readers never observe a partially written entry. The directory is then
+     *        pruned to maxCacheBytes (see pruneCacheDirectory()).
+     * @return True on success.
+     */
+    bool saveGridCache(
+        const std::string& cacheDirectory,
+        std::uint64_t key,
+        const mapgeo::Grid_V3& grid,
+        const mapgeo::NormalizationResult& normInfo,
+        std::uint64_t maxCacheBytes = DEFAULT_CACHE_BUDGET_BYTES
+    );
+
+    // --- ALT landmark tables, stored next to the grids ---
+
+    /**
+     * @brief Computes the cache key for ALT landmark tables.
+     *
+     * Hashes the grid contents (values and flags), the resampled elevation, the cell resolution,
+     * the landmark count and both format versions, so the entry is valid for any way the grid
+     * was obtained (cache hit, fresh processing or reuse) and invalid after any change to the
+     * costs the tables were computed from.
+     */
+    std::uint64_t computeLandmarkCacheKey(
+        const mapgeo::Grid_V3& grid,
+        const mapgeo::ElevationRaster& elevation,
+        float logCellResolution,
+        int landmarkCount
+    );
+
+    /** @brief Full path of the landmark-table entry for a key inside a cache directory. */
+    std::string landmarkCacheFilePath(const std::string& cacheDirectory, std::uint64_t key);
+
+    /** @brief Loads landmark tables (verified like loadGridCache; corrupt entries are removed). */
+    std::optional<Pathfinding::LandmarkHeuristic> loadLandmarkCache(const std::string& cacheDirectory, std::uint64_t key);
+
+    /** @brief Writes landmark tables to the cache (atomically and pruning, like saveGridCache). @return True on success. */
+    bool saveLandmarkCache(const std::string& cacheDirectory, std::uint64_t key, const Pathfinding::LandmarkHeuristic& tables,
+        std::uint64_t maxCacheBytes = DEFAULT_CACHE_BUDGET_BYTES);
+
+    // --- Customizable contraction hierarchies, stored next to the grids ---
+
+    /**
+     * @brief Computes the cache key for a customizable contraction hierarchy.
+     *
+     * Hashes only the grid dimensions, which cells are passable and both format versions: that is
+     * all the topology depends on. Costs and elevation are applied after loading by
+     * ContractionHierarchy::customize(), so an entry survives any change of obstacle costs.
+     */
+    std::uint64_t computeContractionCacheKey(const mapgeo::Grid_V3& grid);
+
+    /** @brief Full path of the contraction-hierarchy entry for a key inside a cache directory. */
+    std::string contractionCacheFilePath(const std::string& cacheDirectory, std::uint64_t key);
+
+    /**
+     * @brief Loads a customizable hierarchy (verified like loadGridCache; corrupt entries are removed).
+     * Its weights are those it was saved with: customize() it before querying.
+     */
+    std::optional<Pathfinding::ContractionHierarchy> loadContractionCache(const std::string& cacheDirectory, std::uint64_t key);
+
+    /** @brief Writes a customizable hierarchy to the cache (atomically and pruning, like saveGridCache). @return True on success. */
+    bool saveContractionCache(const std::string& cacheDirectory, std::uint64_t key, const Pathfinding::ContractionHierarchy& hierarchy,
+        std::uint64_t maxCacheBytes = DEFAULT_CACHE_BUDGET_BYTES);
+
+} // namespace gridcache
+
+#endif // GRID_CACHE_HPP
@@ -0,0 +1,37 @@
+// File: RasterExport.hpp
+#ifndef RASTER_EXPORT_HPP
+#define RASTER_EXPORT_HPP
+
+#include "map/MapProcessingCommon.h" // For NormalizationResult
+#include <string>
+#include <vector>
+#include <cstddef>
+
+namespace rasterexport {
+
+    /**
+     * @brief Writes a per-cell float raster aligned with Grid_V3 as an ESRI BIL float grid.
+     *
+     * Produces basePath + ".flt" (little-endian float32, one row of the grid after another,
+     * row 0 first) and basePath + ".hdr" (ncols, nrows, corner, cell size, NODATA_value,
+     * byteorder). Coordinates are the map's internal units (as in the .omap file). Map Y grows
+     * downwards while the format's Y grows upwards, so the header uses Y' = -Y; GIS tools then
+     * show the raster the right way up on top of the map. Non-square cells are written with the
+     * XDIM/YDIM keys instead of cellsize.
+     *
+     * @param values width * height values in Grid_V3 index order.
+     * @param noDataValue Written in place of non-finite values and values >= FLT_MAX (unreachable).
+     * @return True if both files were written, false otherwise (error printed to stderr).
+     */
+    bool saveFloatRaster(
+        const std::string& basePath,
+        const std::vector<float>& values,
+        std::size_t width,
+        std::size_t height,
+        const mapgeo::NormalizationResult& normInfo,
+        float noDataValue = -9999.0f
+    );
+
+} // namespace rasterexport
+
+#endif // RASTER_EXPORT_HPP
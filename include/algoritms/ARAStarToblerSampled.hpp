@@ -0,0 +1,63 @@
+// File: ARAStarToblerSampled.hpp
+#ifndef ARASTAR_TOBLER_SAMPLED_HPP
+#define ARASTAR_TOBLER_SAMPLED_HPP
+
+#include "map/PathfindingUtils.hpp"         // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include "algoritms/SearchWorkspace.hpp"    // For SearchWorkspace
+#include <vector>
+#include <functional>
+#include <cstddef>
+
+namespace Pathfinding {
+
+    /** @brief Tuning of the anytime search. */
+    struct AnytimeSettings {
+        float initial_epsilon = 3.0f;  // Heuristic inflation of the first (fast) solution; >= 1
+        float epsilon_step = 0.5f;     // Decrease of epsilon between solutions (also lowered to the proven bound)
+        double time_budget_ms = 0.0;   // Stop refining after this long; 0 = refine until optimal
+    };
+
+    /** @brief One solution published by the anytime search. */
+    struct AnytimeSolution {
+        std::vector<int> path;          // Grid indices from start to end
+        float cost = 0.0f;              // Tobler cost of path
+        float epsilon = 1.0f;           // Heuristic inflation the solution was found with
+        float suboptimality_bound = 1.0f; // cost <= bound * optimal cost (1 = proven optimal)
+        double elapsed_ms = 0.0;        // Since the search started
+        std::size_t expansions = 0;     // Cells expanded so far, over all iterations
+    };
+
+    /** @brief Called for each solution as soon as it is found (on the searching thread). */
+    using AnytimeSolutionCallback = std::function<void(const AnytimeSolution&)>;
+
+    /**
+     * @brief Anytime Repairing A* (ARA*) on the Tobler costs.
+     *
+     * The first iteration is weighted A* with f = g + epsilon * h, which finds a route quickly.
+     * Each later iteration lowers epsilon and continues from the previous state: g-values and
+     * parents are kept, the open list is re-keyed, and only the cells whose cost improved after they
+     * were expanded (the INCONS set) are reconsidered, so no work is repeated from scratch.
+     * h = min_terrain_cost * Euclidean cells is consistent for the Tobler costs, so every solution
+     * carries the bound min(epsilon, cost / min over OPEN and INCONS of (g + h)).
+     *
+     * Refinement stops at epsilon = 1 (optimal, same cost as Dijkstra) or once time_budget_ms has
+     * passed. The deadline only interrupts refinement: the first solution is always completed.
+     * Keys are not monotone under an inflated heuristic, so the binary heap is always used.
+     * Reads context.edge_costs when present.
+     *
+     * @param on_solution Optional; receives every solution as it is found.
+     * @return The published solutions, best (last) at the back; empty if no path exists.
+     */
+    std::vector<AnytimeSolution> findARAStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end,
+        const AnytimeSettings& settings,
+        const AnytimeSolutionCallback& on_solution = {}
+    );
+
+} // namespace Pathfinding
+
+#endif // ARASTAR_TOBLER_SAMPLED_HPP
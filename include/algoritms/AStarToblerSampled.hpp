@@ -4,6 +4,8 @@
 
 #include "map/MapProcessingCommon.h" // For Grid_V3
 #include "map/PathfindingUtils.hpp"  // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include "algoritms/SearchWorkspace.hpp"    // For SearchWorkspace
 #include <vector>
 
 namespace Pathfinding {
@@ -23,6 +25,32 @@ namespace Pathfinding {
         int heuristic_type
     );
 
+    /**
+     * @brief A* over a prepared PathfindingContext (no per-call elevation resampling, thread-local workspace).
+     */
+    std::vector<int> findAStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end,
+        int heuristic_type
+    );
+
+    /**
+     * @brief A* using a caller-owned SearchWorkspace, so back-to-back legs on one thread
+     *        only pay for the cells they touch. The overload above uses the thread-local workspace.
+     *        With HEURISTIC_ALT and context.landmarks attached the search stays optimal while
+     *        expanding far fewer cells on steep or vegetated maps (see LandmarkHeuristic).
+     *        The search body is specialized on the heuristic and on the context's open list, cost
+     *        model and connectivity (see SearchKernels.hpp).
+     */
+    std::vector<int> findAStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end,
+        int heuristic_type
+    );
+
 } // namespace Pathfinding
 
 #endif // ASTAR_TOBLER_SAMPLED_HPP
@@ -4,6 +4,8 @@
 
 #include "map/MapProcessingCommon.h" // For Grid_V3
 #include "map/PathfindingUtils.hpp"  // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include "algoritms/SearchWorkspace.hpp"    // For SearchWorkspace
 #include <vector>
 
 namespace Pathfinding {
@@ -24,6 +26,26 @@ namespace Pathfinding {
         const GridPoint& end
     );
 
+    /**
+     * @brief BFS over a prepared PathfindingContext (no per-call elevation resampling, thread-local workspace).
+     */
+    std::vector<int> findBFSPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end
+    );
+
+    /**
+     * @brief BFS using a caller-owned SearchWorkspace, so back-to-back legs on one thread
+     *        only pay for the cells they touch. The overload above uses the thread-local workspace.
+     */
+    std::vector<int> findBFSPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end
+    );
+
 } // namespace Pathfinding
 
 #endif // BFS_TOBLER_SAMPLED_HPP
\ No newline at end of file
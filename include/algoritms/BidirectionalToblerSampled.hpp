@@ -0,0 +1,47 @@
+// File: BidirectionalToblerSampled.hpp
+#ifndef BIDIRECTIONAL_TOBLER_SAMPLED_HPP
+#define BIDIRECTIONAL_TOBLER_SAMPLED_HPP
+
+#include "map/PathfindingUtils.hpp"         // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include "algoritms/SearchWorkspace.hpp"    // For SearchWorkspace
+#include <vector>
+
+namespace Pathfinding {
+
+    /**
+     * @brief Bidirectional Dijkstra / A* on the Tobler costs.
+     *
+     * Searches forward from start and backward from end over the reversed (asymmetric) Tobler edges,
+     * always advancing the side with the smaller open list, and stops once
+     * top_forward + top_backward >= best meeting cost, which makes the result optimal: the returned
+     * path has the same cost as findDijkstraPath_Tobler_Sampled.
+     *
+     * With use_heuristic, both sides use the average potentials p_f = (h_end - h_start) / 2, p_b = -p_f,
+     * where h_x(v) = min_terrain_cost * euclidean_cells(v, x). This is consistent for the Tobler costs
+     * (every step costs at least its length times the cheapest terrain, as the slope penalty is >= 1),
+     * so the stopping rule stays exact. The user-selected heuristic type is deliberately not used,
+     * since HEURISTIC_MIN_COST is not guaranteed to be consistent.
+     *
+     * Reads context.edge_costs when present and honours context.queue_type.
+     */
+    std::vector<int> findBidirectionalPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& forward_workspace,
+        SearchWorkspace& backward_workspace,
+        const GridPoint& start,
+        const GridPoint& end,
+        bool use_heuristic
+    );
+
+    /** @brief As above, using the calling thread's workspaces. */
+    std::vector<int> findBidirectionalPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end,
+        bool use_heuristic
+    );
+
+} // namespace Pathfinding
+
+#endif // BIDIRECTIONAL_TOBLER_SAMPLED_HPP
@@ -0,0 +1,41 @@
+// File: CHToblerSampled.hpp
+#ifndef CH_TOBLER_SAMPLED_HPP
+#define CH_TOBLER_SAMPLED_HPP
+
+#include "map/PathfindingUtils.hpp"         // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include "algoritms/SearchWorkspace.hpp"    // For SearchWorkspace
+#include <vector>
+
+namespace Pathfinding {
+
+    /**
+     * @brief Shortest-path query on context.contraction (see ContractionHierarchy).
+     *
+     * Bidirectional Dijkstra that only relaxes arcs leading upward in the contraction order: forward
+     * from start over upward arcs, backward from end over reversed downward arcs. Each side stops once
+     * its smallest key reaches the best meeting cost, and cells reached suboptimally from above are
+     * stalled (not expanded). The CH path is then unpacked shortcut by shortcut into grid cells.
+     *
+     * Exact for the costs the hierarchy was built with or last customized to. The result is a cell-index path like the other
+     * planners return (start ... end), or empty if none is found or no valid hierarchy is attached.
+     * Honours context.queue_type.
+     */
+    std::vector<int> findCHPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& forward_workspace,
+        SearchWorkspace& backward_workspace,
+        const GridPoint& start,
+        const GridPoint& end
+    );
+
+    /** @brief As above, using the calling thread's workspaces. */
+    std::vector<int> findCHPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end
+    );
+
+} // namespace Pathfinding
+
+#endif // CH_TOBLER_SAMPLED_HPP
@@ -0,0 +1,138 @@
+// File: ContractionHierarchy.hpp
+#ifndef CONTRACTION_HIERARCHY_HPP
+#define CONTRACTION_HIERARCHY_HPP
+
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include <vector>
+#include <cstddef>
+
+namespace Pathfinding {
+
+    /**
+     * @class ContractionHierarchy
+     * @brief Contraction hierarchy (CH) over the directed grid graph with Tobler edge costs.
+     *
+     * Preprocessing contracts the passable cells one by one in order of importance. When a cell is
+     * removed, every in/out neighbour pair whose only shortest connection ran through it gets a
+     * shortcut. Witness searches decide this and are bounded by a settled-node limit, so some
+     * redundant shortcuts may be added; that costs space, never correctness. Queries then only
+     * relax arcs that lead upward in the order (see findCHPath_Tobler_Sampled) and touch a tiny
+     * fraction of the grid. The results are exact: a query returns a path of the same cost as Dijkstra.
+     *
+     * Contraction runs in rounds. Each round takes the cells whose priority (simulated edge
+     * difference plus deleted neighbours and level) is below that of all their neighbours; these form
+     * an independent set. Their witness searches, the expensive part, run in parallel against the
+     * graph as it was before the round and avoid every cell of the round, so contracting the set at
+     * once is as correct as contracting it one by one. Priorities are updated lazily.
+     *
+     * A default CH is bound to the costs it was built from: changing obstacle costs or elevation
+     * requires a rebuild. With Settings::customizable the witness searches are skipped and every
+     * in/out pair of a contracted cell gets an arc, so the topology depends only on which cells are
+     * passable (the order is chosen from arc counts alone). Such a hierarchy is larger and queries
+     * relax more arcs, but new costs only need customize(), a bottom-up pass over the arcs, and the
+     * topology can be stored in the grid cache and reused across runs (see gridcache::loadContractionCache).
+     *
+     * Memory is reported by memoryBytes() (final) and peakBuildBytes() (preprocessing).
+     */
+    class ContractionHierarchy {
+    public:
+        struct Settings {
+            int witness_settle_limit = 400;  // Settled cells per witness search while contracting
+            int priority_settle_limit = 10;  // ... while estimating priorities (cheaper, more pessimistic)
+            bool customizable = false;       // Metric-independent topology (no witness searches), see customize()
+        };
+
+        /**
+         * @brief Largest grid (in cells, 2048 x 2048) build() accepts. A customizable hierarchy has
+         * O(n log n) arcs (about 70 per cell at 256 x 256) and customizes in about O(n^1.5), so beyond
+         * this it takes gigabytes and minutes; a witness-pruned one is smaller but slower to build.
+         */
+        static constexpr std::size_t MAX_CELLS = std::size_t(4) * 1024 * 1024;
+
+        /**
+         * @brief Upward arc. For upArcs(v) `node` is the head (v -> node), for downArcs(v) it is the
+         * tail (node -> v); in both cases node ranks above v. middle is the cell the shortcut
+         * bypasses, or -1 for an original grid step.
+         */
+        struct Arc {
+            int node;
+            float weight;
+            int middle;
+        };
+
+        ContractionHierarchy() = default;
+
+        /**
+         * @brief Contracts the context's grid (uses its edge-cost cache if present).
+         * @return An invalid (empty) hierarchy if the context is unusable, the grid has more than
+         *         MAX_CELLS cells or memory is exhausted.
+         */
+        static ContractionHierarchy build(const PathfindingContext& context, const Settings& settings);
+        static ContractionHierarchy build(const PathfindingContext& context) { return build(context, Settings{}); }
+
+        /**
+         * @brief Restores a customizable hierarchy produced by build() (e.g. from the grid cache).
+         * Weights are whatever was stored; call customize() before querying.
+         * @return An invalid object if the arrays are inconsistent.
+         */
+        static ContractionHierarchy fromArrays(int width, int height, int rounds, std::size_t shortcut_count,
+            std::vector<int> rank, std::vector<std::size_t> up_offsets, std::vector<Arc> up_arcs,
+            std::vector<std::size_t> down_offsets, std::vector<Arc> down_arcs);
+
+        /**
+         * @brief Recomputes every arc weight of a customizable hierarchy for the context's costs,
+         * keeping the order and arcs: grid steps are re-read (parallel over cells), then each cell,
+         * lowest rank first, lowers the arcs between its upper neighbours through itself.
+         * @return false (hierarchy unchanged) if it is not customizable, memory is exhausted or the context's grid has a
+         *         different size or set of passable cells; rebuild in that case.
+         */
+        bool customize(const PathfindingContext& context);
+
+        bool isValid() const { return width_ > 0 && height_ > 0 && !rank_.empty(); }
+        int width() const { return width_; }
+        int height() const { return height_; }
+        std::size_t arcCount() const { return up_arcs_.size() + down_arcs_.size(); }
+        std::size_t shortcutCount() const { return shortcut_count_; }
+        int contractionRounds() const { return rounds_; }
+        std::size_t memoryBytes() const;
+        std::size_t peakBuildBytes() const { return peak_build_bytes_; }
+        bool isCustomizable() const { return customizable_; }
+
+        int rank(int node) const { return rank_[static_cast<std::size_t>(node)]; }
+        const Arc* upBegin(int node) const { return up_arcs_.data() + up_offsets_[static_cast<std::size_t>(node)]; }
+        const Arc* upEnd(int node) const { return up_arcs_.data() + up_offsets_[static_cast<std::size_t>(node) + 1]; }
+        const Arc* downBegin(int node) const { return down_arcs_.data() + down_offsets_[static_cast<std::size_t>(node)]; }
+        const Arc* downEnd(int node) const { return down_arcs_.data() + down_offsets_[static_cast<std::size_t>(node) + 1]; }
+
+        const std::vector<int>& ranks() const { return rank_; }
+        const std::vector<std::size_t>& upOffsets() const { return up_offsets_; }
+        const std::vector<Arc>& upArcs() const { return up_arcs_; }
+        const std::vector<std::size_t>& downOffsets() const { return down_offsets_; }
+        const std::vector<Arc>& downArcs() const { return down_arcs_; }
+
+        /**
+         * @brief Appends the grid cells of the CH arc from -> to (excluding from) to path,
+         * recursively expanding shortcuts.
+         * @return false if no such arc exists.
+         */
+        bool unpackArc(int from, int to, std::vector<int>& path) const;
+
+    private:
+        const Arc* findArc(int from, int to) const;
+
+        int width_ = 0;
+        int height_ = 0;
+        int rounds_ = 0;
+        std::size_t shortcut_count_ = 0;
+        std::size_t peak_build_bytes_ = 0;
+        bool customizable_ = false;
+        std::vector<int> rank_;                // Contraction order; -1 for impassable cells
+        std::vector<std::size_t> up_offsets_;  // CSR, per cell
+        std::vector<Arc> up_arcs_;
+        std::vector<std::size_t> down_offsets_;
+        std::vector<Arc> down_arcs_;
+    };
+
+} // namespace Pathfinding
+
+#endif // CONTRACTION_HIERARCHY_HPP
@@ -0,0 +1,59 @@
+// File: DeltaSteppingCPU.hpp
+#ifndef DELTA_STEPPING_CPU_HPP
+#define DELTA_STEPPING_CPU_HPP
+
+#include "map/PathfindingUtils.hpp"         // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include <vector>
+
+namespace Pathfinding {
+
+    /**
+     * @brief Multi-threaded CPU delta-stepping on the Tobler costs (CPU port of DeltaSteppingKernels.cu).
+     *
+     * Cells are kept in buckets of width delta_param. The current bucket is emptied by repeated
+     * light-edge phases (edges costing <= light_edge_threshold_param), then the heavy edges of every
+     * cell it settled are relaxed once. Each phase is spread over the OpenMP threads: distance and
+     * parent are packed into one 64-bit word updated by atomic min, and each thread collects its
+     * bucket insertions in its own buffers, merged after the phase. The search stops once the bucket
+     * holding the end cell is finished, so the result is optimal (same cost as Dijkstra).
+     *
+     * The search is internally parallel, so legs should be solved one after another. Reads
+     * context.edge_costs when present. Needs 16 bytes per grid cell, allocated per call.
+     *
+     * @param delta_param Bucket width in cost units (BackendInputParams::gpuDelta). Raised if needed so
+     *                    that at most delta_stepping::MAX_LIVE_BUCKETS buckets are live (see DeltaSteppingEngine.hpp).
+     * @param light_edge_threshold_param Light/heavy edge split (BackendInputParams::gpuThreshold).
+     * @return Path as grid indices from start to end, or empty if none exists or memory is exhausted.
+     */
+    std::vector<int> findDeltaSteppingPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end,
+        float delta_param,
+        float light_edge_threshold_param
+    );
+
+    /**
+     * @brief Heuristic-accelerated delta-stepping (CPU port of HADSKernels.cu).
+     *
+     * Delta-stepping as above, except that a step u -> v is skipped when h(v) > h(u) * prune_factor,
+     * with h = heuristic_weight * Euclidean distance to the end in cells. h is tabulated once for the
+     * cells within heuristic_radius_cells of the end and computed on the fly elsewhere. The pruning
+     * keeps the search in a cone towards the end, so like the GPU version the result is not
+     * guaranteed optimal, and a leg that needs a large detour away from the end may not be found.
+     */
+    std::vector<int> findHADSPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end,
+        float delta_param,
+        float light_edge_threshold_param,
+        int heuristic_radius_cells,
+        float prune_factor,
+        float heuristic_weight
+    );
+
+} // namespace Pathfinding
+
+#endif // DELTA_STEPPING_CPU_HPP
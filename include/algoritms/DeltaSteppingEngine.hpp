@@ -0,0 +1,302 @@
+// File: DeltaSteppingEngine.hpp
+#ifndef DELTA_STEPPING_ENGINE_HPP
+#define DELTA_STEPPING_ENGINE_HPP
+
+#include "map/MapProcessingCommon.h"        // For Grid_V3
+#include "map/PathfindingUtils.hpp"         // For costs, dx/dy, reverse_dir, MAX_TOBLER_PENALTY
+#include "map/ElevationRaster.hpp"
+#include "algoritms/PathfindingContext.hpp"
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"       // For stepCost, reverseStepCost, isPassable
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <omp.h>
+
+namespace Pathfinding {
+
+    /**
+     * Parallel delta-stepping over the 8-connected Tobler grid, shared by the CPU delta-stepping/HADS
+     * planners (forward, from the start) and TravelTimeField (backward, from the target).
+     *
+     * Cells are kept in buckets of width delta. The current bucket is emptied by repeated light-edge
+     * phases, then (if a light threshold is set) the heavy edges of every cell it settled are relaxed
+     * once. Each phase is spread over the OpenMP threads: labels are updated by atomic min, and each
+     * thread collects its bucket insertions in its own buffers, merged serially after the phase.
+     *
+     * Pending distances never lie more than one edge beyond the current bucket, so the buckets form a
+     * ring of maxEdgeCostBound() / delta + 3 slots. delta is raised to at least
+     * maxEdgeCostBound() / MAX_LIVE_BUCKETS, which caps the ring whatever bucket width is requested.
+     */
+    namespace delta_stepping {
+
+        inline constexpr std::size_t MAX_LIVE_BUCKETS = std::size_t(1) << 16;
+
+        enum class EdgeDirection {
+            Outgoing, // Distances from the source (edges relaxed as they are walked)
+            Incoming  // Distances to the source (reversed edges; Tobler costs are asymmetric)
+        };
+
+        // Non-negative floats order like their bit patterns, so distances live in atomic integer words
+        inline std::uint32_t floatBits(float f) { std::uint32_t b; std::memcpy(&b, &f, sizeof(b)); return b; }
+        inline float bitsFloat(std::uint32_t b) { float f; std::memcpy(&f, &b, sizeof(f)); return f; }
+
+        /**
+         * @brief Upper bound on every finite edge cost of the grid: the longest step on the costliest
+         * terrain at the capped slope penalty (with a margin for the float16 edge-cost cache).
+         */
+        inline float maxEdgeCostBound(const mapgeo::Grid_V3& grid) {
+            const auto& cells = grid.data();
+            float max_terrain = 0.0f;
+#pragma omp parallel for reduction(max:max_terrain) schedule(static)
+            for (long long i = 0; i < static_cast<long long>(cells.size()); ++i) {
+                const mapgeo::GridCellData& cell = cells[static_cast<std::size_t>(i)];
+                if (cell.value > 0.0f && !cell.hasFlag(mapgeo::GridFlags::FLAG_IMPASSABLE)) {
+                    max_terrain = std::max(max_terrain, cell.value);
+                }
+            }
+            return PathfindingUtils::costs[4] * max_terrain * PathfindingUtils::MAX_TOBLER_PENALTY * 1.001f;
+        }
+
+        // Label word: the distance bits, with WITH_PARENTS the parent index packed below them so that
+        // one 64-bit atomic min updates both consistently
+        template <bool WITH_PARENTS>
+        struct LabelWord;
+
+        template <>
+        struct LabelWord<true> {
+            using Word = std::uint64_t;
+            static Word pack(std::uint32_t dist_bits, int parent) {
+                return (static_cast<Word>(dist_bits) << 32) | static_cast<std::uint32_t>(parent);
+            }
+            static std::uint32_t distBits(Word word) { return static_cast<std::uint32_t>(word >> 32); }
+            static int parent(Word word) { return static_cast<int>(static_cast<std::uint32_t>(word & 0xFFFFFFFFu)); }
+        };
+
+        template <>
+        struct LabelWord<false> {
+            using Word = std::uint32_t;
+            static Word pack(std::uint32_t dist_bits, int) { return dist_bits; }
+            static std::uint32_t distBits(Word word) { return word; }
+        };
+
+        /** @brief Per-cell search state of one run (label, and the distance each cell was last relaxed with). */
+        template <bool WITH_PARENTS>
+        class Labels {
+        public:
+            using Traits = LabelWord<WITH_PARENTS>;
+            using Word = typename Traits::Word;
+
+            static constexpr std::uint32_t UNREACHED = 0x7F7FFFFFu; // Bits of std::numeric_limits<float>::max()
+
+            /** @brief Distance bits of a cell, UNREACHED if it was not reached. */
+            std::uint32_t distBits(int idx) const { return Traits::distBits(label_[static_cast<std::size_t>(idx)].load(std::memory_order_relaxed)); }
+            float distance(int idx) const { return bitsFloat(distBits(idx)); }
+            /** @brief Predecessor on the path from the source (Outgoing) or successor towards it (Incoming); -1 at the source. */
+            template <bool P = WITH_PARENTS, typename = std::enable_if_t<P>>
+            int parent(int idx) const { return Traits::parent(label_[static_cast<std::size_t>(idx)].load(std::memory_order_relaxed)); }
+            /** @brief Bucket width actually used (the requested one, raised to the ring limit if needed). */
+            float delta() const { return delta_; }
+
+        private:
+            template <EdgeDirection, bool W, typename Pruning>
+            friend bool run(const PathfindingContext&, int, float, float, int, const Pruning&, Labels<W>&);
+
+            // false if out of memory
+            bool allocate(std::size_t cell_count, bool heavy_phases) {
+                try {
+                    label_.reset(new std::atomic<Word>[cell_count]);
+                    light_at_.reset(new std::atomic<std::uint32_t>[cell_count]);
+                    heavy_at_.reset(heavy_phases ? new std::atomic<std::uint32_t>[cell_count] : nullptr);
+                }
+                catch (const std::bad_alloc&) {
+                    return false;
+                }
+                return true;
+            }
+
+            std::unique_ptr<std::atomic<Word>[]> label_;
+            std::unique_ptr<std::atomic<std::uint32_t>[]> light_at_;
+            std::unique_ptr<std::atomic<std::uint32_t>[]> heavy_at_;
+            float delta_ = 0.0f;
+        };
+
+        /** @brief Pruning policy that keeps every edge. */
+        struct NoPruning {
+            bool prunes(int, int, int, int) const { return false; }
+        };
+
+        /**
+         * @brief Runs delta-stepping from source over the context's grid (edge-cost cache if present).
+         *
+         * @param light_threshold Edges costing more are heavy; max() makes every edge light (no heavy phases).
+         * @param stop_at Cell whose bucket ends the run once finished (its label is then final); -1 settles everything reachable.
+         * @param pruning prunes(x, y, nx, ny) skips the step from the settled cell (x, y) to (nx, ny).
+         * @return false if the context is unusable or memory is exhausted.
+         */
+        template <EdgeDirection DIRECTION, bool WITH_PARENTS, typename Pruning>
+        bool run(const PathfindingContext& context, int source, float delta, float light_threshold, int stop_at,
+            const Pruning& pruning, Labels<WITH_PARENTS>& labels)
+        {
+            using namespace PathfindingUtils;
+            using Traits = LabelWord<WITH_PARENTS>;
+            using Word = typename Traits::Word;
+            constexpr std::uint32_t UNREACHED = Labels<WITH_PARENTS>::UNREACHED;
+
+            const EdgeCostCache* edge_costs = context.hasEdgeCosts() ? context.edge_costs : nullptr;
+            if (!context.isValid() || (edge_costs == nullptr && !context.hasElevation())) { return false; }
+            const mapgeo::Grid_V3& grid = *context.grid;
+            const int width = static_cast<int>(grid.width());
+            const int height = static_cast<int>(grid.height());
+            const int cell_count = width * height;
+
+            const float max_edge = maxEdgeCostBound(grid);
+            delta = std::max(delta, max_edge / static_cast<float>(MAX_LIVE_BUCKETS));
+            const std::size_t ring_size = static_cast<std::size_t>(max_edge / delta) + 3;
+            const float inv_delta = 1.0f / delta;
+            auto bucketOf = [inv_delta](std::uint32_t dist_bits) { return static_cast<std::size_t>(bitsFloat(dist_bits) * inv_delta); };
+
+            const bool heavy_phases = light_threshold < std::numeric_limits<float>::max();
+            if (!labels.allocate(static_cast<std::size_t>(cell_count), heavy_phases)) { return false; }
+            labels.delta_ = delta;
+            std::atomic<Word>* label = labels.label_.get();
+            std::atomic<std::uint32_t>* light_at = labels.light_at_.get();
+            std::atomic<std::uint32_t>* heavy_at = labels.heavy_at_.get();
+            const Word UNREACHED_LABEL = Traits::pack(UNREACHED, -1);
+#pragma omp parallel for schedule(static)
+            for (int i = 0; i < cell_count; ++i) {
+                label[i].store(UNREACHED_LABEL, std::memory_order_relaxed);
+                light_at[i].store(UNREACHED, std::memory_order_relaxed);
+                if (heavy_phases) { heavy_at[i].store(UNREACHED, std::memory_order_relaxed); }
+            }
+            label[source].store(Traits::pack(floatBits(0.0f), -1), std::memory_order_relaxed);
+
+            std::vector<std::vector<int>> buckets(ring_size); // Bucket b lives in slot b % ring_size
+            buckets[0].push_back(source);
+            std::size_t queued = 1;
+
+            // --- Per-thread bucket buffers, merged serially after each phase ---
+            const int thread_count = omp_get_max_threads();
+            std::vector<std::vector<int>> same_bucket(static_cast<std::size_t>(thread_count));
+            std::vector<std::vector<std::pair<std::size_t, int>>> later(static_cast<std::size_t>(thread_count));
+            std::vector<std::vector<int>> settled_by(static_cast<std::size_t>(thread_count));
+            std::vector<int> frontier;
+            std::vector<int> settled;
+
+            // Lowers the label of u to value; true if this call improved it
+            auto atomicMin = [](std::atomic<Word>& target, Word value) {
+                Word current = target.load(std::memory_order_relaxed);
+                while (value < current) {
+                    if (target.compare_exchange_weak(current, value, std::memory_order_relaxed)) { return true; }
+                }
+                return false;
+            };
+
+            // Relaxes the light (heavy = false) or heavy edges of v at distance bits v_bits
+            auto relax = [&](int v, std::uint32_t v_bits, bool heavy, std::size_t current, std::size_t tid) {
+                const float v_dist = bitsFloat(v_bits);
+                int x, y;
+                toCoords(v, width, x, y);
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    const int nx = x + dx[dir];
+                    const int ny = y + dy[dir];
+                    if (nx < 0 || nx >= width || ny < 0 || ny >= height) { continue; }
+                    if (pruning.prunes(x, y, nx, ny)) { continue; }
+                    const int u = toIndex(nx, ny, width);
+                    const float weight = (DIRECTION == EdgeDirection::Outgoing)
+                        ? stepCost(context, edge_costs, x, y, dir)
+                        : reverseStepCost(context, edge_costs, x, y, dir);
+                    if (weight >= std::numeric_limits<float>::max()) { continue; }
+                    if (heavy_phases && (weight > light_threshold) != heavy) { continue; }
+                    const std::uint32_t tentative_bits = floatBits(v_dist + weight);
+                    if (atomicMin(label[u], Traits::pack(tentative_bits, v))) {
+                        const std::size_t b = bucketOf(tentative_bits);
+                        if (b == current) { same_bucket[tid].push_back(u); }
+                        else { later[tid].emplace_back(b, u); }
+                    }
+                }
+            };
+            auto mergeInsertions = [&](std::size_t current) {
+                std::vector<int>& bucket = buckets[current % ring_size];
+                for (int t = 0; t < thread_count; ++t) {
+                    std::vector<int>& own_same = same_bucket[static_cast<std::size_t>(t)];
+                    bucket.insert(bucket.end(), own_same.begin(), own_same.end());
+                    queued += own_same.size();
+                    own_same.clear();
+                    for (const auto& [b, u] : later[static_cast<std::size_t>(t)]) { buckets[b % ring_size].push_back(u); }
+                    queued += later[static_cast<std::size_t>(t)].size();
+                    later[static_cast<std::size_t>(t)].clear();
+                }
+            };
+
+            for (std::size_t current = 0; queued > 0; ++current) {
+                std::vector<int>& bucket = buckets[current % ring_size];
+                if (bucket.empty()) { continue; }
+                // Heavy edges can land back in this bucket when the threshold is below delta, hence the outer loop
+                while (!bucket.empty()) {
+                    // --- Light phases: repeat until the bucket stops changing ---
+                    while (!bucket.empty()) {
+                        queued -= bucket.size();
+                        frontier.clear();
+                        frontier.swap(bucket);
+                        const int frontier_size = static_cast<int>(frontier.size());
+#pragma omp parallel
+                        {
+                            const std::size_t tid = static_cast<std::size_t>(omp_get_thread_num());
+#pragma omp for schedule(dynamic, 64)
+                            for (int i = 0; i < frontier_size; ++i) {
+                                const int v = frontier[static_cast<std::size_t>(i)];
+                                const std::uint32_t v_bits = Traits::distBits(label[v].load(std::memory_order_relaxed));
+                                if (bucketOf(v_bits) != current) { continue; } // Stale: improved into an earlier bucket
+                                // Each distinct distance of a cell is relaxed once, however often it was queued
+                                if (light_at[v].exchange(v_bits, std::memory_order_relaxed) == v_bits) { continue; }
+                                if (heavy_phases) { settled_by[tid].push_back(v); }
+                                relax(v, v_bits, false, current, tid);
+                            }
+                        }
+                        mergeInsertions(current);
+                        for (std::vector<int>& own_settled : settled_by) {
+                            settled.insert(settled.end(), own_settled.begin(), own_settled.end());
+                            own_settled.clear();
+                        }
+                    }
+                    if (!heavy_phases) { break; }
+
+                    // --- Heavy phase: once per cell settled in this bucket, at its final distance ---
+                    const int settled_size = static_cast<int>(settled.size());
+#pragma omp parallel
+                    {
+                        const std::size_t tid = static_cast<std::size_t>(omp_get_thread_num());
+#pragma omp for schedule(dynamic, 64)
+                        for (int i = 0; i < settled_size; ++i) {
+                            const int v = settled[static_cast<std::size_t>(i)];
+                            const std::uint32_t v_bits = Traits::distBits(label[v].load(std::memory_order_relaxed));
+                            if (heavy_at[v].exchange(v_bits, std::memory_order_relaxed) == v_bits) { continue; }
+                            relax(v, v_bits, true, current, tid);
+                        }
+                    }
+                    settled.clear();
+                    mergeInsertions(current);
+                }
+
+                // Every cell of this bucket is final now; stop once it held stop_at
+                if (stop_at >= 0) {
+                    const std::uint32_t stop_bits = Traits::distBits(label[stop_at].load(std::memory_order_relaxed));
+                    if (stop_bits != UNREACHED && bucketOf(stop_bits) <= current) { break; }
+                }
+            }
+            return true;
+        }
+
+    } // namespace delta_stepping
+
+} // namespace Pathfinding
+
+#endif // DELTA_STEPPING_ENGINE_HPP
@@ -4,6 +4,8 @@
 
 #include "map/MapProcessingCommon.h" // For Grid_V3
 #include "map/PathfindingUtils.hpp"  // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include "algoritms/SearchWorkspace.hpp"    // For SearchWorkspace
 #include <vector>
 
 namespace Pathfinding {
@@ -22,6 +24,42 @@ namespace Pathfinding {
         const GridPoint& end
     );
 
+    /**
+     * @brief Dijkstra over a prepared PathfindingContext (no per-call elevation resampling, thread-local workspace).
+     */
+    std::vector<int> findDijkstraPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end
+    );
+
+    /**
+     * @brief Dijkstra using a caller-owned SearchWorkspace, so back-to-back legs on one thread
+     *        only pay for the cells they touch. The overload above uses the thread-local workspace.
+     *        Specialized on the context's open list, cost model and connectivity (see SearchKernels.hpp).
+     */
+    std::vector<int> findDijkstraPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end
+    );
+
+    /**
+     * @brief One Dijkstra search from source that stops as soon as every target is settled.
+     *
+     * Same kernel, costs and neighbourhood as findDijkstraPath_Tobler_Sampled, but one search serves all targets.
+     * @param paths If not null, receives one cell-index path per target (empty if unreachable).
+     * @return Cost per target, +inf (max()) if unreachable, impassable or out of bounds.
+     */
+    std::vector<float> findDijkstraOneToMany_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& source,
+        const std::vector<GridPoint>& targets,
+        std::vector<std::vector<int>>* paths = nullptr
+    );
+
 } // namespace Pathfinding
 
 #endif // DIJKSTRA_TOBLER_SAMPLED_HPP
\ No newline at end of file
@@ -0,0 +1,107 @@
+// File: EdgeCostCache.hpp
+#ifndef EDGE_COST_CACHE_HPP
+#define EDGE_COST_CACHE_HPP
+
+#include "map/MapProcessingCommon.h" // For Grid_V3
+#include "map/ElevationRaster.hpp"   // For ElevationRaster
+#include "map/PathfindingUtils.hpp"  // For NUM_DIRECTIONS
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace Pathfinding {
+
+    /**
+     * @class EdgeCostCache
+     * @brief Precomputed Tobler costs (toblerNeighborCosts, see ToblerKernel.hpp) for all 8 outgoing edges of every cell.
+     *
+     * Built once per grid/elevation pair (in parallel over rows) and shared read-only by the
+     * CPU planners through PathfindingContext::edge_costs, so no relaxation evaluates the slope penalty.
+     * Storage is cell-major: the 8 costs of a cell are contiguous (one 32-byte block in Float32),
+     * in the dx/dy direction order. Out-of-bounds neighbours, impassable neighbours and impassable
+     * slopes are stored as std::numeric_limits<float>::max(), exactly as the kernel reports them.
+     *
+     * Precision:
+     *  - Float32: bit-identical to the planners' on-the-fly toblerStepCost() (32 bytes/cell).
+     *  - Float16: IEEE half precision (16 bytes/cell). Costs are stored pre-divided by a power-of-two
+     *    scale() chosen so the largest possible finite cost lands just below the half-precision maximum
+     *    (65504), and rounded to nearest. Costs of at least FLOAT16_MIN_NORMAL * scale() are normal
+     *    halves with relative error at most FLOAT16_MAX_RELATIVE_ERROR (2^-11 ~= 0.049%). Smaller costs
+     *    (only when terrain values span more than ~2^30 / MAX_TOBLER_PENALTY) are stored as
+     *    FLOAT16_MIN_NORMAL * scale(), i.e. rounded up rather than into the subnormal range, where the
+     *    relative error would be unbounded. Every stored cost is therefore at least
+     *    cost * (1 - FLOAT16_MAX_RELATIVE_ERROR), which is what the shrunk A* heuristics rely on.
+     */
+    class EdgeCostCache {
+    public:
+        enum class Precision { Float32, Float16 };
+
+        static constexpr float FLOAT16_MAX_RELATIVE_ERROR = 1.0f / 2048.0f;
+        static constexpr float FLOAT16_MIN_NORMAL = 1.0f / 16384.0f; // Smallest normal half, 2^-14
+
+        EdgeCostCache() = default;
+
+        /**
+         * @brief Builds the cache for a grid and its elevation raster.
+         * @return An invalid (empty) cache if the inputs do not match or memory is exhausted.
+         */
+        static EdgeCostCache build(const mapgeo::Grid_V3& grid, const mapgeo::ElevationRaster& elevation,
+            float log_cell_resolution, Precision precision = Precision::Float32);
+
+        bool isValid() const { return width_ > 0 && height_ > 0 && (!costs_f32_.empty() || !costs_f16_.empty()); }
+        std::size_t width() const { return width_; }
+        std::size_t height() const { return height_; }
+        Precision precision() const { return precision_; }
+        /** @brief Float16 only: stored value * scale() = cost (a power of two; 1 for Float32). */
+        float scale() const { return scale_; }
+        std::size_t memoryBytes() const { return costs_f32_.size() * sizeof(float) + costs_f16_.size() * sizeof(std::uint16_t); }
+
+        /** @brief Cost of leaving cell idx in direction dir (max() = impassable). No bounds check. */
+        float cost(int idx, int dir) const {
+            const std::size_t slot = static_cast<std::size_t>(idx) * PathfindingUtils::NUM_DIRECTIONS + static_cast<std::size_t>(dir);
+            if (precision_ == Precision::Float32) { return costs_f32_[slot]; }
+            const std::uint16_t h = costs_f16_[slot];
+            if (h == HALF_INFINITY) { return std::numeric_limits<float>::max(); }
+            return halfToFloat(h) * scale_;
+        }
+
+        /** @brief Pointer to the 8 Float32 costs of cell idx (Float32 caches only). */
+        const float* costsOf(int idx) const { return costs_f32_.data() + static_cast<std::size_t>(idx) * PathfindingUtils::NUM_DIRECTIONS; }
+
+        static constexpr std::uint16_t HALF_INFINITY = 0x7C00;
+        static std::uint16_t floatToHalf(float value);
+
+        static float halfToFloat(std::uint16_t h) {
+            const std::uint32_t sign = static_cast<std::uint32_t>(h & 0x8000u) << 16;
+            const std::uint32_t exponent = (h >> 10) & 0x1Fu;
+            const std::uint32_t mantissa = h & 0x3FFu;
+            std::uint32_t bits;
+            if (exponent == 0) {
+                if (mantissa == 0) { bits = sign; }
+                else { // Subnormal half -> normal float
+                    float v = static_cast<float>(mantissa) * (1.0f / 16777216.0f); // mantissa * 2^-24
+                    std::memcpy(&bits, &v, sizeof(bits));
+                    bits |= sign;
+                }
+            }
+            else if (exponent == 0x1F) { bits = sign | 0x7F800000u | (mantissa << 13); }
+            else { bits = sign | ((exponent + 112u) << 23) | (mantissa << 13); }
+            float out;
+            std::memcpy(&out, &bits, sizeof(out));
+            return out;
+        }
+
+    private:
+        std::size_t width_ = 0;
+        std::size_t height_ = 0;
+        Precision precision_ = Precision::Float32;
+        float scale_ = 1.0f; // Float16 only: stored value * scale_ = cost
+        std::vector<float> costs_f32_;
+        std::vector<std::uint16_t> costs_f16_;
+    };
+
+} // namespace Pathfinding
+
+#endif // EDGE_COST_CACHE_HPP
@@ -0,0 +1,42 @@
+// File: HPAStarToblerSampled.hpp
+#ifndef HPA_STAR_TOBLER_SAMPLED_HPP
+#define HPA_STAR_TOBLER_SAMPLED_HPP
+
+#include "map/PathfindingUtils.hpp"         // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include "algoritms/SearchWorkspace.hpp"    // For SearchWorkspace
+#include <vector>
+
+namespace Pathfinding {
+
+    /**
+     * @brief Hierarchical A* (HPA*) over context.hierarchy (see HierarchicalGraph).
+     *
+     * Start and end are attached to the entrances of their clusters by confined Dijkstra searches
+     * (the end side over reversed edges, so the asymmetric Tobler costs are respected), and the
+     * abstract graph is searched with A* using the consistent min_terrain_cost * euclidean heuristic.
+     * The abstract route is then refined back to grid cells by an A* confined to the clusters along
+     * it (plus HierarchicalGraph::corridorRadius() rings), which also straightens the detours through
+     * entrances. The result is a cell-index path like the other planners return (start ... end), or
+     * empty if none is found or no hierarchy is attached.
+     *
+     * Near-optimal: the path may cost slightly more than the Dijkstra path. Query time grows with
+     * the corridor area, not the grid size. Honours context.edge_costs and context.queue_type.
+     */
+    std::vector<int> findHPAStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end
+    );
+
+    /** @brief As above, using the calling thread's workspace. */
+    std::vector<int> findHPAStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end
+    );
+
+} // namespace Pathfinding
+
+#endif // HPA_STAR_TOBLER_SAMPLED_HPP
@@ -0,0 +1,125 @@
+// File: HierarchicalGraph.hpp
+#ifndef HIERARCHICAL_GRAPH_HPP
+#define HIERARCHICAL_GRAPH_HPP
+
+#include "map/MapProcessingCommon.h"        // For Grid_V3
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include <vector>
+#include <cstddef>
+#include <limits>
+
+namespace Pathfinding {
+
+    /**
+     * @class HierarchicalGraph
+     * @brief HPA* abstraction of a grid: square clusters, entrance nodes on the cluster borders and
+     * precomputed directed costs between the entrances of each cluster.
+     *
+     * Every maximal run of cells that is passable on both sides of a cluster border gets entrances
+     * spread evenly along it, at most Settings::entrance_spacing cells apart (a narrow run gets one,
+     * in its middle). An entrance is a pair of abstract nodes, one per side, joined by the single grid step
+     * across the border in both directions. Within a cluster, every entrance node is joined to every
+     * other one it can reach by the cost of the cheapest path that stays inside the cluster.
+     * All costs are the Tobler costs of the context and are directed, so uphill and downhill
+     * crossings of a cluster keep their different costs.
+     *
+     * Built once per grid/elevation pair (clusters in parallel) and shared read-only through
+     * PathfindingContext::hierarchy. Paths found through it are near-optimal, not exact: the abstract
+     * route only crosses borders at entrances, and the final grid path is confined to the clusters
+     * around that route.
+     */
+    class HierarchicalGraph {
+    public:
+        /** @brief Build/query trade-off. */
+        struct Settings {
+            // Cluster edge length in cells. Larger clusters give fewer abstract nodes (faster abstract
+            // search) but cost more to build (~cells * cluster_size) and to enter/refine per query.
+            int cluster_size = 16;
+            // Maximum distance between entrances along an open border. Smaller = shorter detours through
+            // entrances (better paths) but more abstract nodes (slower build and abstract search).
+            int entrance_spacing = 8;
+            // Refinement searches the clusters on the abstract path plus this many rings of neighbouring
+            // clusters. 0 = tightest corridor (fastest); 1 usually recovers most of the lost optimality.
+            int corridor_radius = 1;
+        };
+
+        struct Edge {
+            int target;  // Abstract node index
+            float cost;  // Tobler cost of the grid path the edge stands for
+        };
+
+        /**
+         * @brief Result of a Dijkstra search confined to one cluster (see searchCluster()).
+         * dist/parent are indexed by cluster-local cell; parent holds global cell indices (-1 = none).
+         * For a reverse search the parent of a cell is its successor towards the source.
+         */
+        struct ClusterSearch {
+            int x0 = 0, y0 = 0, width = 0, height = 0;
+            std::vector<float> dist;
+            std::vector<int> parent;
+            std::vector<char> closed;
+
+            bool contains(int x, int y) const { return x >= x0 && x < x0 + width && y >= y0 && y < y0 + height; }
+            int localIndex(int x, int y) const { return (y - y0) * width + (x - x0); }
+            float distTo(int x, int y) const { return contains(x, y) ? dist[static_cast<std::size_t>(localIndex(x, y))] : std::numeric_limits<float>::max(); }
+        };
+
+        HierarchicalGraph() = default;
+
+        /**
+         * @brief Builds the abstraction for the context's grid (uses its edge-cost cache if present).
+         * @return An invalid (empty) graph if the context is unusable.
+         */
+        static HierarchicalGraph build(const PathfindingContext& context, const Settings& settings);
+        static HierarchicalGraph build(const PathfindingContext& context) { return build(context, Settings{}); }
+
+        bool isValid() const { return cluster_size_ > 0 && !cluster_first_node_.empty(); }
+        int width() const { return width_; }
+        int height() const { return height_; }
+        int clusterSize() const { return cluster_size_; }
+        int clustersX() const { return clusters_x_; }
+        int clustersY() const { return clusters_y_; }
+        int corridorRadius() const { return corridor_radius_; }
+        std::size_t nodeCount() const { return node_cell_.size(); }
+        std::size_t edgeCount() const { return edges_.size(); }
+        std::size_t memoryBytes() const;
+
+        /** @brief Cluster containing grid cell (x, y). No bounds check. */
+        int clusterOf(int x, int y) const { return (y / cluster_size_) * clusters_x_ + (x / cluster_size_); }
+
+        int nodeCell(int node) const { return node_cell_[static_cast<std::size_t>(node)]; }
+        int nodeCluster(int node) const { return node_cluster_[static_cast<std::size_t>(node)]; }
+
+        /** @brief Abstract nodes of a cluster are the contiguous range [clusterNodesBegin, clusterNodesEnd). */
+        int clusterNodesBegin(int cluster) const { return cluster_first_node_[static_cast<std::size_t>(cluster)]; }
+        int clusterNodesEnd(int cluster) const { return cluster_first_node_[static_cast<std::size_t>(cluster) + 1]; }
+
+        /** @brief Outgoing edges of an abstract node. */
+        const Edge* edgesBegin(int node) const { return edges_.data() + edge_offsets_[static_cast<std::size_t>(node)]; }
+        const Edge* edgesEnd(int node) const { return edges_.data() + edge_offsets_[static_cast<std::size_t>(node) + 1]; }
+
+        /**
+         * @brief Dijkstra from source_cell over the cells of one cluster only.
+         * @param reverse Follow edges backwards, i.e. dist = cost from each cell to source_cell.
+         * @param target_cell Stop once this cell is settled (-1 = settle the whole cluster).
+         */
+        void searchCluster(const PathfindingContext& context, int cluster, int source_cell, bool reverse,
+            int target_cell, ClusterSearch& search) const;
+
+    private:
+        int width_ = 0;
+        int height_ = 0;
+        int cluster_size_ = 0;
+        int clusters_x_ = 0;
+        int clusters_y_ = 0;
+        int corridor_radius_ = 1;
+        std::vector<int> node_cell_;          // Grid cell of each abstract node (nodes sorted by cluster)
+        std::vector<int> node_cluster_;
+        std::vector<int> cluster_first_node_; // clusters_x_ * clusters_y_ + 1 offsets into the node list
+        std::vector<std::size_t> edge_offsets_; // CSR adjacency
+        std::vector<Edge> edges_;
+    };
+
+} // namespace Pathfinding
+
+#endif // HIERARCHICAL_GRAPH_HPP
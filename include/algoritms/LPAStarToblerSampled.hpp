@@ -0,0 +1,85 @@
+// File: LPAStarToblerSampled.hpp
+#ifndef LPASTAR_TOBLER_SAMPLED_HPP
+#define LPASTAR_TOBLER_SAMPLED_HPP
+
+#include "map/PathfindingUtils.hpp"         // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include <vector>
+#include <queue>
+#include <cstddef>
+
+namespace Pathfinding {
+
+    /**
+     * @class LPAStarPlanner
+     * @brief Lifelong Planning A* for one leg: keeps its search state so cost changes are repaired, not re-solved.
+     *
+     * Each cell holds g (the cost found so far) and rhs (one-step lookahead from its predecessors).
+     * computePath() expands only locally inconsistent cells (g != rhs) in [min(g, rhs) + h, min(g, rhs)]
+     * order. After some cells change cost, notifyCellChanged() re-evaluates their rhs, and the next
+     * computePath() only touches the part of the search that depends on them. The first call costs
+     * about as much as A*; the result always has the same cost as Dijkstra on the current grid.
+     *
+     * The planner reads the context's grid and elevation raster on every call (Tobler costs on the fly,
+     * the edge-cost cache is not used since it would go stale). The owner may change grid cell values
+     * and flags between calls, as long as every changed cell is passed to notifyCellChanged().
+     * h = min_terrain_cost * Euclidean cells; it is lowered automatically if a cell gets cheaper than that.
+     * Needs 8 bytes per grid cell for the lifetime of the planner.
+     */
+    class LPAStarPlanner {
+    public:
+        LPAStarPlanner() = default;
+
+        /** @brief Prepares a leg; nothing is searched until computePath(). Invalid if the context or points are. */
+        LPAStarPlanner(const PathfindingContext& context, const GridPoint& start, const GridPoint& end);
+
+        bool isValid() const { return context_ != nullptr && !g_.empty(); }
+
+        /** @brief Brings the search up to date with all notified changes and returns the path (empty if none). */
+        std::vector<int> computePath();
+
+        /** @brief Must be called after the value or flags of cell idx changed (edges into it change cost). */
+        void notifyCellChanged(int idx);
+
+        /** @brief Cost of the current path, or max() if the end is unreachable (valid after computePath()). */
+        float pathCost() const;
+
+        /** @brief Cells expanded by the last computePath() call. */
+        std::size_t lastExpansions() const { return last_expansions_; }
+        std::size_t memoryBytes() const { return (g_.size() + rhs_.size()) * sizeof(float); }
+
+    private:
+        struct Key {
+            float k1, k2;
+            bool operator<(const Key& o) const { return k1 < o.k1 || (k1 == o.k1 && k2 < o.k2); }
+            bool operator==(const Key& o) const { return k1 == o.k1 && k2 == o.k2; }
+        };
+        struct Entry {
+            Key key;
+            int idx;
+            bool operator>(const Entry& o) const { return o.key < key; }
+        };
+
+        Key calculateKey(int idx) const;
+        float heuristic(int idx) const;
+        float edgeCost(int from, int to, int dir) const; // max() = no edge
+        void updateVertex(int idx);
+        void rebuildQueue();
+        bool topKey(Key& key); // Skips stale entries; false if the queue is empty
+
+        const PathfindingContext* context_ = nullptr;
+        int width_ = 0;
+        int height_ = 0;
+        int start_idx_ = -1;
+        int end_idx_ = -1;
+        float h_scale_ = 0.0f;
+        bool needs_rekey_ = false;
+        std::vector<float> g_;
+        std::vector<float> rhs_;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open_; // Lazy: stale keys skipped on pop
+        std::size_t last_expansions_ = 0;
+    };
+
+} // namespace Pathfinding
+
+#endif // LPASTAR_TOBLER_SAMPLED_HPP
@@ -0,0 +1,110 @@
+// File: LandmarkHeuristic.hpp
+#ifndef LANDMARK_HEURISTIC_HPP
+#define LANDMARK_HEURISTIC_HPP
+
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+namespace Pathfinding {
+
+    /**
+     * @class LandmarkHeuristic
+     * @brief ALT (A*, landmarks, triangle inequality) lower bounds for the Tobler costs.
+     *
+     * K landmarks are spread evenly along the map border (or the outermost ring of cells that has
+     * passable cells). For each landmark L a full-grid Dijkstra gives d(L, v) and a reverse one gives
+     * d(v, L); the 2K searches run in parallel. Since the Tobler costs are asymmetric both are needed:
+     *     d(v, t) >= max_L max( d(L, t) - d(L, v), d(v, L) - d(t, L) ).
+     * Unlike the geometric heuristics this bound sees terrain, slopes and obstacles.
+     *
+     * Storage is compact and cell-major: 2K uint16 per cell (32 bytes for K = 8), so the bounds for a
+     * cell are one contiguous read. Each table stores floor(d / scale) with its own scale
+     * (max finite distance / 65534); UNREACHABLE marks cells the landmark cannot reach or be reached
+     * from. Quantisation is accounted for (one step is subtracted per term), so the bound stays
+     * admissible, but it is not strictly consistent; A* reopens closed cells when using it.
+     */
+    class LandmarkHeuristic {
+    public:
+        static constexpr int DEFAULT_LANDMARK_COUNT = 8;
+        static constexpr std::uint16_t UNREACHABLE = 0xFFFF;
+
+        /**
+         * @brief Per-target bound evaluator (cheap to create; one per query).
+         */
+        class Query {
+        public:
+            Query() = default;
+
+            /** @brief Admissible lower bound on the cost from cell idx to the target. */
+            float operator()(int idx) const {
+                const std::uint16_t* q = table_->distances_.data() + static_cast<std::size_t>(idx) * stride_;
+                float best = 0.0f;
+                for (int s = 0; s < stride_; s += 2) {
+                    // From-landmark term: d(L,t) - d(L,v)
+                    if (q[s] != UNREACHABLE && target_[s] != UNREACHABLE) {
+                        best = std::max(best, static_cast<float>(static_cast<int>(target_[s]) - static_cast<int>(q[s]) - 1) * scales_[s]);
+                    }
+                    // To-landmark term: d(v,L) - d(t,L)
+                    if (q[s + 1] != UNREACHABLE && target_[s + 1] != UNREACHABLE) {
+                        best = std::max(best, static_cast<float>(static_cast<int>(q[s + 1]) - static_cast<int>(target_[s + 1]) - 1) * scales_[s + 1]);
+                    }
+                }
+                return best * shrink_;
+            }
+
+        private:
+            friend class LandmarkHeuristic;
+            const LandmarkHeuristic* table_ = nullptr;
+            int stride_ = 0;
+            std::vector<std::uint16_t> target_; // Quantised distances of the target cell
+            std::vector<float> scales_;
+            float shrink_ = 1.0f;
+        };
+
+        LandmarkHeuristic() = default;
+
+        /**
+         * @brief Selects landmark_count landmarks and computes their tables (uses the context's
+         * edge-cost cache only if it is exact Float32).
+         * @return An invalid (empty) object if the context is unusable, no landmark cell is passable
+         *         or memory is exhausted.
+         */
+        static LandmarkHeuristic build(const PathfindingContext& context, int landmark_count = DEFAULT_LANDMARK_COUNT);
+
+        /**
+         * @brief Restores tables produced by build() (e.g. from the grid cache).
+         * @return An invalid object if the sizes do not match.
+         */
+        static LandmarkHeuristic fromTables(std::size_t width, std::size_t height, std::vector<int> landmark_cells,
+            std::vector<float> scales, std::vector<std::uint16_t> distances);
+
+        bool isValid() const { return width_ > 0 && height_ > 0 && !landmark_cells_.empty(); }
+        std::size_t width() const { return width_; }
+        std::size_t height() const { return height_; }
+        int landmarkCount() const { return static_cast<int>(landmark_cells_.size()); }
+        const std::vector<int>& landmarkCells() const { return landmark_cells_; }
+        const std::vector<float>& scales() const { return scales_; }
+        const std::vector<std::uint16_t>& distances() const { return distances_; }
+        std::size_t memoryBytes() const { return distances_.size() * sizeof(std::uint16_t) + scales_.size() * sizeof(float) + landmark_cells_.size() * sizeof(int); }
+
+        /**
+         * @brief Bound evaluator for one target cell.
+         * @param cost_shrink Factor applied to every bound; pass (1 - max relative error) when the
+         *        search runs on approximated edge costs (Float16 cache) so the bound stays admissible.
+         */
+        Query forTarget(int target_idx, float cost_shrink = 1.0f) const;
+
+    private:
+        std::size_t width_ = 0;
+        std::size_t height_ = 0;
+        std::vector<int> landmark_cells_;
+        std::vector<float> scales_;            // 2 per landmark: [from, to]
+        std::vector<std::uint16_t> distances_; // cell-major, 2 * landmarkCount() per cell
+    };
+
+} // namespace Pathfinding
+
+#endif // LANDMARK_HEURISTIC_HPP
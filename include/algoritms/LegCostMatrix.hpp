@@ -0,0 +1,47 @@
+// File: LegCostMatrix.hpp
+#ifndef LEG_COST_MATRIX_HPP
+#define LEG_COST_MATRIX_HPP
+
+#include "map/PathfindingUtils.hpp"         // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include "algoritms/DijkstraToblerSampled.hpp" // For findDijkstraOneToMany_Tobler_Sampled
+#include <vector>
+#include <cstddef>
+#include <limits>
+
+namespace Pathfinding {
+
+    /**
+     * @brief Optimal costs (and optionally paths) between every ordered pair of points, under the
+     *        context's cost model and connectivity, i.e. the same costs the Dijkstra legs see.
+     *
+     * costs is row-major: costs[from * size + to]. Unreachable pairs, and pairs involving an
+     * impassable or out-of-bounds point, hold +inf (std::numeric_limits<float>::max()) and an empty path.
+     */
+    struct LegCostMatrix {
+        std::size_t size = 0;
+        std::vector<float> costs;
+        std::vector<std::vector<int>> paths; // Same layout as costs; empty unless paths were requested
+
+        float cost(std::size_t from, std::size_t to) const { return costs[from * size + to]; }
+        bool reachable(std::size_t from, std::size_t to) const { return cost(from, to) < std::numeric_limits<float>::max(); }
+        bool hasPaths() const { return !paths.empty(); }
+        /** @brief Cell-index path from -> to (start ... end); requires hasPaths(). */
+        const std::vector<int>& path(std::size_t from, std::size_t to) const { return paths[from * size + to]; }
+    };
+
+    /**
+     * @brief Cost matrix between all points (e.g. start, controls and finish of a course).
+     *
+     * Runs one findDijkstraOneToMany_Tobler_Sampled per point (N searches instead of N^2 point-to-point
+     * ones), spread over the OpenMP threads with each thread using its own workspace.
+     */
+    LegCostMatrix computeLegCostMatrix(
+        const PathfindingContext& context,
+        const std::vector<GridPoint>& points,
+        bool with_paths = false
+    );
+
+} // namespace Pathfinding
+
+#endif // LEG_COST_MATRIX_HPP
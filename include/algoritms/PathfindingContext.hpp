@@ -0,0 +1,97 @@
+// File: PathfindingContext.hpp
+#ifndef PATHFINDING_CONTEXT_HPP
+#define PATHFINDING_CONTEXT_HPP
+
+#include "map/MapProcessingCommon.h" // For Grid_V3
+#include "map/ElevationRaster.hpp"   // For ElevationRaster
+#include "map/CompactGrid.hpp"       // For CompactGrid
+#include "map/TiledGrid.hpp"         // For TiledGrid
+#include "algoritms/SearchQueues.hpp" // For QueueType
+
+namespace Pathfinding {
+
+    class EdgeCostCache;     // algoritms/EdgeCostCache.hpp
+    class HierarchicalGraph; // algoritms/HierarchicalGraph.hpp
+    class LandmarkHeuristic; // algoritms/LandmarkHeuristic.hpp
+    class ContractionHierarchy; // algoritms/ContractionHierarchy.hpp
+    class TravelTimeField;   // algoritms/TravelTimeField.hpp
+
+    /** @brief Edge-cost model of the specialized A* and Dijkstra kernels (see SearchKernels.hpp). */
+    enum class CostModel {
+        Tobler,      // Distance x terrain x Tobler slope penalty (default; the only model the other planners use)
+        FlatTobler,  // Tobler on level ground: the same costs as Tobler over constant elevation, no raster needed
+        TerrainOnly  // Distance x terrain, slope ignored
+    };
+
+    /**
+     * @brief Read-only, per-grid state shared by every CPU pathfinding call.
+     *
+     * Everything that depends only on the grid/elevation pair (not on a particular leg) is
+     * computed once when the context is made, so a search call only pays for the search itself.
+     * The context does not own the grid or raster; both must outlive it.
+     */
+    struct PathfindingContext {
+        const mapgeo::Grid_V3* grid = nullptr;
+        const mapgeo::ElevationRaster* elevation = nullptr; // May be null for algorithms that ignore elevation (BFS)
+        const EdgeCostCache* edge_costs = nullptr;          // Optional precomputed Tobler costs (read by A* and Dijkstra)
+        const mapgeo::CompactGrid* compact_grid = nullptr;  // Optional 1-byte/cell copy of grid (read by A* and Dijkstra without edge_costs)
+        const mapgeo::TiledGrid* tiled_grid = nullptr;      // Optional tile-ordered compact grid + elevation (preferred over compact_grid)
+        const HierarchicalGraph* hierarchy = nullptr;       // HPA* abstraction (required by findHPAStarPath_Tobler_Sampled only)
+        const LandmarkHeuristic* landmarks = nullptr;       // ALT tables (read by A* with HEURISTIC_ALT)
+        const ContractionHierarchy* contraction = nullptr;  // CH (required by findCHPath_Tobler_Sampled only)
+        const TravelTimeField* travel_time = nullptr;       // Cost-to-target field (exact A* heuristic for legs ending at its target)
+        float log_cell_resolution = 1.0f;                   // Real-world size of one logical cell edge (metres)
+        float min_terrain_cost = 0.0f;                      // Smallest passable cell value; 0 if no cell is passable
+        QueueType queue_type = QueueType::BinaryHeap;       // Open list used by A* and Dijkstra
+        CostModel cost_model = CostModel::Tobler;           // Edge costs of A* and Dijkstra (others always use Tobler)
+        int connectivity = 8;                               // A* and Dijkstra: 8 (default) or 4 (axial moves only)
+
+        bool isValid() const { return grid != nullptr && grid->isValid() && log_cell_resolution > 1e-6f; }
+
+        /** @brief True if an elevation raster matching the grid dimensions is attached. */
+        bool hasElevation() const {
+            return elevation != nullptr && elevation->isValid() && grid != nullptr &&
+                elevation->width() == grid->width() && elevation->height() == grid->height();
+        }
+
+        /**
+         * @brief True if cost_model yields the Tobler costs of the attached elevation, so tables built
+         *        from Tobler costs (ALT landmarks, travel-time field) bound it: always for Tobler, and
+         *        for FlatTobler on a constant ("2D mode") raster.
+         */
+        bool costsMatchTobler() const {
+            return cost_model == CostModel::Tobler ||
+                (cost_model == CostModel::FlatTobler && hasElevation() && elevation->isConstant());
+        }
+
+        /** @brief True if a valid edge-cost cache matching the grid dimensions is attached. */
+        bool hasEdgeCosts() const;
+
+        /** @brief True if a compact grid with 1-byte codes matching the grid dimensions is attached. */
+        bool hasCompactGrid() const {
+            return compact_grid != nullptr && compact_grid->isValid() && compact_grid->isNarrow() && grid != nullptr &&
+                compact_grid->width() == grid->width() && compact_grid->height() == grid->height();
+        }
+
+        /** @brief True if a tiled grid matching the grid dimensions is attached. */
+        bool hasTiledGrid() const {
+            return tiled_grid != nullptr && tiled_grid->isValid() && grid != nullptr &&
+                tiled_grid->width() == grid->width() && tiled_grid->height() == grid->height();
+        }
+
+        /** @brief True if ALT landmark tables matching the grid dimensions are attached. */
+        bool hasLandmarks() const;
+
+        /** @brief True if a travel-time field matching the grid dimensions and ending at targetIdx is attached. */
+        bool hasTravelTimeTo(int targetIdx) const;
+    };
+
+    /**
+     * @brief Builds a context for a grid and its elevation raster (computes per-grid constants in parallel).
+     * @param elevation May be null if only elevation-free algorithms will be run.
+     */
+    PathfindingContext makePathfindingContext(const mapgeo::Grid_V3& grid, const mapgeo::ElevationRaster* elevation, float log_cell_resolution);
+
+} // namespace Pathfinding
+
+#endif // PATHFINDING_CONTEXT_HPP
@@ -0,0 +1,265 @@
+// File: SearchKernels.hpp
+#ifndef SEARCH_KERNELS_HPP
+#define SEARCH_KERNELS_HPP
+
+#include "map/MapProcessingCommon.h"        // For Grid_V3
+#include "map/PathfindingUtils.hpp"         // For costs, dx/dy, heuristic distances
+#include "map/ElevationRaster.hpp"
+#include "map/GridLayout.hpp"               // For RowMajorLayout, TiledLayout
+#include "map/TiledGrid.hpp"
+#include "algoritms/PathfindingContext.hpp" // For CostModel, QueueType
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"       // For toblerNeighborCosts, toblerStepCost
+#include "algoritms/SearchQueues.hpp"
+#include "algoritms/LandmarkHeuristic.hpp"
+#include "algoritms/TravelTimeField.hpp"
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+
+namespace Pathfinding {
+
+    /**
+     * Compile-time policies for the A* and Dijkstra search bodies.
+     *
+     * The search bodies are templates over the open list, the connectivity, the cost model and (A*)
+     * the heuristic. Each combination is its own instantiation, so the inner loop does no switch on
+     * heuristic_type, no cache/on-the-fly branch per neighbour, and no reopen or field check that
+     * the chosen heuristic cannot need. withSearchKernel() picks the instantiation from the context;
+     * PathfindingLogic fills the context from BackendInputParams.
+     *
+     * A cost policy also fixes the storage layout (layout()) of the search: the workspace and the
+     * cellCosts() idx argument use it, while heuristics, parents handed back and paths stay row-major.
+     */
+
+    template <typename T>
+    struct TypeTag { using type = T; };
+
+    // --- Cost models: the outgoing costs of cell (x, y) = idx in layout(), in dx/dy order, max() = blocked or out of bounds ---
+
+    /** @brief Tobler costs read from the precomputed EdgeCostCache. */
+    struct CachedToblerCosts {
+        const EdgeCostCache* cache = nullptr;
+        mapgeo::RowMajorLayout layout() const { return { static_cast<int>(cache->width()), static_cast<int>(cache->height()) }; }
+        void cellCosts(int, int, int idx, float* out) const {
+            for (int dir = 0; dir < PathfindingUtils::NUM_DIRECTIONS; ++dir) { out[dir] = cache->cost(idx, dir); }
+        }
+    };
+
+    /** @brief Tobler costs evaluated on the fly by the batched kernel. */
+    struct ToblerCosts {
+        const mapgeo::Grid_V3* grid = nullptr;
+        const mapgeo::ElevationRaster* elevation = nullptr;
+        float resolution = 1.0f;
+        mapgeo::RowMajorLayout layout() const { return { static_cast<int>(grid->width()), static_cast<int>(grid->height()) }; }
+        void cellCosts(int x, int y, int, float* out) const { toblerNeighborCosts(*grid, *elevation, resolution, x, y, out); }
+    };
+
+    /**
+     * @brief Distance x terrain x a constant slope penalty; reads no elevation.
+     * penalty = 1 is CostModel::TerrainOnly, flatToblerPenalty() is CostModel::FlatTobler.
+     */
+    struct TerrainCosts {
+        const mapgeo::Grid_V3* grid = nullptr;
+        float penalty = 1.0f;
+        mapgeo::RowMajorLayout layout() const { return { static_cast<int>(grid->width()), static_cast<int>(grid->height()) }; }
+        void cellCosts(int x, int y, int, float* out) const {
+            using namespace PathfindingUtils;
+            const int width = static_cast<int>(grid->width());
+            const int height = static_cast<int>(grid->height());
+            const mapgeo::GridCellData* cells = grid->data().data();
+            if (x > 0 && x < width - 1 && y > 0 && y < height - 1) {
+                // Interior cell (most expansions): every neighbour is in bounds
+                const mapgeo::GridCellData* center = cells + toIndex(x, y, width);
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    const mapgeo::GridCellData& cell = center[dy[dir] * width + dx[dir]];
+                    const bool blocked = cell.value <= 0.0f || cell.hasFlag(mapgeo::GridFlags::FLAG_IMPASSABLE);
+                    out[dir] = blocked ? std::numeric_limits<float>::max() : costs[dir] * cell.value * penalty;
+                }
+                return;
+            }
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                const int nx = x + dx[dir];
+                const int ny = y + dy[dir];
+                out[dir] = std::numeric_limits<float>::max();
+                if (nx < 0 || nx >= width || ny < 0 || ny >= height) { continue; }
+                const mapgeo::GridCellData& cell = cells[toIndex(nx, ny, width)];
+                if (cell.value <= 0.0f || cell.hasFlag(mapgeo::GridFlags::FLAG_IMPASSABLE)) { continue; }
+                out[dir] = costs[dir] * cell.value * penalty; // Same operation order as toblerStepCost
+            }
+        }
+    };
+
+    /** @brief ToblerCosts with terrain from the compact grid (1 byte per neighbour instead of 8). */
+    struct CompactToblerCosts {
+        mapgeo::CompactGridView grid;
+        const mapgeo::ElevationRaster* elevation = nullptr;
+        float resolution = 1.0f;
+        mapgeo::RowMajorLayout layout() const { return { grid.width, grid.height }; }
+        void cellCosts(int x, int y, int, float* out) const { toblerNeighborCosts(grid, *elevation, resolution, x, y, out); }
+    };
+
+    /** @brief TerrainCosts from the compact grid: one code and one table load per neighbour, no flag test. */
+    struct CompactTerrainCosts {
+        mapgeo::CompactGridView grid;
+        float penalty = 1.0f;
+        mapgeo::RowMajorLayout layout() const { return { grid.width, grid.height }; }
+        void cellCosts(int x, int y, int idx, float* out) const {
+            using namespace PathfindingUtils;
+            const int width = grid.width;
+            const bool interior = x > 0 && x < width - 1 && y > 0 && y < grid.height - 1;
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                const int nx = x + dx[dir];
+                const int ny = y + dy[dir];
+                const bool inside = interior || (nx >= 0 && nx < width && ny >= 0 && ny < grid.height);
+                const float terrain = inside ? grid.terrainAt(idx + dy[dir] * width + dx[dir]) : 0.0f;
+                out[dir] = (terrain > 0.0f) ? costs[dir] * terrain * penalty : std::numeric_limits<float>::max(); // Same operation order as TerrainCosts
+            }
+        }
+    };
+
+    /** @brief CompactToblerCosts over the tiled copies; idx is a TiledLayout index. */
+    struct TiledToblerCosts {
+        mapgeo::TiledGridView grid;
+        float resolution = 1.0f;
+        const mapgeo::TiledLayout& layout() const { return grid.layout; }
+        void cellCosts(int x, int y, int idx, float* out) const { toblerNeighborCosts(grid, resolution, x, y, idx, out); }
+    };
+
+    /** @brief CompactTerrainCosts over the tiled copy; idx is a TiledLayout index. */
+    struct TiledTerrainCosts {
+        mapgeo::TiledGridView grid;
+        float penalty = 1.0f;
+        const mapgeo::TiledLayout& layout() const { return grid.layout; }
+        void cellCosts(int x, int y, int idx, float* out) const {
+            using namespace PathfindingUtils;
+            using mapgeo::TiledLayout;
+            const int local_x = x & TiledLayout::TILE_MASK;
+            const int local_y = y & TiledLayout::TILE_MASK;
+            const bool in_tile = local_x > 0 && local_x < TiledLayout::TILE_MASK && local_y > 0 && local_y < TiledLayout::TILE_MASK;
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                const int nx = x + dx[dir];
+                const int ny = y + dy[dir];
+                float terrain = 0.0f;
+                if (in_tile) { terrain = grid.terrainAt(idx + dy[dir] * TiledLayout::TILE_SIZE + dx[dir]); }
+                else if (nx >= 0 && nx < grid.layout.width && ny >= 0 && ny < grid.layout.height) { terrain = grid.terrainAt(grid.layout.toIndex(nx, ny)); }
+                out[dir] = (terrain > 0.0f) ? costs[dir] * terrain * penalty : std::numeric_limits<float>::max(); // Same operation order as TerrainCosts
+            }
+        }
+    };
+
+    /** @brief Tobler slope penalty of level ground, so FlatTobler costs equal toblerStepCost(dir, res, 0, terrain) bit for bit. */
+    inline float flatToblerPenalty() { return toblerStepCost(0, 1.0f, 0.0f, 1.0f); }
+
+    // --- A* heuristics (grid coordinates; CONSISTENT = false makes A* reopen closed cells) ---
+
+    struct EuclideanHeuristic {
+        static constexpr bool CONSISTENT = true;
+        static constexpr bool PRUNES_UNREACHABLE = false;
+        int end_x = 0, end_y = 0;
+        float operator()(int x, int y, int) const { return PathfindingUtils::internal::euclidean_distance(x, y, end_x, end_y); }
+    };
+
+    struct DiagonalHeuristic {
+        static constexpr bool CONSISTENT = true;
+        static constexpr bool PRUNES_UNREACHABLE = false;
+        int end_x = 0, end_y = 0;
+        float operator()(int x, int y, int) const { return PathfindingUtils::internal::diagonal_distance(x, y, end_x, end_y); }
+    };
+
+    // Counts a diagonal step as 2 while it costs sqrt(2) on the 8-connected grid, so it is not
+    // consistent there (nor admissible): A* must be allowed to reopen closed cells
+    struct ManhattanHeuristic {
+        static constexpr bool CONSISTENT = false;
+        static constexpr bool PRUNES_UNREACHABLE = false;
+        int end_x = 0, end_y = 0;
+        float operator()(int x, int y, int) const { return PathfindingUtils::internal::manhattan_distance(x, y, end_x, end_y); }
+    };
+
+    // HEURISTIC_MIN_COST: diagonal distance scaled by the assumed minimum cost factor (as calculate_heuristic)
+    struct MinCostHeuristic {
+        static constexpr bool CONSISTENT = true;
+        static constexpr bool PRUNES_UNREACHABLE = false;
+        int end_x = 0, end_y = 0;
+        float operator()(int x, int y, int) const { return PathfindingUtils::internal::diagonal_distance(x, y, end_x, end_y) * 0.8f; }
+    };
+
+    // HEURISTIC_ALT: landmark bounds combined with the terrain-scaled Euclidean bound. The quantised
+    // landmark bound is admissible but not strictly consistent, so closed cells may be reopened.
+    struct LandmarkBoundHeuristic {
+        static constexpr bool CONSISTENT = false;
+        static constexpr bool PRUNES_UNREACHABLE = false;
+        LandmarkHeuristic::Query bound;
+        float min_terrain_cost = 0.0f;
+        int end_x = 0, end_y = 0;
+        float operator()(int x, int y, int idx) const {
+            return std::max(bound(idx), min_terrain_cost * PathfindingUtils::internal::euclidean_distance(x, y, end_x, end_y));
+        }
+    };
+
+    // Travel-time field to the target: the exact remaining cost, but summed backward in float while
+    // the search sums forward. Each sum over n steps is within n * FLT_EPSILON / 2 (relative) of the
+    // real one, so the field is lowered by (n + 1) * FLT_EPSILON, with n <= time * steps_per_cost + 1
+    // since no step is cheaper than 1 / steps_per_cost. Cells the field cannot reach the target from
+    // are never opened.
+    struct TravelTimeHeuristic {
+        static constexpr bool CONSISTENT = false;
+        static constexpr bool PRUNES_UNREACHABLE = true;
+        const TravelTimeField* field = nullptr;
+        float steps_per_cost = 0.0f; // 1 / cheapest possible step cost
+        float operator()(int, int, int idx) const {
+            const float time = field->time(idx);
+            const float steps = time * steps_per_cost + 1.0f;
+            return std::max(0.0f, time * (1.0f - (steps + 1.0f) * std::numeric_limits<float>::epsilon()));
+        }
+        bool reachable(int idx) const { return field->time(idx) < TravelTimeField::UNREACHABLE; }
+    };
+
+    // --- Dispatch ---
+
+    /** @brief True if the context can produce edge costs for its cost model (Tobler needs a cache or elevation). */
+    inline bool searchCostsAvailable(const PathfindingContext& context) {
+        if (!context.isValid()) { return false; }
+        return context.cost_model != CostModel::Tobler || context.hasEdgeCosts() || context.hasElevation();
+    }
+
+    /**
+     * @brief Calls fn with the cost policy of context.cost_model. Requires searchCostsAvailable(context).
+     * Costs read from the compact or tiled grid, when attached, are the same as from the grid itself.
+     */
+    template <typename Fn>
+    auto withCostModel(const PathfindingContext& context, Fn&& fn) {
+        const bool compact = context.hasCompactGrid();
+        const bool tiled = context.hasTiledGrid();
+        if (context.cost_model != CostModel::Tobler) {
+            const float penalty = (context.cost_model == CostModel::FlatTobler) ? flatToblerPenalty() : 1.0f;
+            if (tiled) { return fn(TiledTerrainCosts{ context.tiled_grid->view(), penalty }); }
+            if (compact) { return fn(CompactTerrainCosts{ context.compact_grid->view(), penalty }); }
+            return fn(TerrainCosts{ context.grid, penalty });
+        }
+        if (context.hasEdgeCosts()) { return fn(CachedToblerCosts{ context.edge_costs }); }
+        if (tiled && context.tiled_grid->hasElevation()) { return fn(TiledToblerCosts{ context.tiled_grid->view(), context.log_cell_resolution }); }
+        if (compact) { return fn(CompactToblerCosts{ context.compact_grid->view(), context.elevation, context.log_cell_resolution }); }
+        return fn(ToblerCosts{ context.grid, context.elevation, context.log_cell_resolution });
+    }
+
+    /**
+     * @brief Calls fn(queue_tag, cost_policy, connectivity) with the instantiation chosen by the context:
+     *        queue_tag is a TypeTag of the open list, connectivity a std::integral_constant<int, 4 or 8>.
+     */
+    template <typename Fn>
+    auto withSearchKernel(const PathfindingContext& context, Fn&& fn) {
+        return withCostModel(context, [&](const auto& cost_policy) {
+            const bool radix = context.queue_type == QueueType::RadixHeap;
+            if (context.connectivity == 4) {
+                using Four = std::integral_constant<int, 4>;
+                return radix ? fn(TypeTag<RadixHeapQueue>{}, cost_policy, Four{}) : fn(TypeTag<BinaryHeapQueue>{}, cost_policy, Four{});
+            }
+            using Eight = std::integral_constant<int, PathfindingUtils::NUM_DIRECTIONS>;
+            return radix ? fn(TypeTag<RadixHeapQueue>{}, cost_policy, Eight{}) : fn(TypeTag<BinaryHeapQueue>{}, cost_policy, Eight{});
+        });
+    }
+
+} // namespace Pathfinding
+
+#endif // SEARCH_KERNELS_HPP
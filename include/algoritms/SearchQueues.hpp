@@ -0,0 +1,118 @@
+// File: SearchQueues.hpp
+#ifndef SEARCH_QUEUES_HPP
+#define SEARCH_QUEUES_HPP
+
+#include <vector>
+#include <queue>
+#include <utility>
+#include <functional>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Pathfinding {
+
+    /** @brief Open-list implementation used by A* and Dijkstra (see PathfindingContext::queue_type). */
+    enum class QueueType {
+        BinaryHeap, // std::priority_queue with lazy deletion (PathfindingContext default)
+        RadixHeap   // Monotone radix heap over the float key bits (BackendInputParams default)
+    };
+
+    /**
+     * @class BinaryHeapQueue
+     * @brief Min-heap of (key, cell index); duplicates are allowed and skipped by the caller (lazy deletion).
+     */
+    class BinaryHeapQueue {
+    public:
+        bool empty() const { return heap_.empty(); }
+        std::size_t size() const { return heap_.size(); }
+        void push(float key, int idx) { heap_.push({ key, idx }); }
+        std::pair<float, int> popMin() {
+            const std::pair<float, int> top = heap_.top();
+            heap_.pop();
+            return top;
+        }
+
+    private:
+        using Entry = std::pair<float, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap_;
+    };
+
+    /**
+     * @class RadixHeapQueue
+     * @brief Monotone radix heap keyed on the bit pattern of non-negative floats.
+     *
+     * For non-negative IEEE floats the unsigned bit pattern orders like the value, so the classic
+     * integer radix heap applies: 33 buckets by the highest bit in which a key differs from the last
+     * extracted key. Push is O(1); each entry is moved between buckets at most 32 times in total.
+     * Keys must not fall below the last extracted key. Dijkstra satisfies this (non-negative edges).
+     * For A* with an inconsistent heuristic a smaller key is clamped to the last extracted key,
+     * i.e. that entry is expanded next; the search stays correct, as with lazy deletion.
+     */
+    class RadixHeapQueue {
+    public:
+        bool empty() const { return size_ == 0; }
+        std::size_t size() const { return size_; }
+
+        void push(float key, int idx) {
+            std::uint32_t k = toKey(key);
+            if (k < last_) { k = last_; }
+            buckets_[bucketIndex(k)].push_back({ k, idx });
+            ++size_;
+        }
+
+        std::pair<float, int> popMin() {
+            if (buckets_[0].empty()) {
+                int i = 1;
+                while (buckets_[i].empty()) { ++i; }
+                // New minimum becomes the reference; everything in bucket i moves to a lower bucket
+                std::uint32_t new_last = buckets_[i][0].first;
+                for (const Entry& e : buckets_[i]) { if (e.first < new_last) { new_last = e.first; } }
+                last_ = new_last;
+                for (const Entry& e : buckets_[i]) { buckets_[bucketIndex(e.first)].push_back(e); }
+                buckets_[i].clear();
+            }
+            const Entry e = buckets_[0].back();
+            buckets_[0].pop_back();
+            --size_;
+            return { fromKey(e.first), e.second };
+        }
+
+    private:
+        using Entry = std::pair<std::uint32_t, int>;
+
+        static std::uint32_t toKey(float key) {
+            if (!(key > 0.0f)) { return 0; } // Negative (not expected) and zero map to the smallest key
+            std::uint32_t bits;
+            std::memcpy(&bits, &key, sizeof(bits));
+            return bits;
+        }
+        static float fromKey(std::uint32_t bits) {
+            float key;
+            std::memcpy(&key, &bits, sizeof(key));
+            return key;
+        }
+        int bucketIndex(std::uint32_t k) const {
+            const std::uint32_t diff = k ^ last_;
+            if (diff == 0) { return 0; }
+#if defined(_MSC_VER)
+            unsigned long msb;
+            _BitScanReverse(&msb, diff);
+            return static_cast<int>(msb) + 1;
+#else
+            return 32 - __builtin_clz(diff);
+#endif
+        }
+
+        std::vector<Entry> buckets_[33];
+        std::uint32_t last_ = 0;
+        std::size_t size_ = 0;
+    };
+
+} // namespace Pathfinding
+
+#endif // SEARCH_QUEUES_HPP
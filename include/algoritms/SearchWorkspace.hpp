@@ -0,0 +1,89 @@
+// File: SearchWorkspace.hpp
+#ifndef SEARCH_WORKSPACE_HPP
+#define SEARCH_WORKSPACE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "algoritms/SegmentCostCache.hpp"
+
+namespace Pathfinding {
+
+    /**
+     * @class SearchWorkspace
+     * @brief Reusable per-thread scratch state (g-score, parent, closed) for grid searches.
+     *
+     * Each cell carries the generation in which it was last written. Starting a new query only
+     * bumps the generation, so cells from earlier queries read back as untouched
+     * (g = +inf, parent = -1, open) without clearing the arrays. A query therefore costs time
+     * proportional to the cells it touches, not to the grid size. The any-angle searches also
+     * memoize segment results in segmentCache(), which is emptied with every new query.
+     * A workspace is not thread-safe; use one per thread (see threadLocalSearchWorkspace()).
+     */
+    class SearchWorkspace {
+    public:
+        SearchWorkspace() = default;
+
+        /** @brief Memory per grid cell once a query has allocated the storage (segment cache not included). */
+        static constexpr std::size_t BYTES_PER_CELL = 16;
+
+        /**
+         * @brief Starts a new query over a grid of cell_count cells.
+         * O(1) unless the grid grew or the generation counter wrapped (then the stamps are cleared once).
+         * @return false if the storage could not be allocated.
+         */
+        bool beginQuery(std::size_t cell_count);
+
+        /** @brief Cost from start, or +inf if the cell was not reached in this query. */
+        float g(int idx) const {
+            const Cell& c = cells_[static_cast<std::size_t>(idx)];
+            return c.stamp == generation_ ? c.g : std::numeric_limits<float>::max();
+        }
+        /** @brief Parent index, or -1 if the cell was not reached in this query. */
+        int parent(int idx) const {
+            const Cell& c = cells_[static_cast<std::size_t>(idx)];
+            return c.stamp == generation_ ? c.parent : -1;
+        }
+        bool isClosed(int idx) const { return cells_[static_cast<std::size_t>(idx)].closed_stamp == generation_; }
+        void close(int idx) { cells_[static_cast<std::size_t>(idx)].closed_stamp = generation_; }
+        /** @brief Puts a closed cell back in the open set (for searches with an inconsistent heuristic). */
+        void reopen(int idx) { cells_[static_cast<std::size_t>(idx)].closed_stamp = 0; }
+
+        /** @brief Records a (better) cost and parent for a cell. */
+        void setScore(int idx, float g, int parent) {
+            Cell& c = cells_[static_cast<std::size_t>(idx)];
+            if (c.stamp != generation_) { c.stamp = generation_; ++touched_; }
+            c.g = g;
+            c.parent = parent;
+        }
+
+        /** @brief Number of distinct cells given a score in the current query. */
+        std::size_t touchedCount() const { return touched_; }
+        std::size_t capacity() const { return cells_.size(); }
+
+        /** @brief Line-of-sight/segment-cost memo for the current query (Theta*, Lazy Theta*). */
+        SegmentCostCache& segmentCache() { return segment_cache_; }
+        const SegmentCostCache& segmentCache() const { return segment_cache_; }
+
+    private:
+        struct Cell {
+            std::uint32_t stamp = 0;        // Generation in which g/parent were last written
+            std::uint32_t closed_stamp = 0; // Generation in which the cell was closed
+            float g = 0.0f;
+            int parent = -1;
+        };
+        static_assert(sizeof(Cell) == BYTES_PER_CELL, "BYTES_PER_CELL must match the cell layout");
+
+        std::vector<Cell> cells_;
+        std::uint32_t generation_ = 0; // 0 is never a live generation
+        std::size_t touched_ = 0;
+        SegmentCostCache segment_cache_;
+    };
+
+    /** @brief The calling thread's default workspace, used by the overloads that do not take one. */
+    SearchWorkspace& threadLocalSearchWorkspace();
+
+} // namespace Pathfinding
+
+#endif // SEARCH_WORKSPACE_HPP
@@ -0,0 +1,94 @@
+// File: SegmentCostCache.hpp
+#ifndef SEGMENT_COST_CACHE_HPP
+#define SEGMENT_COST_CACHE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Pathfinding {
+
+    /**
+     * @class SegmentCostCache
+     * @brief Bounded memo of straight-segment results (line of sight + Tobler cost) for the any-angle searches.
+     *
+     * Open addressing over a fixed power-of-two table, keyed by the packed (from, to) cell pair, with
+     * a short linear probe. When the probe window is full the home slot is overwritten, so the table
+     * never grows past its capacity (16 bytes per entry). The key is ordered, since the slope term
+     * makes cost(a, b) != cost(b, a). Entries carry a generation stamp like SearchWorkspace, so
+     * starting a query empties the cache in O(1). The table is allocated on the first store;
+     * if that fails the cache stays disabled and every lookup misses.
+     */
+    class SegmentCostCache {
+    public:
+        static constexpr std::size_t DEFAULT_CAPACITY = std::size_t(1) << 16; // 1 MiB
+        static constexpr int PROBE_LIMIT = 4;
+
+        explicit SegmentCostCache(std::size_t capacity = DEFAULT_CAPACITY);
+
+        /** @brief Forgets all entries and zeroes the counters (O(1)). */
+        void clear();
+
+        /** @brief Stored result for from -> to, if any; counts a hit or a miss. */
+        bool lookup(int from, int to, float& cost) {
+            if (!entries_.empty()) {
+                const std::uint64_t key = packKey(from, to);
+                std::size_t slot = homeSlot(key);
+                for (int probe = 0; probe < PROBE_LIMIT; ++probe) {
+                    const Entry& e = entries_[slot];
+                    if (e.stamp != generation_) { break; } // Empty slot ends the probe chain
+                    if (e.key == key) { cost = e.cost; ++hits_; return true; }
+                    slot = (slot + 1) & mask_;
+                }
+            }
+            ++misses_;
+            return false;
+        }
+
+        /** @brief Records the result for from -> to (may evict an older entry). */
+        void store(int from, int to, float cost) {
+            if (entries_.empty() && (allocation_failed_ || !allocate())) { return; }
+            const std::uint64_t key = packKey(from, to);
+            const std::size_t home = homeSlot(key);
+            std::size_t slot = home;
+            for (int probe = 0; probe < PROBE_LIMIT; ++probe) {
+                Entry& e = entries_[slot];
+                if (e.stamp != generation_ || e.key == key) { e = { key, cost, generation_ }; return; }
+                slot = (slot + 1) & mask_;
+            }
+            entries_[home] = { key, cost, generation_ }; // Window full: evict the home entry
+        }
+
+        std::size_t hits() const { return hits_; }
+        std::size_t misses() const { return misses_; }
+        std::size_t capacity() const { return capacity_; }
+        std::size_t memoryBytes() const { return entries_.capacity() * sizeof(Entry); }
+
+    private:
+        struct Entry {
+            std::uint64_t key = 0;
+            float cost = 0.0f;
+            std::uint32_t stamp = 0; // Generation in which the entry was written; 0 is never live
+        };
+
+        static std::uint64_t packKey(int from, int to) {
+            return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(from)) << 32) | static_cast<std::uint32_t>(to);
+        }
+        std::size_t homeSlot(std::uint64_t key) const {
+            return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_) & mask_; // Fibonacci hashing
+        }
+        bool allocate();
+
+        std::vector<Entry> entries_;
+        std::size_t capacity_ = 0;
+        std::size_t mask_ = 0;
+        unsigned shift_ = 64;
+        std::uint32_t generation_ = 1;
+        std::size_t hits_ = 0;
+        std::size_t misses_ = 0;
+        bool allocation_failed_ = false;
+    };
+
+} // namespace Pathfinding
+
+#endif // SEGMENT_COST_CACHE_HPP
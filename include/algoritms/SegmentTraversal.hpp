@@ -0,0 +1,136 @@
+// File: SegmentTraversal.hpp
+#ifndef SEGMENT_TRAVERSAL_HPP
+#define SEGMENT_TRAVERSAL_HPP
+
+#include "map/MapProcessingCommon.h" // For Grid_V3
+#include "map/PathfindingUtils.hpp"  // For toIndex
+#include "map/ElevationRaster.hpp"
+#include "algoritms/SegmentCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"   // For toblerStepCost
+#include <vector>
+#include <limits>
+#include <cstdlib>
+#include <algorithm>
+
+namespace Pathfinding {
+
+    /**
+     * @brief Line of sight and Tobler cost of the straight segment (x0, y0) -> (x1, y1) in one pass.
+     *
+     * Walks the Bresenham cells of the segment once. Each step into a blocked cell stops the walk;
+     * otherwise the step's cost is added (cell-centre distance x Tobler penalty x terrain value of the
+     * entered cell, elevation from the raster). This equals the old hasLineOfSight() plus
+     * calculateSegmentCost() pair, without building the cell list. Nothing is allocated.
+     * Header-only so the any-angle planners can inline it into their relaxation loops.
+     *
+     * @return Cost in world units (metres x multipliers); 0 for a single cell;
+     *         std::numeric_limits<float>::max() if an endpoint is out of bounds or any cell after the start is blocked.
+     */
+    inline float traceSegmentCost(
+        const mapgeo::Grid_V3& grid,
+        const mapgeo::ElevationRaster& elevation,
+        float resolution,
+        int x0, int y0, int x1, int y1)
+    {
+        using namespace PathfindingUtils;
+        constexpr float INF = std::numeric_limits<float>::max();
+        constexpr int AXIAL_DIR = 0;    // costs[0] = 1
+        constexpr int DIAGONAL_DIR = 4; // costs[4] = sqrt(2)
+        // Every Bresenham cell lies in the endpoints' bounding box, so checking the endpoints suffices
+        if (!grid.inBounds(x0, y0) || !grid.inBounds(x1, y1)) { return INF; }
+
+        const mapgeo::GridCellData* cells = grid.data().data();
+        const int width = static_cast<int>(grid.width());
+        const int adx = std::abs(x1 - x0);
+        const int ady = -std::abs(y1 - y0);
+        const int sx = (x0 < x1) ? 1 : -1;
+        const int sy = (y0 < y1) ? 1 : -1;
+        const int row_step = sy * width;
+        int err = adx + ady;
+        int cx = x0;
+        int cy = y0;
+        int idx = toIndex(x0, y0, width);
+        float prev_elev = elevation.atIndex(idx);
+        float total_cost = 0.0f;
+
+        while (cx != x1 || cy != y1) {
+            const int e2 = 2 * err;
+            bool moved_x = false;
+            bool moved_y = false;
+            if (e2 >= ady) {
+                if (cx == x1) { break; }
+                err += ady; cx += sx; idx += sx;
+                moved_x = true;
+            }
+            if (e2 <= adx) {
+                if (cy == y1) { break; }
+                err += adx; cy += sy; idx += row_step;
+                moved_y = true;
+            }
+
+            const mapgeo::GridCellData& cell = cells[idx];
+            if (cell.hasFlag(mapgeo::GridFlags::FLAG_IMPASSABLE) || cell.value <= mapgeo::numeric_traits<float>::epsilon) {
+                return INF; // Blocked: no line of sight
+            }
+            const float elev = elevation.atIndex(idx);
+            const float step_cost = toblerStepCost((moved_x && moved_y) ? DIAGONAL_DIR : AXIAL_DIR, resolution, elev - prev_elev, cell.value);
+            if (step_cost >= INF) { return INF; }
+            total_cost += step_cost * resolution; // toblerStepCost is per cell; segments are in world units
+            prev_elev = elev;
+        }
+        return total_cost;
+    }
+
+    // Shorter segments are re-traced: walking a few cells is cheaper than a cache probe
+    inline constexpr int MIN_CACHED_SEGMENT_CELLS = 4;
+
+    /**
+     * @brief traceSegmentCost() between two cell indices, memoized in cache (e.g. the search
+     *        workspace's segmentCache()) when the segment spans at least MIN_CACHED_SEGMENT_CELLS.
+     *        Blocked segments are cached too, as max().
+     */
+    inline float cachedSegmentCost(
+        SegmentCostCache& cache,
+        const mapgeo::Grid_V3& grid,
+        const mapgeo::ElevationRaster& elevation,
+        float resolution,
+        int fromIdx, int toIdx)
+    {
+        const int width = static_cast<int>(grid.width());
+        int x0, y0, x1, y1;
+        PathfindingUtils::toCoords(fromIdx, width, x0, y0);
+        PathfindingUtils::toCoords(toIdx, width, x1, y1);
+        if (std::max(std::abs(x1 - x0), std::abs(y1 - y0)) < MIN_CACHED_SEGMENT_CELLS) {
+            return traceSegmentCost(grid, elevation, resolution, x0, y0, x1, y1);
+        }
+        float cost;
+        if (cache.lookup(fromIdx, toIdx, cost)) { return cost; }
+        cost = traceSegmentCost(grid, elevation, resolution, x0, y0, x1, y1);
+        cache.store(fromIdx, toIdx, cost);
+        return cost;
+    }
+
+    /**
+     * @brief Appends the Bresenham cells of (x0, y0) -> (x1, y1) to out, without the start cell
+     *        (the same cells traceSegmentCost() walks). Used to expand any-angle paths to grid paths.
+     */
+    inline void appendSegmentCells(int x0, int y0, int x1, int y1, int width, std::vector<int>& out) {
+        const int adx = std::abs(x1 - x0);
+        const int ady = -std::abs(y1 - y0);
+        const int sx = (x0 < x1) ? 1 : -1;
+        const int sy = (y0 < y1) ? 1 : -1;
+        int err = adx + ady;
+        int cx = x0;
+        int cy = y0;
+        while (cx != x1 || cy != y1) {
+            const int e2 = 2 * err;
+            if (e2 >= ady) { if (cx == x1) { break; } err += ady; cx += sx; }
+            if (e2 <= adx) { if (cy == y1) { break; } err += adx; cy += sy; }
+            const int idx = PathfindingUtils::toIndex(cx, cy, width);
+            if (out.empty() || out.back() != idx) { out.push_back(idx); }
+        }
+    }
+
+} // namespace Pathfinding
+
+#endif // SEGMENT_TRAVERSAL_HPP
@@ -3,6 +3,8 @@
 
 #include "map/MapProcessingCommon.h" // For Grid_V3
 #include "map/PathfindingUtils.hpp"  // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include "algoritms/SearchWorkspace.hpp"    // For SearchWorkspace
 #include <vector>
 
 namespace Pathfinding {
@@ -22,6 +24,28 @@ namespace Pathfinding {
         int heuristic_type // Kept for API consistency, but primarily uses Euclidean internally
     );
 
+    /**
+     * @brief Theta* over a prepared PathfindingContext (no per-call elevation resampling, thread-local workspace).
+     */
+    std::vector<int> findThetaStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end,
+        int heuristic_type
+    );
+
+    /**
+     * @brief Theta* using a caller-owned SearchWorkspace, so back-to-back legs on one thread
+     *        only pay for the cells they touch. The overload above uses the thread-local workspace.
+     */
+    std::vector<int> findThetaStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end,
+        int heuristic_type
+    );
+
 } // namespace Pathfinding
 
 #endif // THETA_STAR_TOBLER_SAMPLED_HPP
\ No newline at end of file
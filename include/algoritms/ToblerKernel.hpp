@@ -0,0 +1,258 @@
+// File: ToblerKernel.hpp
+#ifndef TOBLER_KERNEL_HPP
+#define TOBLER_KERNEL_HPP
+
+#include "map/MapProcessingCommon.h" // For Grid_V3
+#include "map/ElevationRaster.hpp"   // For ElevationRaster
+#include "map/CompactGrid.hpp"       // For CompactGridView
+#include "map/TiledGrid.hpp"         // For TiledGridView
+#include "map/PathfindingUtils.hpp"  // For costs, dx/dy, MAX_TOBLER_PENALTY
+#include "algoritms/PathfindingContext.hpp"
+#include "algoritms/EdgeCostCache.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <vector>
+
+namespace Pathfinding {
+
+    /**
+     * Tobler edge costs without std::exp, shared by the CPU planners and EdgeCostCache.
+     *
+     * The slope penalty min(1 / exp(-3.5 |S + 0.05|), MAX_TOBLER_PENALTY) is evaluated as
+     * exp(x), x = 3.5 |S + 0.05|, with a Cody-Waite range reduction and a degree-5 polynomial
+     * (Cephes expf coefficients). Only 0 <= x <= ln(MAX_TOBLER_PENALTY) is ever evaluated, where the
+     * relative error against PathfindingUtils::toblerEdgeCost is below TOBLER_KERNEL_MAX_RELATIVE_ERROR
+     * (measured 1.7e-7 by tests/ToblerKernelAccuracyTest.cpp). Larger penalties are exactly the cap, and
+     * slopes the reference treats as impassable (exp(-x) <= EPSILON) return max() here as well; the two
+     * can only disagree for x within an ulp of ln(1 / EPSILON).
+     *
+     * toblerEdgeCosts8() does all 8 neighbours of a cell at once (AVX2, SSE2 or scalar, picked at
+     * first use from the CPU features). The default USE_AVX2 build compiles the whole application for
+     * AVX2, so there it needs an AVX2 CPU and always picks the AVX2 variant; only a USE_AVX2=OFF build
+     * runs on older CPUs and falls back at runtime. Every variant, and toblerStepCost() for single edges, runs the
+     * same sequence of IEEE operations, so a cost does not depend on which one computed it: costs
+     * from EdgeCostCache and from the planners' on-the-fly paths stay identical.
+     */
+    inline constexpr float TOBLER_KERNEL_MAX_RELATIVE_ERROR = 1e-6f;
+
+    namespace tobler_kernel_detail {
+        inline constexpr float SLOPE_OFFSET = 0.05f;
+        inline constexpr float SLOPE_RATE = 3.5f;
+        // Slightly above ln(MAX_TOBLER_PENALTY): exp() of the clamped exponent always exceeds the cap,
+        // so min() returns the cap exactly for every steeper slope
+        inline constexpr float EXP_CLAMP = 6.908f;
+        inline constexpr float LN_INV_EPSILON = 13.8155106f; // ln(1 / EPSILON): reference SlopeFactor <= EPSILON beyond this
+        inline constexpr float LOG2E = 1.44269504f;
+        inline constexpr float LN2_HI = 0.693359375f;     // ln 2 split so n * LN2_HI is exact
+        inline constexpr float LN2_LO = -2.12194440e-4f;
+        inline constexpr float P0 = 1.9875691500e-4f;
+        inline constexpr float P1 = 1.3981999507e-3f;
+        inline constexpr float P2 = 8.3334519073e-3f;
+        inline constexpr float P3 = 4.1665795894e-2f;
+        inline constexpr float P4 = 1.6666665459e-1f;
+        inline constexpr float P5 = 5.0000001201e-1f;
+
+        /** @brief exp(x) for 0 <= x <= EXP_CLAMP (scalar reference of the SIMD sequence). */
+        inline float expNonNegative(float x) {
+            const int n = static_cast<int>(x * LOG2E + 0.5f); // x >= 0: truncation rounds to nearest
+            const float fn = static_cast<float>(n);
+            const float r = (x - fn * LN2_HI) - fn * LN2_LO;  // |r| <= ln(2) / 2
+            const float z = r * r;
+            float p = P0;
+            p = p * r + P1;
+            p = p * r + P2;
+            p = p * r + P3;
+            p = p * r + P4;
+            p = p * r + P5;
+            const float e = (p * z + r) + 1.0f;
+            const std::uint32_t scale_bits = static_cast<std::uint32_t>(n + 127) << 23; // 2^n, n in [0, 10]
+            float scale;
+            std::memcpy(&scale, &scale_bits, sizeof(scale));
+            return e * scale;
+        }
+    } // namespace tobler_kernel_detail
+
+    /**
+     * @brief toblerEdgeCost() for one edge, via the polynomial exp.
+     * Like the reference, does not check terrain_value; callers skip blocked neighbours first.
+     * @return Movement cost, or std::numeric_limits<float>::max() if impassable.
+     */
+    inline float toblerStepCost(int dir, float resolution, float delta_h, float terrain_value) {
+        using namespace tobler_kernel_detail;
+        const float base_geometric_cost = PathfindingUtils::costs[dir];
+        const float delta_dist_world = base_geometric_cost * resolution;
+        if (delta_dist_world <= PathfindingUtils::EPSILON) { return std::numeric_limits<float>::max(); }
+        const float S = delta_h / delta_dist_world;
+        const float x = SLOPE_RATE * std::fabs(S + SLOPE_OFFSET);
+        if (!(x < LN_INV_EPSILON)) { return std::numeric_limits<float>::max(); } // Also catches NaN, as the reference does
+        const float time_penalty = std::min(expNonNegative(std::min(x, EXP_CLAMP)), PathfindingUtils::MAX_TOBLER_PENALTY);
+        return base_geometric_cost * terrain_value * time_penalty;
+    }
+
+    /** @brief A cell the searches may enter: positive terrain value and not flagged impassable. */
+    inline bool isPassable(const mapgeo::GridCellData& cell) {
+        return cell.value > 0.0f && !cell.hasFlag(mapgeo::GridFlags::FLAG_IMPASSABLE);
+    }
+    inline bool isPassable(const mapgeo::Grid_V3& grid, int x, int y) { return isPassable(grid.at(x, y)); }
+
+    /**
+     * @brief Tobler cost of the grid step from (x, y) in direction dir, as A* and Dijkstra relax it.
+     * @param edge_costs context.edge_costs if usable (context.hasEdgeCosts()), else null for on-the-fly costs.
+     * @return max() if the neighbour is out of bounds or impassable, or the slope is too steep.
+     */
+    inline float stepCost(const PathfindingContext& context, const EdgeCostCache* edge_costs, int x, int y, int dir) {
+        using namespace PathfindingUtils;
+        const mapgeo::Grid_V3& grid = *context.grid;
+        const int width = static_cast<int>(grid.width());
+        const int idx = toIndex(x, y, width);
+        if (edge_costs != nullptr) { return edge_costs->cost(idx, dir); }
+
+        const int nx = x + dx[dir];
+        const int ny = y + dy[dir];
+        if (!grid.inBounds(nx, ny) || !isPassable(grid, nx, ny)) { return std::numeric_limits<float>::max(); }
+        const int neighborIdx = toIndex(nx, ny, width);
+        const float delta_h = context.elevation->atIndex(neighborIdx) - context.elevation->atIndex(idx);
+        return toblerStepCost(dir, context.log_cell_resolution, delta_h, grid.at(nx, ny).value);
+    }
+
+    /**
+     * @brief Cost of the reversed step: from the neighbour (x + dx[dir], y + dy[dir]) into (x, y), for
+     * backward searches. stepCost() only checks the cell it steps into, so the neighbour's own
+     * passability is checked here (max() if it is out of bounds or impassable).
+     */
+    inline float reverseStepCost(const PathfindingContext& context, const EdgeCostCache* edge_costs, int x, int y, int dir) {
+        using namespace PathfindingUtils;
+        const int nx = x + dx[dir];
+        const int ny = y + dy[dir];
+        if (!context.grid->inBounds(nx, ny) || !isPassable(*context.grid, nx, ny)) { return std::numeric_limits<float>::max(); }
+        return stepCost(context, edge_costs, nx, ny, reverse_dir[dir]);
+    }
+
+    /**
+     * @brief Costs of the 8 edges out of one cell, in the dx/dy direction order.
+     * @param delta_h Neighbour elevation minus cell elevation, per direction.
+     * @param terrain Neighbour terrain value per direction; <= 0 (or NaN) marks a blocked or
+     *                out-of-bounds neighbour, whose cost is max().
+     * @param out     Receives toblerStepCost() per direction (max() = impassable).
+     */
+    void toblerEdgeCosts8(float resolution, const float* delta_h, const float* terrain, float* out);
+
+    /** @brief Name of the variant toblerEdgeCosts8() dispatches to ("avx2", "sse2" or "scalar"). */
+    const char* toblerKernelVariant();
+
+    /**
+     * @brief Gathers the neighbourhood of cell (x, y) and evaluates its 8 outgoing edge costs.
+     * Out-of-bounds and impassable neighbours come out as max(), exactly like EdgeCostCache stores them.
+     */
+    inline void toblerNeighborCosts(const mapgeo::Grid_V3& grid, const mapgeo::ElevationRaster& elevation,
+        float resolution, int x, int y, float* out)
+    {
+        using namespace PathfindingUtils;
+        const int width = static_cast<int>(grid.width());
+        const int height = static_cast<int>(grid.height());
+        const mapgeo::GridCellData* cells = grid.data().data();
+        const float current_elevation = elevation.atIndex(toIndex(x, y, width));
+        alignas(32) float delta_h[NUM_DIRECTIONS];
+        alignas(32) float terrain[NUM_DIRECTIONS];
+        for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+            const int nx = x + dx[dir];
+            const int ny = y + dy[dir];
+            delta_h[dir] = 0.0f;
+            terrain[dir] = 0.0f;
+            if (nx < 0 || nx >= width || ny < 0 || ny >= height) { continue; }
+            const int neighborIdx = toIndex(nx, ny, width);
+            const mapgeo::GridCellData& neighborCell = cells[neighborIdx];
+            if (neighborCell.value <= 0.0f || neighborCell.hasFlag(mapgeo::GridFlags::FLAG_IMPASSABLE)) { continue; }
+            delta_h[dir] = elevation.atIndex(neighborIdx) - current_elevation;
+            terrain[dir] = neighborCell.value;
+        }
+        toblerEdgeCosts8(resolution, delta_h, terrain, out);
+    }
+
+    /**
+     * @brief toblerNeighborCosts() reading terrain from a compact grid (same costs as from its source grid).
+     * Blocked neighbours come with terrain 0 from the code table, so interior cells gather without branches.
+     */
+    inline void toblerNeighborCosts(const mapgeo::CompactGridView& grid, const mapgeo::ElevationRaster& elevation,
+        float resolution, int x, int y, float* out)
+    {
+        using namespace PathfindingUtils;
+        const int width = grid.width;
+        const int idx = toIndex(x, y, width);
+        const float current_elevation = elevation.atIndex(idx);
+        alignas(32) float delta_h[NUM_DIRECTIONS];
+        alignas(32) float terrain[NUM_DIRECTIONS];
+        if (x > 0 && x < width - 1 && y > 0 && y < grid.height - 1) {
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                const int neighborIdx = idx + dy[dir] * width + dx[dir];
+                delta_h[dir] = elevation.atIndex(neighborIdx) - current_elevation; // Ignored where terrain is 0
+                terrain[dir] = grid.terrainAt(neighborIdx);
+            }
+        }
+        else {
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                const int nx = x + dx[dir];
+                const int ny = y + dy[dir];
+                delta_h[dir] = 0.0f;
+                terrain[dir] = 0.0f;
+                if (nx < 0 || nx >= width || ny < 0 || ny >= grid.height) { continue; }
+                const int neighborIdx = toIndex(nx, ny, width);
+                delta_h[dir] = elevation.atIndex(neighborIdx) - current_elevation;
+                terrain[dir] = grid.terrainAt(neighborIdx);
+            }
+        }
+        toblerEdgeCosts8(resolution, delta_h, terrain, out);
+    }
+
+    /**
+     * @brief toblerNeighborCosts() over a tiled grid; idx is the TiledLayout index of (x, y).
+     * Cells inside a tile find all neighbours at fixed offsets in the same tile.
+     */
+    inline void toblerNeighborCosts(const mapgeo::TiledGridView& grid, float resolution, int x, int y, int idx, float* out) {
+        using namespace PathfindingUtils;
+        using mapgeo::TiledLayout;
+        const float current_elevation = grid.elevationAt(idx);
+        alignas(32) float delta_h[NUM_DIRECTIONS];
+        alignas(32) float terrain[NUM_DIRECTIONS];
+        const int local_x = x & TiledLayout::TILE_MASK;
+        const int local_y = y & TiledLayout::TILE_MASK;
+        if (local_x > 0 && local_x < TiledLayout::TILE_MASK && local_y > 0 && local_y < TiledLayout::TILE_MASK) {
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                const int neighborIdx = idx + dy[dir] * TiledLayout::TILE_SIZE + dx[dir];
+                delta_h[dir] = grid.elevationAt(neighborIdx) - current_elevation; // Ignored where terrain is 0
+                terrain[dir] = grid.terrainAt(neighborIdx);
+            }
+        }
+        else {
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                const int nx = x + dx[dir];
+                const int ny = y + dy[dir];
+                delta_h[dir] = 0.0f;
+                terrain[dir] = 0.0f;
+                if (nx < 0 || nx >= grid.layout.width || ny < 0 || ny >= grid.layout.height) { continue; }
+                const int neighborIdx = grid.layout.toIndex(nx, ny);
+                delta_h[dir] = grid.elevationAt(neighborIdx) - current_elevation;
+                terrain[dir] = grid.terrainAt(neighborIdx);
+            }
+        }
+        toblerEdgeCosts8(resolution, delta_h, terrain, out);
+    }
+
+    // One variant of toblerEdgeCosts8()
+    struct ToblerKernelVariant {
+        void (*fn)(float resolution, const float* delta_h, const float* terrain, float* out);
+        const char* name;
+    };
+
+    /**
+     * @brief Every variant the running CPU can execute, best first (the first is the one toblerEdgeCosts8()
+     * dispatches to). For the accuracy test; unlike toblerEdgeCosts8() they do not handle a degenerate resolution.
+     */
+    std::vector<ToblerKernelVariant> toblerKernelVariants();
+
+} // namespace Pathfinding
+
+#endif // TOBLER_KERNEL_HPP
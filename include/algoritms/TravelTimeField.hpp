@@ -0,0 +1,62 @@
+// File: TravelTimeField.hpp
+#ifndef TRAVEL_TIME_FIELD_HPP
+#define TRAVEL_TIME_FIELD_HPP
+
+#include "map/PathfindingUtils.hpp"         // For GridPoint
+#include "algoritms/PathfindingContext.hpp" // For PathfindingContext
+#include <vector>
+#include <cstddef>
+#include <limits>
+
+namespace Pathfinding {
+
+    /**
+     * @class TravelTimeField
+     * @brief Optimal Tobler cost from every cell to one target cell (e.g. the finish), aligned with Grid_V3.
+     *
+     * Computed by a single backward search over the reversed (asymmetric) edges using parallel
+     * delta-stepping (the engine shared with DeltaSteppingCPU): cells are kept in buckets of width delta, and all cells of the current bucket
+     * are relaxed together by the OpenMP threads (atomic-min distance updates), repeating until the
+     * bucket stops changing. Results equal those of a backward Dijkstra.
+     *
+     * Besides heat-map export (see IO/RasterExport.hpp) the field is an exact heuristic: A* uses it
+     * automatically for legs ending at target() when attached as context.travel_time.
+     */
+    class TravelTimeField {
+    public:
+        static constexpr float UNREACHABLE = std::numeric_limits<float>::max();
+
+        TravelTimeField() = default;
+
+        /**
+         * @brief Computes the field for target (uses the context's edge-cost cache if present).
+         * @param delta Bucket width in cost units; 0 picks one from the mean edge cost. Raised like the
+         *              delta-stepping planners' (see DeltaSteppingEngine.hpp); delta() returns the width used.
+         * @return An invalid (empty) field if the context is unusable, the target is impassable or
+         *         memory is exhausted.
+         */
+        static TravelTimeField compute(const PathfindingContext& context, const GridPoint& target, float delta = 0.0f);
+
+        bool isValid() const { return width_ > 0 && height_ > 0 && !times_.empty(); }
+        std::size_t width() const { return width_; }
+        std::size_t height() const { return height_; }
+        int targetIndex() const { return target_idx_; }
+        float delta() const { return delta_; }
+
+        /** @brief Cost from cell idx to the target, or UNREACHABLE. */
+        float time(int idx) const { return times_[static_cast<std::size_t>(idx)]; }
+        /** @brief Row-major values, one per grid cell. */
+        const std::vector<float>& times() const { return times_; }
+        std::size_t memoryBytes() const { return times_.size() * sizeof(float); }
+
+    private:
+        std::size_t width_ = 0;
+        std::size_t height_ = 0;
+        int target_idx_ = -1;
+        float delta_ = 0.0f;
+        std::vector<float> times_;
+    };
+
+} // namespace Pathfinding
+
+#endif // TRAVEL_TIME_FIELD_HPP
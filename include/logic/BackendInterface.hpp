@@ -7,14 +7,28 @@
 #include <vector>
 #include <optional>
 #include <map>
+#include <functional>
+#include <memory>
 
 // Include necessary type definitions used within the structs
 #include "map/MapProcessingCommon.h" // Includes GridPoint, ObstacleConfigMap, NormalizationResult
 #include "map/MapProcessor.hpp"      // Includes Grid_V3
 #include "map/ElevationFetchingCommon.hpp" // Includes ElevationData
 
+namespace app { class ReplanningSession; } // logic/ReplanningSession.hpp
+
 // --- Define Interface Structs HERE ONLY ---
 
+// One intermediate or final route of the anytime planner ("ARA*") for one leg
+struct AnytimeLegSolution {
+    size_t legIndex = 0;            // 0 = start -> first control
+    float epsilon = 1.0f;           // Heuristic inflation it was found with
+    float suboptimalityBound = 1.0f; // cost <= bound * optimal cost (1 = optimal)
+    float cost = 0.0f;
+    double elapsedMs = 0.0;         // Since the leg's search started
+    std::vector<int> pathIndices;   // Leg path only (grid indices)
+};
+
 struct BackendInputParams {
     // File Paths
     std::string mapFilePath;
@@ -25,16 +39,39 @@ struct BackendInputParams {
     int desiredGridHeight = 1000;
     mapgeo::ObstacleConfigMap obstacleCosts;
     unsigned int numThreads = 1;
+    bool useTileBinnedMerge = false; // Deterministic, lock-free grid merge (bit-identical for any thread count)
+    int mergeTileSize = 256;
 
     // Elevation
     double desiredElevationResolution = 90.0;
     std::string pyModuleName = "elevation_logic";
     std::string pyFetchFuncName = "get_elevation_grid";
     std::string pyConvertFuncName = "convert_latlon_to_projected";
+    int flatTerrainMode = 0; // 2D mode (no elevation memory or sampling): 0 = auto (dummy or near-flat elevation), 1 = always (skips the fetch), 2 = never
 
     // Pathfinding
     std::string algorithmName = "Optimized A*";
     int heuristicType = 3; // HEURISTIC_MIN_COST (Assuming PathfindingUtils.hpp defines this)
+    int altLandmarkCount = 8; // Landmarks for HEURISTIC_ALT (A* only): 4 bytes/cell each, tables cached next to the grid
+    int costModel = 0;    // Optimized A* / Dijkstra edge costs: 0 = Tobler, 1 = flat Tobler (elevation ignored), 2 = terrain only (slope ignored)
+    int connectivity = 8; // Optimized A* / Dijkstra moves: 8 = axial + diagonal, 4 = axial only (matrix and field stay 8-connected Tobler)
+    int priorityQueueType = 1; // Open list for A*/Dijkstra: 0 = binary heap, 1 = radix heap (monotone, ~2x faster on large grids)
+    int hpaClusterSize = 16; // HPA* cluster edge in cells: smaller = faster abstraction build, larger = closer to optimal but slower queries
+    bool customizableContraction = true; // Contraction Hierarchy: topology cached per passability, cost changes only re-customize (larger, ~5x slower queries than a CH rebuilt every run)
+    bool parallelSegments = true; // Solve waypoint legs concurrently (one search workspace pair per thread, ~32 bytes/cell per thread)
+    double segmentWorkspaceBudgetMB = 4096.0; // ... with no more threads than fit their workspaces in this budget (serial legs if only one fits)
+    bool computeLegCostMatrix = false; // Also compute the optimal cost between every pair of waypoints (one Dijkstra per waypoint)
+    bool legCostMatrixPaths = false;   // ... and keep the path of every pair (N^2 paths; memory grows with N and leg length)
+    bool computeTravelTimeField = false; // Cost from every cell to the finish (one parallel backward search); also speeds up A* on the last leg
+    std::string travelTimeFieldPath;     // If set, the field is written to <path>.flt/.hdr (ESRI float grid, NODATA = unreachable)
+    float araInitialEpsilon = 3.0f;  // ARA*: heuristic inflation of the first route (larger = faster first route)
+    float araEpsilonStep = 0.5f;     // ARA*: epsilon decrease per refinement
+    double araTimeBudgetMs = 1000.0; // ARA*: per-leg refinement deadline; 0 = refine until optimal
+    std::function<void(const AnytimeLegSolution&)> onAnytimeSolution; // ARA*: called for every route as it is found, before the leg finishes refining (worker threads, possibly concurrently)
+    std::shared_ptr<app::ReplanningSession> replanningSession; // LPA*: session of a previous result; only the changed costs are repaired if map, controls and grid size match
+    int edgeCostCacheMode = 1; // Precomputed Tobler edge costs for A*/Dijkstra: 0 = off, 1 = float32 (exact), 2 = float16 (half memory, rel. error <= 2^-11)
+    bool useCompactGrid = true; // A*/Dijkstra without the edge-cost cache read a palette-coded copy of the grid (1 byte/cell instead of 8; same costs)
+    int searchLayout = 0;       // ... stored as: 0 = row-major, 1 = 8x8 tiles (compact grid, elevation and search state; fewer cache misses on wide grids)
 
     // GPU Parameters
     float gpuDelta = 50.0f;
@@ -44,6 +81,9 @@ struct BackendInputParams {
     float hadsHeuristicWeight = 0.95f;
 
     // Grid Reuse Data
+    bool useGridCache = true;           // Persistent on-disk cache of processed grids (see IO/GridCache.hpp)
+    std::string gridCacheDirectory;     // Empty = gridcache::defaultCacheDirectory()
+    double gridCacheBudgetMB = 4096.0;  // Size limit of the cache directory; least recently used entries are evicted beyond it
     bool reuseGridIfPossible = false;
     std::optional<mapgeo::Grid_V3> existingGrid;
     std::optional<mapgeo::NormalizationResult> existingNormInfo;
@@ -66,6 +106,7 @@ struct BackendResult {
     // Elevation Outputs
     std::optional<ElevationFetcher::ElevationData> elevationDataUsed; // Use correct namespace
     bool usedDummyElevation = true;
+    bool usedFlatTerrain = false; // 2D mode: elevation treated as constant (see BackendInputParams::flatTerrainMode)
     float finalLogicalResolutionMeters = 1.0f;
     float finalOriginOffsetX = 0.0f;
     float finalOriginOffsetY = 0.0f;
@@ -73,6 +114,15 @@ struct BackendResult {
     // Pathfinding Outputs
     std::vector<int> fullPathIndices;
     double pathfindingDurationMs = 0.0;
+    std::vector<float> legCostMatrix;                  // Row-major N x N over the waypoints (start, controls, finish); +inf = unreachable
+    std::vector<std::vector<int>> legCostMatrixPaths;  // Same layout, if requested
+    double legCostMatrixDurationMs = 0.0;
+    std::vector<float> travelTimeField;                // Grid_V3 order, cost to the finish; FLT_MAX = unreachable (if requested)
+    double travelTimeFieldDurationMs = 0.0;
+    std::vector<AnytimeLegSolution> anytimeSolutions;  // ARA*: every published route, in leg order
+    std::shared_ptr<app::ReplanningSession> replanningSession; // LPA*: keeps the search state; pass back in the next run's params
+    size_t replanChangedCells = 0;                     // LPA*: cells whose cost changed since the previous run of the session
+    size_t replanExpandedCells = 0;                    // LPA*: cells expanded by this run (all legs)
     double mapProcessingDurationMs = 0.0;
     double elevationFetchDurationMs = 0.0;
 
@@ -0,0 +1,119 @@
+// include/logic/ReplanningSession.hpp
+#pragma once
+#ifndef APP_REPLANNING_SESSION_HPP
+#define APP_REPLANNING_SESSION_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+#include "map/MapProcessingCommon.h" // Includes GridPoint, ObstacleConfigMap, NormalizationResult
+#include "map/MapProcessor.hpp"      // Includes Grid_V3, MapProcessorConfig
+#include "map/ElevationRaster.hpp"
+#include "algoritms/PathfindingContext.hpp"
+#include "algoritms/LPAStarToblerSampled.hpp"
+#include "map/ElevationFetcherPy.hpp"   // Includes ElevationData (used by BackendResult)
+#include "logic/BackendInterface.hpp"
+
+namespace app {
+
+    // New contents of one grid cell
+    struct CellUpdate {
+        int index = -1;             // Grid_V3 order
+        mapgeo::GridCellData cell;
+    };
+
+    // Outcome of one ReplanningSession::replan()
+    struct ReplanResult {
+        bool success = false;
+        std::string errorMessage;
+        std::vector<int> fullPathIndices;
+        std::vector<float> legCosts;  // Per leg; FLT_MAX = unreachable
+        size_t changedCells = 0;      // Cells changed since the previous replan
+        size_t expandedCells = 0;     // Summed over legs (the first replan is a full search)
+        double durationMs = 0.0;
+    };
+
+    /**
+     * @class ReplanningSession
+     * @brief Keeps the grid, the elevation raster and one LPA* planner per leg alive between runs.
+     *
+     * Cost edits (new obstacle costs, regions marked out of bounds, single cells) are applied to the
+     * session's own grid and forwarded to every planner; replan() then only repairs the part of each
+     * leg's search that depends on the changed cells. Elevation and waypoints are fixed for the
+     * lifetime of the session. Not thread-safe: use one session from one thread at a time.
+     * Memory: the grid and raster copies plus 8 bytes per cell per leg.
+     */
+    class ReplanningSession {
+    public:
+        ReplanningSession(mapgeo::Grid_V3 grid, mapgeo::ElevationRaster elevation, float log_cell_resolution,
+            std::vector<GridPoint> waypoints);
+        // Planners point into the session, so it stays where it was created
+        ReplanningSession(const ReplanningSession&) = delete;
+        ReplanningSession& operator=(const ReplanningSession&) = delete;
+
+        /**
+         * @brief Where the grid came from; needed by updateObstacleCosts() and matches().
+         * @param sourceKey gridcache::computeSourceKey() of the files and settings the session was built from.
+         */
+        void setSource(const std::string& mapFilePath, const std::string& controlsFilePath, const mapgeo::MapProcessorConfig& processorConfig,
+            std::uint64_t sourceKey);
+
+        /** @brief Non-path outputs of the run that created the session, echoed by runs that reuse it. */
+        void setRunInfo(BackendResult runInfo);
+        const BackendResult& runInfo() const { return run_info_; }
+
+        /**
+         * @brief True if a run with these inputs can reuse the session: same map and controls paths, grid size
+         *        and source key (so neither file was edited and no setting outside the obstacle costs changed).
+         */
+        bool matches(const std::string& mapFilePath, const std::string& controlsFilePath, int gridWidth, int gridHeight,
+            std::uint64_t sourceKey) const;
+
+        /** @brief Applies cell edits; returns how many cells actually changed. */
+        size_t updateCells(const std::vector<CellUpdate>& updates);
+
+        /** @brief Replaces the grid by one of the same size, forwarding only the cells that differ. */
+        size_t updateGrid(const mapgeo::Grid_V3& newGrid);
+
+        /** @brief Flags the inclusive, clamped rectangle impassable. */
+        size_t markRegionImpassable(int x0, int y0, int x1, int y1);
+
+        /**
+         * @brief Regenerates the grid with the given obstacle costs and forwards the difference.
+         * The map is parsed on first use and kept, so later calls only rasterize. Always rasterizes:
+         * the session's grid may come from a reused grid whose costs are not known.
+         * @throws std::runtime_error if setSource() was not called or the map cannot be loaded/rasterized.
+         */
+        size_t updateObstacleCosts(const mapgeo::ObstacleConfigMap& obstacleCosts);
+
+        /** @brief Brings every leg up to date with the edits so far (legs in parallel) and stitches them. */
+        ReplanResult replan();
+
+        const mapgeo::Grid_V3& grid() const { return grid_; }
+        const std::vector<GridPoint>& waypoints() const { return waypoints_; }
+        size_t memoryBytes() const;
+
+    private:
+        void notifyAll(int idx);
+
+        mapgeo::Grid_V3 grid_;
+        mapgeo::ElevationRaster elevation_;
+        Pathfinding::PathfindingContext context_; // Points at grid_ and elevation_
+        std::vector<GridPoint> waypoints_;
+        std::vector<Pathfinding::LPAStarPlanner> planners_; // One per leg
+        size_t pending_changes_ = 0;
+
+        std::string map_file_path_;
+        std::string controls_file_path_;
+        mapgeo::MapProcessorConfig processor_config_;
+        std::uint64_t source_key_ = 0;
+        std::unique_ptr<mapgeo::MapProcessor> processor_; // Loaded on first updateObstacleCosts()
+        BackendResult run_info_;
+    };
+
+} // namespace app
+
+#endif // APP_REPLANNING_SESSION_HPP
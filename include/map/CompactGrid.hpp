@@ -0,0 +1,86 @@
+// File: CompactGrid.hpp
+#ifndef COMPACT_GRID_HPP
+#define COMPACT_GRID_HPP
+
+#include "map/MapProcessingCommon.h" // For Grid_V3, GridCellData
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace mapgeo {
+
+    /**
+     * @brief Non-owning view of a CompactGrid with 1-byte codes, as read by the planners' kernels.
+     * terrain has 256 entries: the value of each passable code and 0 for impassable ones (value <= 0,
+     * FLAG_IMPASSABLE, or unused codes), so a passability test is one table load and a compare.
+     */
+    struct CompactGridView {
+        const std::uint8_t* codes = nullptr; // Row-major, one per cell
+        const float* terrain = nullptr;
+        int width = 0;
+        int height = 0;
+
+        /** @brief Terrain multiplier of cell idx, 0 if impassable (no bounds check). */
+        float terrainAt(int idx) const { return terrain[codes[idx]]; }
+        bool passable(int idx) const { return terrainAt(idx) > 0.0f; }
+    };
+
+    /**
+     * @class CompactGrid
+     * @brief Palette-coded copy of a Grid_V3: one code per cell instead of an 8-byte GridCellData.
+     *
+     * Every distinct (value, flags) pair of the grid gets a palette entry; cells store its index,
+     * 1 byte for up to 256 distinct pairs (8x smaller; maps built from the obstacle rules have a few
+     * dozen) and 2 bytes for up to 65536 (4x). Values are compared bit for bit, so cellAt() and
+     * toGrid() give back exactly the cells of the source grid. Grids with more distinct cells are
+     * not compacted (isValid() is false).
+     *
+     * Beside the palette, each code maps to its terrain multiplier with impassable codes at 0, which
+     * folds the planners' "value <= 0 || FLAG_IMPASSABLE" test into the cost lookup.
+     */
+    class CompactGrid {
+    public:
+        static constexpr std::size_t NARROW_PALETTE_LIMIT = 256;
+        static constexpr std::size_t WIDE_PALETTE_LIMIT = 65536;
+
+        CompactGrid() = default;
+
+        /** @brief Encodes grid (palette pass, then parallel over rows). Invalid if the grid is or has too many distinct cells. */
+        static CompactGrid fromGrid(const Grid_V3& grid);
+
+        bool isValid() const { return width_ > 0 && height_ > 0 && !palette_.empty(); }
+        std::size_t width() const { return width_; }
+        std::size_t height() const { return height_; }
+        std::size_t paletteSize() const { return palette_.size(); }
+        /** @brief True if codes are 1 byte (view() is available). */
+        bool isNarrow() const { return !palette_.empty() && palette_.size() <= NARROW_PALETTE_LIMIT; }
+        std::size_t memoryBytes() const;
+
+        /** @brief Code of the cell with row-major index idx (no bounds check). */
+        std::uint16_t codeAt(std::size_t idx) const { return isNarrow() ? narrow_codes_[idx] : wide_codes_[idx]; }
+        /** @brief The exact source cell (no bounds check). */
+        const GridCellData& cellAt(std::size_t idx) const { return palette_[codeAt(idx)]; }
+        /** @brief Terrain multiplier of cell idx, 0 if impassable (no bounds check). */
+        float terrainAt(std::size_t idx) const { return terrain_[codeAt(idx)]; }
+        bool passable(std::size_t idx) const { return terrainAt(idx) > 0.0f; }
+
+        /** @brief Decodes back to a Grid_V3 identical to the source. */
+        Grid_V3 toGrid() const;
+
+        /** @brief Zero-copy view for the planners. Requires isNarrow(). */
+        CompactGridView view() const;
+
+        const std::vector<GridCellData>& palette() const { return palette_; }
+
+    private:
+        std::size_t width_ = 0;
+        std::size_t height_ = 0;
+        std::vector<GridCellData> palette_;
+        std::vector<float> terrain_;               // Per code; NARROW_PALETTE_LIMIT entries when narrow so any byte is a valid index
+        std::vector<std::uint8_t> narrow_codes_;   // Used if palette_.size() <= NARROW_PALETTE_LIMIT
+        std::vector<std::uint16_t> wide_codes_;    // Otherwise
+    };
+
+} // namespace mapgeo
+
+#endif // COMPACT_GRID_HPP
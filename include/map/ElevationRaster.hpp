@@ -0,0 +1,71 @@
+// File: ElevationRaster.hpp
+#ifndef ELEVATION_RASTER_HPP
+#define ELEVATION_RASTER_HPP
+
+#include "map/ElevationSampler.hpp"
+#include <vector>
+#include <cstddef>
+
+namespace mapgeo {
+
+    /**
+     * @class ElevationRaster
+     * @brief Elevation resampled onto the logical grid: one value per logical cell centre.
+     *
+     * Built once per grid/elevation pair (see PathfindingLogic) and shared read-only by all
+     * CPU pathfinding algorithms, so no algorithm has to resample the elevation grid per call.
+     * Cell (x, y) holds the elevation at logical world position ((x + 0.5) * res, (y + 0.5) * res),
+     * sampled through ElevationSampler (which applies the elevation origin offset).
+     */
+    class ElevationRaster {
+    public:
+        ElevationRaster() = default;
+
+        /**
+         * @brief Wraps already resampled values.
+         * @throws std::invalid_argument If values.size() != width * height.
+         */
+        ElevationRaster(std::size_t width, std::size_t height, float cell_resolution, std::vector<float> values);
+
+        /**
+         * @brief Samples every logical cell centre (parallel over rows).
+         * @param sampler Sampler over the source elevation grid.
+         * @param width Logical grid width.
+         * @param height Logical grid height.
+         * @param log_cell_resolution Real-world size of one logical cell edge (metres).
+         */
+        static ElevationRaster fromSampler(const ElevationSampler& sampler, std::size_t width, std::size_t height, float log_cell_resolution);
+
+        /**
+         * @brief Raster of one elevation everywhere (flat terrain, "2D mode").
+         * Stores a single value, so it costs no per-cell memory and needs no sampling.
+         */
+        static ElevationRaster constant(std::size_t width, std::size_t height, float cell_resolution, float elevation);
+
+        bool isValid() const { return width_ > 0 && height_ > 0 && values_.size() == (isConstant() ? 1 : width_ * height_); }
+        std::size_t width() const { return width_; }
+        std::size_t height() const { return height_; }
+        float cellResolution() const { return cell_resolution_; }
+        /** @brief True for a raster made by constant(): every cell has the same elevation. */
+        bool isConstant() const { return index_mask_ == 0; }
+        std::size_t memoryBytes() const { return values_.capacity() * sizeof(float); }
+
+        /** @brief Elevation of the cell with row-major index idx (no bounds check). */
+        float atIndex(int idx) const { return values_[static_cast<std::size_t>(idx) & index_mask_]; }
+        /** @brief Elevation of cell (x, y) (no bounds check). */
+        float at(int x, int y) const { return values_[(static_cast<std::size_t>(y) * width_ + static_cast<std::size_t>(x)) & index_mask_]; }
+
+        /** @brief Row-major values (a single value if isConstant()). */
+        const std::vector<float>& values() const { return values_; }
+
+    private:
+        std::size_t width_ = 0;
+        std::size_t height_ = 0;
+        float cell_resolution_ = 1.0f;
+        std::vector<float> values_;
+        std::size_t index_mask_ = ~std::size_t(0); // 0 for a constant raster: every index reads values_[0]
+    };
+
+} // namespace mapgeo
+
+#endif // ELEVATION_RASTER_HPP
@@ -0,0 +1,83 @@
+// File: GridLayout.hpp
+#ifndef GRID_LAYOUT_HPP
+#define GRID_LAYOUT_HPP
+
+#include "map/PathfindingUtils.hpp" // For toIndex, toCoords
+#include <vector>
+#include <cstddef>
+
+namespace mapgeo {
+
+    /**
+     * Cell-index layouts of per-cell storage, used by the A* and Dijkstra kernels in place of
+     * PathfindingUtils::toIndex/toCoords. A layout maps (x, y) to a storage index and back; the
+     * search state, terrain and elevation a kernel reads are all stored in the same layout, while
+     * paths, heuristics and everything outside the kernels stay row-major.
+     */
+
+    /** @brief Grid_V3 order: index = y * width + x. */
+    struct RowMajorLayout {
+        int width = 0;
+        int height = 0;
+
+        int toIndex(int x, int y) const { return PathfindingUtils::toIndex(x, y, width); }
+        void toCoords(int idx, int& x, int& y) const { PathfindingUtils::toCoords(idx, width, x, y); }
+        std::size_t storageSize() const { return static_cast<std::size_t>(width) * static_cast<std::size_t>(height); }
+    };
+
+    /**
+     * @brief 8x8 tiles in row-major tile order, row-major cells inside a tile.
+     *
+     * All 8 neighbours of a cell lie in at most 4 tiles (mostly 1), and a tile of 1-byte codes is
+     * one cache line, so an expansion touches a few lines instead of three grid rows that are a
+     * row apart, which on wide grids also means three pages. Storage is padded to whole tiles.
+     */
+    struct TiledLayout {
+        static constexpr int TILE_SHIFT = 3;
+        static constexpr int TILE_SIZE = 1 << TILE_SHIFT;
+        static constexpr int TILE_MASK = TILE_SIZE - 1;
+        static constexpr int TILE_CELLS = TILE_SIZE * TILE_SIZE;
+
+        int width = 0;
+        int height = 0;
+        int tiles_x = 0;
+        int tiles_y = 0;
+
+        TiledLayout() = default;
+        TiledLayout(int w, int h)
+            : width(w), height(h), tiles_x((w + TILE_MASK) >> TILE_SHIFT), tiles_y((h + TILE_MASK) >> TILE_SHIFT) {}
+
+        int toIndex(int x, int y) const {
+            const int tile = (y >> TILE_SHIFT) * tiles_x + (x >> TILE_SHIFT);
+            return (tile << (2 * TILE_SHIFT)) | ((y & TILE_MASK) << TILE_SHIFT) | (x & TILE_MASK);
+        }
+        void toCoords(int idx, int& x, int& y) const {
+            const int tile = idx >> (2 * TILE_SHIFT);
+            const int tile_y = tile / tiles_x;
+            x = ((tile - tile_y * tiles_x) << TILE_SHIFT) | (idx & TILE_MASK);
+            y = (tile_y << TILE_SHIFT) | ((idx >> TILE_SHIFT) & TILE_MASK);
+        }
+        std::size_t storageSize() const { return static_cast<std::size_t>(tiles_x) * static_cast<std::size_t>(tiles_y) * TILE_CELLS; }
+    };
+
+    /**
+     * @brief Copies row-major values (width x height) into layout order; padding cells get fill.
+     * Parallel over tile rows.
+     */
+    template <typename T>
+    std::vector<T> toTiledOrder(const T* row_major, const TiledLayout& layout, T fill) {
+        std::vector<T> tiled(layout.storageSize(), fill);
+#pragma omp parallel for schedule(static)
+        for (int tile_row = 0; tile_row < layout.tiles_y; ++tile_row) {
+            const int y_end = (tile_row + 1) * TiledLayout::TILE_SIZE < layout.height ? (tile_row + 1) * TiledLayout::TILE_SIZE : layout.height;
+            for (int y = tile_row * TiledLayout::TILE_SIZE; y < y_end; ++y) {
+                const T* row = row_major + static_cast<std::size_t>(y) * static_cast<std::size_t>(layout.width);
+                for (int x = 0; x < layout.width; ++x) { tiled[static_cast<std::size_t>(layout.toIndex(x, y))] = row[x]; }
+            }
+        }
+        return tiled;
+    }
+
+} // namespace mapgeo
+
+#endif // GRID_LAYOUT_HPP
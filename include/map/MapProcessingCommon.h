@@ -90,6 +90,44 @@ namespace mapgeo { // Namespace for all map processing related code
         };
     };
 
+    /**
+     * @brief A horizontal run of grid cells on row y covering columns [x_begin, x_end).
+     *        Used to represent rasterized coverage compactly (one entry per run instead of per cell).
+     */
+    struct RowSpan {
+        int y = 0;
+        int x_begin = 0; // Inclusive
+        int x_end = 0;   // Exclusive
+
+        std::size_t length() const { return x_end > x_begin ? static_cast<std::size_t>(x_end - x_begin) : 0; }
+
+        // Row-major ordering, matching IntPoint
+        bool operator<(const RowSpan& other) const {
+            return y < other.y || (y == other.y && x_begin < other.x_begin);
+        }
+    };
+
+    /**
+     * @brief Sorts spans and merges overlapping or touching runs on the same row in place.
+     *        Empty spans are dropped.
+     */
+    inline void normalizeRowSpans(std::vector<RowSpan>& spans) {
+        spans.erase(std::remove_if(spans.begin(), spans.end(), [](const RowSpan& s) { return s.x_end <= s.x_begin; }), spans.end());
+        if (spans.size() < 2) return;
+        if (!std::is_sorted(spans.begin(), spans.end())) std::sort(spans.begin(), spans.end());
+        std::size_t out = 0;
+        for (std::size_t i = 1; i < spans.size(); ++i) {
+            RowSpan& last = spans[out];
+            if (spans[i].y == last.y && spans[i].x_begin <= last.x_end) {
+                last.x_end = std::max(last.x_end, spans[i].x_end);
+            }
+            else {
+                spans[++out] = spans[i];
+            }
+        }
+        spans.resize(out + 1);
+    }
+
     // =================== GRID CELL & GRID STRUCTURES ===================
 
     /**
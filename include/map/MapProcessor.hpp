@@ -26,6 +26,8 @@ namespace mapgeo {
         int grid_width = 100;
         int grid_height = 100;
         std::vector<std::string> layers_to_process = { "barrier" };
+        bool use_tile_binned_merge = false; // Lock-free, deterministic Pass 1/Pass 2 merge (see TileBinning.hpp)
+        int merge_tile_size = 256;          // Tile edge length in cells for the tile-binned merge (clamped to 16..1024)
     };
 
     struct PointXY { double x = 0.0, y = 0.0; };
@@ -9,6 +9,7 @@
 
 #include "MapProcessingCommon.h" // Include common definitions
 #include <vector>
+#include <cstddef>
 #include <omp.h>                 // Include OpenMP header for parallel processing directives
 
 namespace mapgeo {
@@ -35,11 +36,20 @@ namespace mapgeo {
      *        Processes polygon/line boundaries in parallel using OpenMP to establish
      *        initial boundary values (impassable or feature base terrain cost) on the grid.
      *        This pass only sets the FLAG_BOUNDARY flag.
+     *        By default results are merged under a critical section; with a non-zero
+     *        merge tile size the grid is partitioned into tiles owned by single workers
+     *        (see TileBinning.hpp), which is lock-free and deterministic.
      */
     class ParallelPolygonProcessorFlags {
     public:
         ParallelPolygonProcessorFlags() = default;
 
+        /**
+         * @brief Constructs the processor with an explicit merge mode.
+         * @param mergeTileSize Tile edge length for the tile-binned merge; 0 keeps the critical-section merge.
+         */
+        explicit ParallelPolygonProcessorFlags(std::size_t mergeTileSize) : merge_tile_size_(mergeTileSize) {}
+
         // Disable copy/move constructors and assignments (not needed, avoids accidental copies)
         ParallelPolygonProcessorFlags(const ParallelPolygonProcessorFlags&) = delete;
         ParallelPolygonProcessorFlags& operator=(const ParallelPolygonProcessorFlags&) = delete;
@@ -52,6 +62,9 @@ namespace mapgeo {
          * @param polygonDataList A list of PolygonInputData representing features to process.
          */
         void process(Grid_V3& finalGrid, const std::vector<PolygonInputData>& polygonDataList) const;
+
+    private:
+        std::size_t merge_tile_size_ = 0; // 0 = critical-section merge, otherwise tile-binned merge
     };
 
 } // namespace mapgeo
@@ -38,6 +38,7 @@ namespace PathfindingUtils {
         1.0f, 1.0f, 1.0f, 1.0f,
         1.41421356f, 1.41421356f, 1.41421356f, 1.41421356f
     };
+    inline constexpr int reverse_dir[NUM_DIRECTIONS] = { 2, 3, 0, 1, 6, 7, 4, 5 }; // Index of the opposite direction
     inline constexpr float EPSILON = 1e-6f; // Small value for float checks
     // Maximum Tobler time penalty: caps extreme slopes so they are costly but not impassable
     inline constexpr float MAX_TOBLER_PENALTY = 1000.0f;
@@ -46,6 +47,7 @@ namespace PathfindingUtils {
     inline constexpr int HEURISTIC_DIAGONAL = 1;
     inline constexpr int HEURISTIC_MANHATTAN = 2;
     inline constexpr int HEURISTIC_MIN_COST = 3; // Scaled Diagonal by min combined cost factor
+    inline constexpr int HEURISTIC_ALT = 4;      // Landmark bounds (needs PathfindingContext::landmarks; A* only, Euclidean otherwise)
 
     // --- Internal Heuristic Implementations ---
     namespace internal {
@@ -104,7 +106,10 @@ namespace PathfindingUtils {
     }
 
     /**
-     * @brief Shared Tobler edge-cost calculation used by all CPU pathfinding algorithms.
+     * @brief Reference Tobler edge-cost calculation (std::exp).
+     *
+     * The CPU planners evaluate the same function through the polynomial-exp kernel in
+     * algoritms/ToblerKernel.hpp (toblerStepCost / toblerEdgeCosts8), which is checked against this one.
      *
      * Returns the movement cost from a cell to a neighbor in the given direction using
      * the Tobler hiking function. Extreme slopes are capped at MAX_TOBLER_PENALTY rather
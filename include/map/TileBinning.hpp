@@ -0,0 +1,194 @@
+/**
+ * @file TileBinning.hpp
+ * @brief Tile-partitioned, lock-free merge used by Pass 1 and Pass 2 grid updates.
+ *
+ * Features are rasterized in parallel into per-feature cell (or row-span) lists, those are
+ * binned into fixed square tiles, and each tile is then owned by exactly one worker
+ * which applies the features touching it in ascending feature order. Because every
+ * cell belongs to one tile and every tile sees its features in input order, the
+ * resulting grid is bit-identical to applying the features serially, independent
+ * of the thread count.
+ */
+#ifndef TILE_BINNING_HPP
+#define TILE_BINNING_HPP
+
+#include "MapProcessingCommon.h" // For IntPoint, RowSpan
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+#include <omp.h>
+
+namespace mapgeo {
+
+    /** @brief Default tile edge length (cells) for the tile-binned merge mode. */
+    constexpr std::size_t DEFAULT_MERGE_TILE_SIZE = 256;
+
+    /** @brief Accepted tile edge lengths; smaller tiles multiply the bins, larger ones serialize the merge. */
+    constexpr std::size_t MIN_MERGE_TILE_SIZE = 16;
+    constexpr std::size_t MAX_MERGE_TILE_SIZE = 1024;
+
+    /** @brief Number of features rasterized and merged per batch; bounds the buffered cell lists. */
+    constexpr std::size_t TILE_MERGE_BATCH_SIZE = 1024;
+
+    /**
+     * @brief Fixed square tile partition of a grid.
+     *        The tile size is clamped to [MIN_MERGE_TILE_SIZE, MAX_MERGE_TILE_SIZE] (0 = default) and
+     *        rounded up to a power of two so cell->tile mapping is a shift.
+     */
+    struct TileLayout {
+        std::size_t tile_shift = 8;
+        std::size_t tiles_x = 0;
+        std::size_t tiles_y = 0;
+
+        TileLayout(std::size_t grid_width, std::size_t grid_height, std::size_t tile_size) {
+            if (tile_size == 0) tile_size = DEFAULT_MERGE_TILE_SIZE;
+            tile_size = std::min(std::max(tile_size, MIN_MERGE_TILE_SIZE), MAX_MERGE_TILE_SIZE);
+            tile_shift = 0;
+            while ((std::size_t(1) << tile_shift) < tile_size) ++tile_shift;
+            const std::size_t edge = std::size_t(1) << tile_shift;
+            tiles_x = (grid_width + edge - 1) / edge;
+            tiles_y = (grid_height + edge - 1) / edge;
+        }
+
+        std::size_t tileSize() const { return std::size_t(1) << tile_shift; }
+        std::size_t tileCount() const { return tiles_x * tiles_y; }
+
+        /** @brief Tile index of an in-bounds cell. */
+        std::size_t tileOf(const IntPoint& p) const {
+            return (static_cast<std::size_t>(p.y) >> tile_shift) * tiles_x + (static_cast<std::size_t>(p.x) >> tile_shift);
+        }
+
+        /** @brief Tile index of a span's first cell (spans are split so they never cross tiles). */
+        std::size_t tileOf(const RowSpan& s) const {
+            return (static_cast<std::size_t>(s.y) >> tile_shift) * tiles_x + (static_cast<std::size_t>(s.x_begin) >> tile_shift);
+        }
+    };
+
+    /**
+     * @brief The cells (IntPoint) or row spans (RowSpan) covered by one feature, cut into tile runs.
+     *        `items` is in rasterization order; `tile_runs` holds (tile, begin offset) pairs of maximal
+     *        same-tile runs, each run ending where the next one begins (or at items.size()).
+     */
+    template <typename Item>
+    struct TileBinnedItems {
+        std::vector<Item> items;
+        std::vector<std::pair<std::size_t, std::size_t>> tile_runs;
+
+        void clear() { items.clear(); tile_runs.clear(); }
+
+        std::size_t runEnd(std::size_t run) const {
+            return (run + 1 < tile_runs.size()) ? tile_runs[run + 1].second : items.size();
+        }
+    };
+
+    /** @brief Cells never straddle tiles; nothing to split. */
+    inline void splitAtTileColumns(const TileLayout&, std::vector<IntPoint>&) {}
+
+    /** @brief Splits spans that cross a tile column boundary so every span lies in exactly one tile. */
+    inline void splitAtTileColumns(const TileLayout& layout, std::vector<RowSpan>& spans) {
+        auto crosses = [&](const RowSpan& s) {
+            return (static_cast<std::size_t>(s.x_begin) >> layout.tile_shift) != (static_cast<std::size_t>(s.x_end - 1) >> layout.tile_shift);
+        };
+        if (std::none_of(spans.begin(), spans.end(), crosses)) return;
+
+        const int edge = static_cast<int>(layout.tileSize());
+        std::vector<RowSpan> split;
+        split.reserve(spans.size() * 2);
+        for (const RowSpan& s : spans) {
+            int x = s.x_begin;
+            while (x < s.x_end) {
+                const int tile_end = std::min(s.x_end, (x / edge + 1) * edge);
+                split.push_back({ s.y, x, tile_end });
+                x = tile_end;
+            }
+        }
+        spans.swap(split);
+    }
+
+    /**
+     * @brief Cuts `binned.items` into runs of consecutive items in one tile and fills `binned.tile_runs`.
+     *        Items keep their rasterization order, which already keeps neighbouring cells together, so
+     *        this is one linear pass instead of a sort by tile. A feature that leaves a tile and comes
+     *        back gets several runs for that tile; they are applied in order like any other run.
+     */
+    template <typename Item>
+    void binItemsByTile(const TileLayout& layout, TileBinnedItems<Item>& binned) {
+        binned.tile_runs.clear();
+        auto& items = binned.items;
+        if (items.empty()) return;
+        splitAtTileColumns(layout, items);
+
+        std::size_t current_tile = layout.tileOf(items.front());
+        binned.tile_runs.emplace_back(current_tile, 0);
+        for (std::size_t i = 1; i < items.size(); ++i) {
+            const std::size_t t = layout.tileOf(items[i]);
+            if (t != current_tile) {
+                binned.tile_runs.emplace_back(t, i);
+                current_tile = t;
+            }
+        }
+    }
+
+    /**
+     * @brief Runs a deterministic, lock-free rasterize-and-merge over `num_features` features.
+     * @tparam Item IntPoint (single cells) or RowSpan (horizontal runs).
+     * @param layout Tile partition of the target grid.
+     * @param num_features Number of features; they are applied in ascending index order per tile.
+     * @param rasterize Callable `void(std::size_t feature_idx, std::vector<Item>& out_items)`.
+     *        Called concurrently from several threads; must only produce in-bounds items.
+     * @param apply Callable `void(std::size_t feature_idx, const Item* first, const Item* last)`.
+     *        Called concurrently for different tiles; all items passed in one call lie in the same tile.
+     *        May be called several times for one feature and tile; the calls keep the feature's item order.
+     */
+    template <typename Item, typename RasterizeFn, typename ApplyFn>
+    void runTileBinnedMerge(const TileLayout& layout, std::size_t num_features, RasterizeFn&& rasterize, ApplyFn&& apply) {
+        if (num_features == 0 || layout.tileCount() == 0) return;
+
+        std::vector<TileBinnedItems<Item>> batch;
+        // Per tile: (feature offset in batch, run index) in ascending feature order
+        std::vector<std::vector<std::pair<std::uint32_t, std::uint32_t>>> bins(layout.tileCount());
+        // Tiles with a non-empty bin in the current batch, so clearing and applying skip untouched tiles
+        std::vector<std::size_t> active_tiles;
+
+        for (std::size_t batch_begin = 0; batch_begin < num_features; batch_begin += TILE_MERGE_BATCH_SIZE) {
+            const std::size_t batch_count = std::min(TILE_MERGE_BATCH_SIZE, num_features - batch_begin);
+            batch.resize(batch_count);
+
+            // --- Rasterize the batch (independent per feature) ---
+#pragma omp parallel for schedule(dynamic)
+            for (long long k = 0; k < static_cast<long long>(batch_count); ++k) {
+                TileBinnedItems<Item>& binned = batch[k];
+                binned.clear();
+                rasterize(batch_begin + static_cast<std::size_t>(k), binned.items);
+                binItemsByTile(layout, binned);
+            }
+
+            // --- Bin runs by tile; serial so each bin stays in feature order ---
+            for (const std::size_t t : active_tiles) bins[t].clear();
+            active_tiles.clear();
+            for (std::size_t k = 0; k < batch_count; ++k) {
+                const auto& runs = batch[k].tile_runs;
+                for (std::size_t r = 0; r < runs.size(); ++r) {
+                    auto& bin = bins[runs[r].first];
+                    if (bin.empty()) active_tiles.push_back(runs[r].first);
+                    bin.emplace_back(static_cast<std::uint32_t>(k), static_cast<std::uint32_t>(r));
+                }
+            }
+
+            // --- Apply: each tile is owned by exactly one thread, no locking needed ---
+#pragma omp parallel for schedule(dynamic)
+            for (long long a = 0; a < static_cast<long long>(active_tiles.size()); ++a) {
+                for (const auto& entry : bins[active_tiles[a]]) {
+                    const TileBinnedItems<Item>& binned = batch[entry.first];
+                    const Item* items = binned.items.data();
+                    apply(batch_begin + entry.first, items + binned.tile_runs[entry.second].second, items + binned.runEnd(entry.second));
+                }
+            }
+        }
+    }
+
+} // namespace mapgeo
+#endif // TILE_BINNING_HPP
@@ -0,0 +1,59 @@
+// File: TiledGrid.hpp
+#ifndef TILED_GRID_HPP
+#define TILED_GRID_HPP
+
+#include "map/GridLayout.hpp"     // For TiledLayout
+#include "map/CompactGrid.hpp"    // For CompactGrid
+#include "map/ElevationRaster.hpp"
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace mapgeo {
+
+    /** @brief Non-owning view of a TiledGrid; every index is a TiledLayout index. */
+    struct TiledGridView {
+        TiledLayout layout;
+        const std::uint8_t* codes = nullptr;  // Compact-grid codes in tile order
+        const float* terrain = nullptr;       // Per code, 0 = impassable (see CompactGridView)
+        const float* elevation = nullptr;     // In tile order (a single value if elevation_mask is 0)
+        std::size_t elevation_mask = 0;
+
+        float terrainAt(int idx) const { return terrain[codes[idx]]; }
+        float elevationAt(int idx) const { return elevation[static_cast<std::size_t>(idx) & elevation_mask]; }
+    };
+
+    /**
+     * @class TiledGrid
+     * @brief Tile-ordered (TiledLayout) copies of a compact grid and its elevation raster, read by the
+     *        A* and Dijkstra kernels together with a search workspace indexed the same way.
+     *
+     * Built once per grid like the compact grid it copies; a constant raster stays a single value.
+     */
+    class TiledGrid {
+    public:
+        TiledGrid() = default;
+
+        /** @brief Reorders compact (1-byte codes required) and elevation (may be null if only elevation-free cost models run). */
+        static TiledGrid build(const CompactGrid& compact, const ElevationRaster* elevation);
+
+        bool isValid() const { return layout_.width > 0 && layout_.height > 0 && codes_.size() == layout_.storageSize(); }
+        bool hasElevation() const { return !elevation_.empty(); }
+        std::size_t width() const { return static_cast<std::size_t>(layout_.width); }
+        std::size_t height() const { return static_cast<std::size_t>(layout_.height); }
+        const TiledLayout& layout() const { return layout_; }
+        std::size_t memoryBytes() const;
+
+        TiledGridView view() const;
+
+    private:
+        TiledLayout layout_;
+        std::vector<std::uint8_t> codes_;
+        std::vector<float> terrain_;
+        std::vector<float> elevation_;
+        std::size_t elevation_mask_ = ~std::size_t(0); // 0 for a constant raster
+    };
+
+} // namespace mapgeo
+
+#endif // TILED_GRID_HPP
@@ -0,0 +1,844 @@
+// File: GridCache.cpp
+#include "IO/GridCache.hpp"
+#include "algoritms/LandmarkHeuristic.hpp"
+#include "algoritms/ContractionHierarchy.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gridcache {
+
+    namespace {
+
+        constexpr char GRID_CACHE_MAGIC[8] = { 'O', 'M', 'A', 'P', 'G', 'R', 'D', '\0' };
+        constexpr char LANDMARK_CACHE_MAGIC[8] = { 'O', 'M', 'A', 'P', 'A', 'L', 'T', '\0' };
+        constexpr char CONTRACTION_CACHE_MAGIC[8] = { 'O', 'M', 'A', 'P', 'C', 'C', 'H', '\0' };
+        constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+        constexpr std::uint64_t FNV_PRIME = 1099511628211ull;
+
+        /**
+         * @brief Fixed-size file header. All fields are naturally aligned so the
+         *        struct has no padding and can be copied to/from disk directly.
+         */
+        struct FileHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t header_size;
+            std::uint64_t key;
+            std::uint64_t width;
+            std::uint64_t height;
+            double min_x;
+            double min_y;
+            double scale_x;
+            double scale_y;
+            double resolution_x;
+            double resolution_y;
+            std::uint32_t norm_valid;
+            std::uint32_t reserved;
+            std::uint64_t payload_size; // Bytes following the header: values plane + flags plane
+            std::uint64_t checksum;     // Over header (with this field zeroed) and payload
+        };
+        static_assert(sizeof(FileHeader) == 112, "GridCache FileHeader must not contain padding");
+
+        /**
+         * @brief Header of a landmark-table entry. Payload: landmark cells (int32),
+         *        then scales (float, 2 per landmark), then the uint16 distance table.
+         */
+        struct LandmarkFileHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t header_size;
+            std::uint64_t key;
+            std::uint64_t width;
+            std::uint64_t height;
+            std::uint32_t landmark_count;
+            std::uint32_t reserved;
+            std::uint64_t payload_size;
+            std::uint64_t checksum;     // Over header (with this field zeroed) and payload
+        };
+        static_assert(sizeof(LandmarkFileHeader) == 64, "GridCache LandmarkFileHeader must not contain padding");
+
+        /**
+         * @brief Header of a contraction-hierarchy entry. Payload: ranks (int32 per cell), up offsets
+         *        (uint64, cells + 1), up arcs, down offsets, down arcs (arc_count arcs each).
+         */
+        struct ContractionFileHeader {
+            char magic[8];
+            std::uint32_t version;
+            std::uint32_t header_size;
+            std::uint64_t key;
+            std::uint64_t width;
+            std::uint64_t height;
+            std::uint32_t rounds;
+            std::uint32_t reserved;
+            std::uint64_t shortcut_count;
+            std::uint64_t arc_count;    // Per direction
+            std::uint64_t payload_size;
+            std::uint64_t checksum;     // Over header (with this field zeroed) and payload
+        };
+        static_assert(sizeof(ContractionFileHeader) == 80, "GridCache ContractionFileHeader must not contain padding");
+        static_assert(sizeof(Pathfinding::ContractionHierarchy::Arc) == 12 && std::is_trivially_copyable<Pathfinding::ContractionHierarchy::Arc>::value,
+            "ContractionHierarchy::Arc is stored as raw bytes");
+
+        // Incremental FNV-1a over bytes (used for the cache key).
+        inline void fnv1a(std::uint64_t& h, const void* data, std::size_t size) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (std::size_t i = 0; i < size; ++i) {
+                h ^= p[i];
+                h *= FNV_PRIME;
+            }
+        }
+
+        template <typename T>
+        inline void fnv1aValue(std::uint64_t& h, const T& value) {
+            fnv1a(h, &value, sizeof(T));
+        }
+
+        inline void fnv1aString(std::uint64_t& h, const std::string& s) {
+            fnv1aValue(h, static_cast<std::uint64_t>(s.size())); // Length prefix keeps ("ab","c") != ("a","bc")
+            fnv1a(h, s.data(), s.size());
+        }
+
+        // Hashes a file's contents (not path or mtime). Returns the byte count, std::nullopt if it cannot be read.
+        std::optional<std::uint64_t> fnv1aFile(std::uint64_t& h, const std::string& path) {
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                std::cerr << "Error (GridCache): Cannot open file for hashing: " << path << std::endl;
+                return std::nullopt;
+            }
+            std::vector<char> buffer(1 << 16);
+            std::uint64_t total = 0;
+            while (in) {
+                in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                const std::streamsize got = in.gcount();
+                if (got > 0) {
+                    fnv1a(h, buffer.data(), static_cast<std::size_t>(got));
+                    total += static_cast<std::uint64_t>(got);
+                }
+            }
+            if (in.bad()) {
+                std::cerr << "Error (GridCache): Failed reading file for hashing: " << path << std::endl;
+                return std::nullopt;
+            }
+            return total;
+        }
+
+        // FNV-style checksum processing 8 bytes per step; only guards against corruption, not collisions.
+        inline void checksum64(std::uint64_t& h, const void* data, std::size_t size) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            std::size_t i = 0;
+            for (; i + sizeof(std::uint64_t) <= size; i += sizeof(std::uint64_t)) {
+                std::uint64_t word;
+                std::memcpy(&word, p + i, sizeof(word));
+                h ^= word;
+                h *= FNV_PRIME;
+            }
+            fnv1a(h, p + i, size - i);
+        }
+
+        std::uint64_t computeChecksum(FileHeader header, const unsigned char* payload, std::size_t payload_size) {
+            header.checksum = 0;
+            std::uint64_t h = FNV_OFFSET_BASIS;
+            checksum64(h, &header, sizeof(header));
+            checksum64(h, payload, payload_size);
+            return h;
+        }
+
+        /** @brief Checksum over a header (checksum field zeroed) and a payload given as consecutive chunks. */
+        template <typename Header>
+        std::uint64_t computeChunkedChecksum(Header header, const unsigned char* const* chunks, const std::size_t* sizes, int chunk_count) {
+            header.checksum = 0;
+            std::uint64_t h = FNV_OFFSET_BASIS;
+            checksum64(h, &header, sizeof(header));
+            for (int i = 0; i < chunk_count; ++i) checksum64(h, chunks[i], sizes[i]);
+            return h;
+        }
+
+        /** @brief Suffix of in-progress entries; pruneCacheDirectory() removes abandoned ones. */
+        constexpr const char* TEMP_SUFFIX = ".tmp";
+        /** @brief Age after which a temporary file is taken to be left behind by a writer that died. */
+        constexpr std::chrono::hours ABANDONED_TEMP_AGE{ 1 };
+
+        bool isCacheEntry(const std::filesystem::path& path) {
+            const std::string ext = path.extension().string();
+            return ext == ".gridcache" || ext == ".landmarks" || ext == ".cch";
+        }
+
+        /**
+         * @brief Temporary name next to finalPath, unique per writer: process id, then a nonce from the
+         *        clock, the thread and a per-process counter. Concurrent processes (or threads) saving
+         *        the same key each write their own file; the last rename wins with identical content.
+         */
+        std::string temporaryPath(const std::string& finalPath) {
+#ifdef _WIN32
+            const unsigned long pid = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+            const unsigned long pid = static_cast<unsigned long>(::getpid());
+#endif
+            static std::atomic<std::uint64_t> counter{ 0 };
+            const std::uint64_t nonce = static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) ^
+                (static_cast<std::uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id())) << 1) ^
+                (counter.fetch_add(1) * 0x9E3779B97F4A7C15ull);
+            std::ostringstream name;
+            name << finalPath << '.' << pid << '.' << std::hex << nonce << TEMP_SUFFIX;
+            return name.str();
+        }
+
+        /** @brief Marks an entry as just used, so pruning evicts it after entries used less recently. */
+        void touchEntry(const std::string& path) {
+            std::error_code ec;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+        }
+
+        /**
+         * @brief Writes header + payload chunks to a temporary file and renames it into place,
+         *        so readers never observe a partially written entry; then prunes the directory
+         *        to maxCacheBytes.
+         */
+        bool writeEntryAtomically(const std::string& finalPath, const void* header, std::size_t header_size,
+            const unsigned char* const* chunks, const std::size_t* sizes, int chunk_count, std::uint64_t maxCacheBytes)
+        {
+            std::error_code ec;
+            const std::string tmpPath = temporaryPath(finalPath);
+            {
+                std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+                if (!out) {
+                    std::cerr << "Error (GridCache): Cannot write " << tmpPath << std::endl;
+                    return false;
+                }
+                out.write(static_cast<const char*>(header), static_cast<std::streamsize>(header_size));
+                for (int i = 0; i < chunk_count; ++i) {
+                    out.write(reinterpret_cast<const char*>(chunks[i]), static_cast<std::streamsize>(sizes[i]));
+                }
+                if (!out) {
+                    std::cerr << "Error (GridCache): Failed writing " << tmpPath << std::endl;
+                    out.close();
+                    std::filesystem::remove(tmpPath, ec);
+                    return false;
+                }
+            }
+
+            std::filesystem::rename(tmpPath, finalPath, ec);
+            if (ec) {
+                // rename() does not replace an existing file on every platform
+                std::filesystem::remove(finalPath, ec);
+                std::filesystem::rename(tmpPath, finalPath, ec);
+            }
+            if (ec) {
+                std::cerr << "Error (GridCache): Cannot move cache entry into place: " << ec.message() << std::endl;
+                std::filesystem::remove(tmpPath, ec);
+                return false;
+            }
+            pruneCacheDirectory(std::filesystem::path(finalPath).parent_path().string(), maxCacheBytes);
+            return true;
+        }
+
+        /** @brief Read-only memory mapping of a whole file (RAII). */
+        class MappedFile {
+        public:
+            explicit MappedFile(const std::string& path) {
+#ifdef _WIN32
+                file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+                if (file_ == INVALID_HANDLE_VALUE) return;
+                LARGE_INTEGER file_size;
+                if (!GetFileSizeEx(file_, &file_size) || file_size.QuadPart == 0) return;
+                mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (!mapping_) return;
+                void* view = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+                if (!view) return;
+                data_ = static_cast<const unsigned char*>(view);
+                size_ = static_cast<std::size_t>(file_size.QuadPart);
+#else
+                fd_ = ::open(path.c_str(), O_RDONLY);
+                if (fd_ < 0) return;
+                struct stat st;
+                if (::fstat(fd_, &st) != 0 || st.st_size <= 0) return;
+                void* view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd_, 0);
+                if (view == MAP_FAILED) return;
+                data_ = static_cast<const unsigned char*>(view);
+                size_ = static_cast<std::size_t>(st.st_size);
+#endif
+            }
+
+            ~MappedFile() {
+#ifdef _WIN32
+                if (data_) UnmapViewOfFile(data_);
+                if (mapping_) CloseHandle(mapping_);
+                if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+#else
+                if (data_) ::munmap(const_cast<unsigned char*>(data_), size_);
+                if (fd_ >= 0) ::close(fd_);
+#endif
+            }
+
+            MappedFile(const MappedFile&) = delete;
+            MappedFile& operator=(const MappedFile&) = delete;
+
+            bool isOpen() const { return data_ != nullptr; }
+            const unsigned char* data() const { return data_; }
+            std::size_t size() const { return size_; }
+
+        private:
+            const unsigned char* data_ = nullptr;
+            std::size_t size_ = 0;
+#ifdef _WIN32
+            HANDLE file_ = INVALID_HANDLE_VALUE;
+            HANDLE mapping_ = nullptr;
+#else
+            int fd_ = -1;
+#endif
+        };
+
+        void removeCorruptEntry(const std::string& path, const char* reason) {
+            std::cerr << "Warning (GridCache): Discarding cache entry " << path << " (" << reason << ")." << std::endl;
+            std::error_code ec;
+            std::filesystem::remove(path, ec);
+        }
+
+    } // anonymous namespace
+
+    std::optional<std::uint64_t> computeGridCacheKey(
+        const std::string& mapFilePath,
+        int gridWidth,
+        int gridHeight,
+        const std::vector<std::string>& layers,
+        const mapgeo::ObstacleConfigMap& obstacleConfig,
+        bool tileBinnedMerge)
+    {
+        std::uint64_t h = FNV_OFFSET_BASIS;
+        fnv1aValue(h, GRID_CACHE_FORMAT_VERSION);
+
+        // Map contents (not path or mtime): identical copies share an entry, edits invalidate it
+        if (!fnv1aFile(h, mapFilePath)) { return std::nullopt; }
+
+        fnv1aValue(h, static_cast<std::int64_t>(gridWidth));
+        fnv1aValue(h, static_cast<std::int64_t>(gridHeight));
+        fnv1aValue(h, static_cast<std::uint64_t>(layers.size()));
+        for (const auto& layer : layers) fnv1aString(h, layer);
+        fnv1aValue(h, static_cast<std::uint64_t>(obstacleConfig.size()));
+        for (const auto& entry : obstacleConfig) { // std::map iterates in a stable (sorted) order
+            fnv1aString(h, entry.first);
+            fnv1aValue(h, entry.second);
+        }
+        fnv1aValue(h, static_cast<std::uint8_t>(tileBinnedMerge ? 1 : 0));
+        return h;
+    }
+
+    std::optional<std::uint64_t> computeSourceKey(
+        const std::string& mapFilePath,
+        const std::string& controlsFilePath,
+        const mapgeo::MapProcessorConfig& processorConfig,
+        const std::string& settings)
+    {
+        std::uint64_t h = FNV_OFFSET_BASIS;
+        for (const std::string* path : { &mapFilePath, &controlsFilePath }) {
+            const std::optional<std::uint64_t> size = fnv1aFile(h, *path);
+            if (!size) { return std::nullopt; }
+            fnv1aValue(h, *size); // Length suffix keeps the two files apart
+        }
+        fnv1aValue(h, static_cast<std::int64_t>(processorConfig.grid_width));
+        fnv1aValue(h, static_cast<std::int64_t>(processorConfig.grid_height));
+        fnv1aValue(h, static_cast<std::uint64_t>(processorConfig.layers_to_process.size()));
+        for (const auto& layer : processorConfig.layers_to_process) fnv1aString(h, layer);
+        fnv1aValue(h, static_cast<std::uint8_t>(processorConfig.use_tile_binned_merge ? 1 : 0));
+        fnv1aValue(h, static_cast<std::int64_t>(processorConfig.merge_tile_size));
+        fnv1aString(h, settings);
+        return h;
+    }
+
+    std::string defaultCacheDirectory() {
+        std::error_code ec;
+        std::filesystem::path tmp = std::filesystem::temp_directory_path(ec);
+        if (ec) tmp = ".";
+        return (tmp / "omap_grid_cache").string();
+    }
+
+    std::size_t pruneCacheDirectory(const std::string& cacheDirectory, std::uint64_t maxBytes) {
+        namespace fs = std::filesystem;
+        struct Entry {
+            fs::path path;
+            fs::file_time_type time;
+            std::uint64_t size;
+        };
+        std::vector<Entry> entries;
+        std::size_t removed = 0;
+        std::error_code ec;
+        const auto now = fs::file_time_type::clock::now();
+        for (fs::directory_iterator it(cacheDirectory, ec), end; !ec && it != end; it.increment(ec)) {
+            const fs::path& path = it->path();
+            std::error_code entry_ec;
+            if (!it->is_regular_file(entry_ec) || entry_ec) continue;
+            const fs::file_time_type time = it->last_write_time(entry_ec);
+            if (entry_ec) continue;
+            if (path.extension() == TEMP_SUFFIX) {
+                if (now - time > ABANDONED_TEMP_AGE && fs::remove(path, entry_ec)) ++removed;
+                continue;
+            }
+            if (!isCacheEntry(path)) continue; // Never touch files the cache did not write
+            const std::uint64_t size = it->file_size(entry_ec);
+            if (!entry_ec) entries.push_back({ path, time, size });
+        }
+
+        // Least recently written (or loaded) first; the newest entry is always kept
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+        std::uint64_t total = 0;
+        for (const Entry& entry : entries) total += entry.size;
+        for (std::size_t i = 0; i + 1 < entries.size() && total > maxBytes; ++i) {
+            std::error_code entry_ec;
+            if (fs::remove(entries[i].path, entry_ec)) {
+                total -= entries[i].size;
+                ++removed;
+            }
+        }
+        return removed;
+    }
+
+    std::string cacheFilePath(const std::string& cacheDirectory, std::uint64_t key) {
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << key << ".gridcache";
+        return (std::filesystem::path(cacheDirectory) / name.str()).string();
+    }
+
+    std::optional<CachedGrid> loadGridCache(const std::string& cacheDirectory, std::uint64_t key) {
+        const std::string path = cacheFilePath(cacheDirectory, key);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) {
+            return std::nullopt; // Plain miss
+        }
+
+        MappedFile file(path);
+        if (!file.isOpen() || file.size() < sizeof(FileHeader)) {
+            removeCorruptEntry(path, "truncated header");
+            return std::nullopt;
+        }
+
+        FileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, GRID_CACHE_MAGIC, sizeof(GRID_CACHE_MAGIC)) != 0 ||
+            header.header_size != sizeof(FileHeader)) {
+            removeCorruptEntry(path, "bad magic");
+            return std::nullopt;
+        }
+        if (header.version != GRID_CACHE_FORMAT_VERSION || header.key != key) {
+            removeCorruptEntry(path, "stale format or key");
+            return std::nullopt;
+        }
+
+        const std::uint64_t cell_count = header.width * header.height;
+        const std::uint64_t expected_payload = cell_count * (sizeof(float) + sizeof(std::uint8_t));
+        if (header.width == 0 || header.height == 0 ||
+            header.payload_size != expected_payload ||
+            file.size() != sizeof(FileHeader) + expected_payload) {
+            removeCorruptEntry(path, "size mismatch");
+            return std::nullopt;
+        }
+
+        const unsigned char* payload = file.data() + sizeof(FileHeader);
+        if (computeChecksum(header, payload, static_cast<std::size_t>(expected_payload)) != header.checksum) {
+            removeCorruptEntry(path, "checksum mismatch");
+            return std::nullopt;
+        }
+
+        CachedGrid result;
+        result.grid = mapgeo::Grid_V3(static_cast<std::size_t>(header.width), static_cast<std::size_t>(header.height));
+        auto& cells = result.grid.data();
+        const unsigned char* values = payload;
+        const unsigned char* flags = payload + cell_count * sizeof(float);
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            std::memcpy(&cells[i].value, values + i * sizeof(float), sizeof(float));
+            cells[i].flags = flags[i];
+        }
+
+        result.normInfo.min_x = header.min_x;
+        result.normInfo.min_y = header.min_y;
+        result.normInfo.scale_x = header.scale_x;
+        result.normInfo.scale_y = header.scale_y;
+        result.normInfo.resolution_x = header.resolution_x;
+        result.normInfo.resolution_y = header.resolution_y;
+        result.normInfo.valid = header.norm_valid != 0;
+        touchEntry(path);
+        return result;
+    }
+
+    bool saveGridCache(
+        const std::string& cacheDirectory,
+        std::uint64_t key,
+        const mapgeo::Grid_V3& grid,
+        const mapgeo::NormalizationResult& normInfo,
+        std::uint64_t maxCacheBytes)
+    {
+        if (!grid.isValid()) {
+            std::cerr << "Error (GridCache): Refusing to cache an invalid grid." << std::endl;
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDirectory, ec);
+        if (ec) {
+            std::cerr << "Error (GridCache): Cannot create cache directory " << cacheDirectory << ": " << ec.message() << std::endl;
+            return false;
+        }
+
+        // Planar payload: all values, then all flags (no struct padding on disk)
+        const auto& cells = grid.data();
+        std::vector<unsigned char> payload(cells.size() * (sizeof(float) + sizeof(std::uint8_t)));
+        unsigned char* values = payload.data();
+        unsigned char* flags = payload.data() + cells.size() * sizeof(float);
+        for (std::size_t i = 0; i < cells.size(); ++i) {
+            std::memcpy(values + i * sizeof(float), &cells[i].value, sizeof(float));
+            flags[i] = cells[i].flags;
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, GRID_CACHE_MAGIC, sizeof(GRID_CACHE_MAGIC));
+        header.version = GRID_CACHE_FORMAT_VERSION;
+        header.header_size = sizeof(FileHeader);
+        header.key = key;
+        header.width = grid.width();
+        header.height = grid.height();
+        header.min_x = normInfo.min_x;
+        header.min_y = normInfo.min_y;
+        header.scale_x = normInfo.scale_x;
+        header.scale_y = normInfo.scale_y;
+        header.resolution_x = normInfo.resolution_x;
+        header.resolution_y = normInfo.resolution_y;
+        header.norm_valid = normInfo.valid ? 1u : 0u;
+        header.payload_size = payload.size();
+        header.checksum = computeChecksum(header, payload.data(), payload.size());
+
+        const unsigned char* chunks[1] = { payload.data() };
+        const std::size_t sizes[1] = { payload.size() };
+        return writeEntryAtomically(cacheFilePath(cacheDirectory, key), &header, sizeof(header), chunks, sizes, 1, maxCacheBytes);
+    }
+
+    std::uint64_t computeLandmarkCacheKey(
+        const mapgeo::Grid_V3& grid,
+        const mapgeo::ElevationRaster& elevation,
+        float logCellResolution,
+        int landmarkCount)
+    {
+        std::uint64_t h = FNV_OFFSET_BASIS;
+        fnv1aValue(h, GRID_CACHE_FORMAT_VERSION);
+        fnv1aValue(h, LANDMARK_CACHE_FORMAT_VERSION);
+        fnv1aValue(h, static_cast<std::uint64_t>(grid.width()));
+        fnv1aValue(h, static_cast<std::uint64_t>(grid.height()));
+        fnv1aValue(h, logCellResolution);
+        fnv1aValue(h, static_cast<std::int32_t>(landmarkCount));
+        // Contents: word-wise hashing keeps this well below the cost of a single landmark search
+        // (cells are combined field by field: GridCellData has padding bytes)
+        for (const mapgeo::GridCellData& cell : grid.data()) {
+            std::uint32_t value_bits;
+            std::memcpy(&value_bits, &cell.value, sizeof(value_bits));
+            h ^= (static_cast<std::uint64_t>(value_bits) << 8) | cell.flags;
+            h *= FNV_PRIME;
+        }
+        checksum64(h, elevation.values().data(), elevation.values().size() * sizeof(float));
+        return h;
+    }
+
+    std::string landmarkCacheFilePath(const std::string& cacheDirectory, std::uint64_t key) {
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << key << ".landmarks";
+        return (std::filesystem::path(cacheDirectory) / name.str()).string();
+    }
+
+    std::optional<Pathfinding::LandmarkHeuristic> loadLandmarkCache(const std::string& cacheDirectory, std::uint64_t key) {
+        const std::string path = landmarkCacheFilePath(cacheDirectory, key);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) {
+            return std::nullopt; // Plain miss
+        }
+
+        MappedFile file(path);
+        if (!file.isOpen() || file.size() < sizeof(LandmarkFileHeader)) {
+            removeCorruptEntry(path, "truncated header");
+            return std::nullopt;
+        }
+
+        LandmarkFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, LANDMARK_CACHE_MAGIC, sizeof(LANDMARK_CACHE_MAGIC)) != 0 ||
+            header.header_size != sizeof(LandmarkFileHeader)) {
+            removeCorruptEntry(path, "bad magic");
+            return std::nullopt;
+        }
+        if (header.version != LANDMARK_CACHE_FORMAT_VERSION || header.key != key) {
+            removeCorruptEntry(path, "stale format or key");
+            return std::nullopt;
+        }
+
+        const std::uint64_t stride = 2ull * header.landmark_count;
+        const std::size_t sizes[3] = {
+            static_cast<std::size_t>(header.landmark_count) * sizeof(std::int32_t),
+            static_cast<std::size_t>(stride) * sizeof(float),
+            static_cast<std::size_t>(header.width * header.height * stride) * sizeof(std::uint16_t)
+        };
+        const std::uint64_t expected_payload = sizes[0] + sizes[1] + sizes[2];
+        if (header.width == 0 || header.height == 0 || header.landmark_count == 0 ||
+            header.payload_size != expected_payload ||
+            file.size() != sizeof(LandmarkFileHeader) + expected_payload) {
+            removeCorruptEntry(path, "size mismatch");
+            return std::nullopt;
+        }
+
+        const unsigned char* payload = file.data() + sizeof(LandmarkFileHeader);
+        const unsigned char* chunks[3] = { payload, payload + sizes[0], payload + sizes[0] + sizes[1] };
+        if (computeChunkedChecksum(header, chunks, sizes, 3) != header.checksum) {
+            removeCorruptEntry(path, "checksum mismatch");
+            return std::nullopt;
+        }
+
+        std::vector<int> landmarkCells(header.landmark_count);
+        std::vector<float> scales(static_cast<std::size_t>(stride));
+        std::vector<std::uint16_t> distances(sizes[2] / sizeof(std::uint16_t));
+        for (std::size_t i = 0; i < landmarkCells.size(); ++i) {
+            std::int32_t cell;
+            std::memcpy(&cell, chunks[0] + i * sizeof(cell), sizeof(cell));
+            landmarkCells[i] = static_cast<int>(cell);
+        }
+        std::memcpy(scales.data(), chunks[1], sizes[1]);
+        std::memcpy(distances.data(), chunks[2], sizes[2]);
+
+        Pathfinding::LandmarkHeuristic tables = Pathfinding::LandmarkHeuristic::fromTables(
+            static_cast<std::size_t>(header.width), static_cast<std::size_t>(header.height),
+            std::move(landmarkCells), std::move(scales), std::move(distances));
+        if (!tables.isValid()) {
+            removeCorruptEntry(path, "invalid tables");
+            return std::nullopt;
+        }
+        touchEntry(path);
+        return tables;
+    }
+
+    bool saveLandmarkCache(const std::string& cacheDirectory, std::uint64_t key, const Pathfinding::LandmarkHeuristic& tables,
+        std::uint64_t maxCacheBytes)
+    {
+        if (!tables.isValid()) {
+            std::cerr << "Error (GridCache): Refusing to cache invalid landmark tables." << std::endl;
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDirectory, ec);
+        if (ec) {
+            std::cerr << "Error (GridCache): Cannot create cache directory " << cacheDirectory << ": " << ec.message() << std::endl;
+            return false;
+        }
+
+        std::vector<std::int32_t> cells(tables.landmarkCells().begin(), tables.landmarkCells().end());
+        const unsigned char* chunks[3] = {
+            reinterpret_cast<const unsigned char*>(cells.data()),
+            reinterpret_cast<const unsigned char*>(tables.scales().data()),
+            reinterpret_cast<const unsigned char*>(tables.distances().data())
+        };
+        const std::size_t sizes[3] = {
+            cells.size() * sizeof(std::int32_t),
+            tables.scales().size() * sizeof(float),
+            tables.distances().size() * sizeof(std::uint16_t)
+        };
+
+        LandmarkFileHeader header{};
+        std::memcpy(header.magic, LANDMARK_CACHE_MAGIC, sizeof(LANDMARK_CACHE_MAGIC));
+        header.version = LANDMARK_CACHE_FORMAT_VERSION;
+        header.header_size = sizeof(LandmarkFileHeader);
+        header.key = key;
+        header.width = tables.width();
+        header.height = tables.height();
+        header.landmark_count = static_cast<std::uint32_t>(tables.landmarkCount());
+        header.payload_size = sizes[0] + sizes[1] + sizes[2];
+        header.checksum = computeChunkedChecksum(header, chunks, sizes, 3);
+
+        return writeEntryAtomically(landmarkCacheFilePath(cacheDirectory, key), &header, sizeof(header), chunks, sizes, 3, maxCacheBytes);
+    }
+
+    std::uint64_t computeContractionCacheKey(const mapgeo::Grid_V3& grid) {
+        std::uint64_t h = FNV_OFFSET_BASIS;
+        fnv1aValue(h, GRID_CACHE_FORMAT_VERSION);
+        fnv1aValue(h, CONTRACTION_CACHE_FORMAT_VERSION);
+        fnv1aValue(h, static_cast<std::uint64_t>(grid.width()));
+        fnv1aValue(h, static_cast<std::uint64_t>(grid.height()));
+        // Passability only, 64 cells per word (same test as ContractionHierarchy)
+        std::uint64_t word = 0;
+        int bits = 0;
+        for (const mapgeo::GridCellData& cell : grid.data()) {
+            const bool passable = cell.value > 0.0f && !cell.hasFlag(mapgeo::GridFlags::FLAG_IMPASSABLE);
+            word = (word << 1) | (passable ? 1u : 0u);
+            if (++bits == 64) {
+                h ^= word;
+                h *= FNV_PRIME;
+                word = 0;
+                bits = 0;
+            }
+        }
+        h ^= word;
+        h *= FNV_PRIME;
+        return h;
+    }
+
+    std::string contractionCacheFilePath(const std::string& cacheDirectory, std::uint64_t key) {
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << key << ".cch";
+        return (std::filesystem::path(cacheDirectory) / name.str()).string();
+    }
+
+    std::optional<Pathfinding::ContractionHierarchy> loadContractionCache(const std::string& cacheDirectory, std::uint64_t key) {
+        using Arc = Pathfinding::ContractionHierarchy::Arc;
+        const std::string path = contractionCacheFilePath(cacheDirectory, key);
+        std::error_code ec;
+        if (!std::filesystem::exists(path, ec)) {
+            return std::nullopt; // Plain miss
+        }
+
+        MappedFile file(path);
+        if (!file.isOpen() || file.size() < sizeof(ContractionFileHeader)) {
+            removeCorruptEntry(path, "truncated header");
+            return std::nullopt;
+        }
+
+        ContractionFileHeader header;
+        std::memcpy(&header, file.data(), sizeof(header));
+        if (std::memcmp(header.magic, CONTRACTION_CACHE_MAGIC, sizeof(CONTRACTION_CACHE_MAGIC)) != 0 ||
+            header.header_size != sizeof(ContractionFileHeader)) {
+            removeCorruptEntry(path, "bad magic");
+            return std::nullopt;
+        }
+        if (header.version != CONTRACTION_CACHE_FORMAT_VERSION || header.key != key) {
+            removeCorruptEntry(path, "stale format or key");
+            return std::nullopt;
+        }
+
+        constexpr std::uint64_t max_cells = Pathfinding::ContractionHierarchy::MAX_CELLS;
+        const std::uint64_t cells = header.width * header.height;
+        if (header.width == 0 || header.height == 0 || header.width > max_cells || header.height > max_cells || cells > max_cells ||
+            header.arc_count > file.size() / sizeof(Arc)) {
+            removeCorruptEntry(path, "size mismatch");
+            return std::nullopt;
+        }
+        const std::size_t sizes[5] = {
+            static_cast<std::size_t>(cells) * sizeof(std::int32_t),
+            static_cast<std::size_t>(cells + 1) * sizeof(std::uint64_t),
+            static_cast<std::size_t>(header.arc_count) * sizeof(Arc),
+            static_cast<std::size_t>(cells + 1) * sizeof(std::uint64_t),
+            static_cast<std::size_t>(header.arc_count) * sizeof(Arc)
+        };
+        const std::uint64_t expected_payload = sizes[0] + sizes[1] + sizes[2] + sizes[3] + sizes[4];
+        if (header.payload_size != expected_payload || file.size() != sizeof(ContractionFileHeader) + expected_payload) {
+            removeCorruptEntry(path, "size mismatch");
+            return std::nullopt;
+        }
+
+        const unsigned char* chunks[5];
+        chunks[0] = file.data() + sizeof(ContractionFileHeader);
+        for (int i = 1; i < 5; ++i) { chunks[i] = chunks[i - 1] + sizes[i - 1]; }
+        if (computeChunkedChecksum(header, chunks, sizes, 5) != header.checksum) {
+            removeCorruptEntry(path, "checksum mismatch");
+            return std::nullopt;
+        }
+
+        std::vector<int> rank(static_cast<std::size_t>(cells));
+        for (std::size_t i = 0; i < rank.size(); ++i) {
+            std::int32_t value;
+            std::memcpy(&value, chunks[0] + i * sizeof(value), sizeof(value));
+            rank[i] = static_cast<int>(value);
+        }
+        auto readOffsets = [](const unsigned char* chunk, std::size_t count) {
+            std::vector<std::size_t> offsets(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                std::uint64_t value;
+                std::memcpy(&value, chunk + i * sizeof(value), sizeof(value));
+                offsets[i] = static_cast<std::size_t>(value);
+            }
+            return offsets;
+        };
+        std::vector<Arc> upArcs(static_cast<std::size_t>(header.arc_count));
+        std::vector<Arc> downArcs(static_cast<std::size_t>(header.arc_count));
+        std::memcpy(upArcs.data(), chunks[2], sizes[2]);
+        std::memcpy(downArcs.data(), chunks[4], sizes[4]);
+
+        Pathfinding::ContractionHierarchy hierarchy = Pathfinding::ContractionHierarchy::fromArrays(
+            static_cast<int>(header.width), static_cast<int>(header.height), static_cast<int>(header.rounds),
+            static_cast<std::size_t>(header.shortcut_count), std::move(rank),
+            readOffsets(chunks[1], static_cast<std::size_t>(cells + 1)), std::move(upArcs),
+            readOffsets(chunks[3], static_cast<std::size_t>(cells + 1)), std::move(downArcs));
+        if (!hierarchy.isValid()) {
+            removeCorruptEntry(path, "invalid hierarchy");
+            return std::nullopt;
+        }
+        touchEntry(path);
+        return hierarchy;
+    }
+
+    bool saveContractionCache(const std::string& cacheDirectory, std::uint64_t key, const Pathfinding::ContractionHierarchy& hierarchy,
+        std::uint64_t maxCacheBytes)
+    {
+        if (!hierarchy.isValid() || !hierarchy.isCustomizable()) {
+            std::cerr << "Error (GridCache): Only valid customizable contraction hierarchies are cached." << std::endl;
+            return false;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(cacheDirectory, ec);
+        if (ec) {
+            std::cerr << "Error (GridCache): Cannot create cache directory " << cacheDirectory << ": " << ec.message() << std::endl;
+            return false;
+        }
+
+        std::vector<std::int32_t> rank(hierarchy.ranks().begin(), hierarchy.ranks().end());
+        std::vector<std::uint64_t> upOffsets(hierarchy.upOffsets().begin(), hierarchy.upOffsets().end());
+        std::vector<std::uint64_t> downOffsets(hierarchy.downOffsets().begin(), hierarchy.downOffsets().end());
+        const unsigned char* chunks[5] = {
+            reinterpret_cast<const unsigned char*>(rank.data()),
+            reinterpret_cast<const unsigned char*>(upOffsets.data()),
+            reinterpret_cast<const unsigned char*>(hierarchy.upArcs().data()),
+            reinterpret_cast<const unsigned char*>(downOffsets.data()),
+            reinterpret_cast<const unsigned char*>(hierarchy.downArcs().data())
+        };
+        const std::size_t sizes[5] = {
+            rank.size() * sizeof(std::int32_t),
+            upOffsets.size() * sizeof(std::uint64_t),
+            hierarchy.upArcs().size() * sizeof(Pathfinding::ContractionHierarchy::Arc),
+            downOffsets.size() * sizeof(std::uint64_t),
+            hierarchy.downArcs().size() * sizeof(Pathfinding::ContractionHierarchy::Arc)
+        };
+
+        ContractionFileHeader header{};
+        std::memcpy(header.magic, CONTRACTION_CACHE_MAGIC, sizeof(CONTRACTION_CACHE_MAGIC));
+        header.version = CONTRACTION_CACHE_FORMAT_VERSION;
+        header.header_size = sizeof(ContractionFileHeader);
+        header.key = key;
+        header.width = static_cast<std::uint64_t>(hierarchy.width());
+        header.height = static_cast<std::uint64_t>(hierarchy.height());
+        header.rounds = static_cast<std::uint32_t>(hierarchy.contractionRounds());
+        header.shortcut_count = hierarchy.shortcutCount();
+        header.arc_count = hierarchy.upArcs().size();
+        header.payload_size = sizes[0] + sizes[1] + sizes[2] + sizes[3] + sizes[4];
+        header.checksum = computeChunkedChecksum(header, chunks, sizes, 5);
+
+        return writeEntryAtomically(contractionCacheFilePath(cacheDirectory, key), &header, sizeof(header), chunks, sizes, 5, maxCacheBytes);
+    }
+
+} // namespace gridcache
@@ -0,0 +1,94 @@
+// File: RasterExport.cpp
+#include "IO/RasterExport.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+
+namespace rasterexport {
+
+    namespace {
+
+        // The .flt payload is little-endian regardless of the host
+        void storeLittleEndian(float value, char* out) {
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int i = 0; i < 4; ++i) { out[i] = static_cast<char>((bits >> (8 * i)) & 0xFFu); }
+        }
+
+    } // end anonymous namespace
+
+    bool saveFloatRaster(
+        const std::string& basePath,
+        const std::vector<float>& values,
+        std::size_t width,
+        std::size_t height,
+        const mapgeo::NormalizationResult& normInfo,
+        float noDataValue
+    ) {
+        if (width == 0 || height == 0 || values.size() != width * height) {
+            std::cerr << "RasterExport Error: " << values.size() << " values do not match a "
+                << width << "x" << height << " grid." << std::endl;
+            return false;
+        }
+        if (!normInfo.valid || normInfo.scale_x <= 0.0 || normInfo.scale_y <= 0.0) {
+            std::cerr << "RasterExport Error: Invalid normalization info." << std::endl;
+            return false;
+        }
+
+        // --- Header ---
+        const double cell_x = 1.0 / normInfo.scale_x; // Map units per grid cell
+        const double cell_y = 1.0 / normInfo.scale_y;
+        const std::string headerPath = basePath + ".hdr";
+        std::ofstream header(headerPath);
+        if (!header) {
+            std::cerr << "RasterExport Error: Cannot open " << headerPath << " for writing." << std::endl;
+            return false;
+        }
+        header << std::setprecision(17);
+        header << "ncols " << width << "\n";
+        header << "nrows " << height << "\n";
+        header << "xllcorner " << normInfo.min_x << "\n";
+        header << "yllcorner " << -(normInfo.min_y + static_cast<double>(height) * cell_y) << "\n";
+        if (std::abs(cell_x - cell_y) <= 1e-9 * cell_x) {
+            header << "cellsize " << cell_x << "\n";
+        }
+        else {
+            header << "xdim " << cell_x << "\n";
+            header << "ydim " << cell_y << "\n";
+        }
+        header << "NODATA_value " << noDataValue << "\n";
+        header << "byteorder LSBFIRST\n";
+        if (!header) {
+            std::cerr << "RasterExport Error: Failed writing " << headerPath << std::endl;
+            return false;
+        }
+
+        // --- Data, one row at a time ---
+        const std::string dataPath = basePath + ".flt";
+        std::ofstream data(dataPath, std::ios::binary);
+        if (!data) {
+            std::cerr << "RasterExport Error: Cannot open " << dataPath << " for writing." << std::endl;
+            return false;
+        }
+        std::vector<char> row(width * sizeof(float));
+        for (std::size_t y = 0; y < height; ++y) {
+            for (std::size_t x = 0; x < width; ++x) {
+                float value = values[y * width + x];
+                if (!std::isfinite(value) || value >= std::numeric_limits<float>::max()) { value = noDataValue; }
+                storeLittleEndian(value, row.data() + x * sizeof(float));
+            }
+            data.write(row.data(), static_cast<std::streamsize>(row.size()));
+        }
+        if (!data) {
+            std::cerr << "RasterExport Error: Failed writing " << dataPath << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+} // namespace rasterexport
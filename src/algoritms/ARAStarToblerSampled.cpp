@@ -0,0 +1,217 @@
+// File: ARAStarToblerSampled.cpp
+
+#include "algoritms/ARAStarToblerSampled.hpp"
+#include "map/MapProcessingCommon.h"
+#include "map/ElevationRaster.hpp"
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"
+#include "algoritms/SearchQueues.hpp"
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        std::vector<int> reconstructPath(const SearchWorkspace& workspace, int startIdx, int endIdx, int log_size) {
+            std::vector<int> path_reversed;
+            int current = endIdx;
+            size_t safety_count = 0;
+            const size_t max_path_len = static_cast<size_t>(log_size) + 1;
+            while (current != -1 && safety_count < max_path_len) {
+                path_reversed.push_back(current);
+                if (current == startIdx) break;
+                current = workspace.parent(current);
+                safety_count++;
+            }
+            if (current != startIdx || safety_count >= max_path_len) { return {}; }
+            return std::vector<int>(path_reversed.rbegin(), path_reversed.rend());
+        }
+
+    } // end anonymous namespace
+
+    std::vector<AnytimeSolution> findARAStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end,
+        const AnytimeSettings& settings,
+        const AnytimeSolutionCallback& on_solution
+    ) {
+        using Clock = std::chrono::steady_clock;
+        const auto start_time = Clock::now();
+        std::vector<AnytimeSolution> solutions;
+
+        const EdgeCostCache* edge_costs = context.hasEdgeCosts() ? context.edge_costs : nullptr;
+        if (!context.isValid() || (edge_costs == nullptr && !context.hasElevation())) { return solutions; }
+        const Grid_V3& logical_grid = *context.grid;
+        const ElevationRaster* cell_elevation = context.elevation;
+        const float log_cell_resolution = context.log_cell_resolution;
+        const int log_width = static_cast<int>(logical_grid.width());
+        const int log_height = static_cast<int>(logical_grid.height());
+        const int log_size = log_width * log_height;
+
+        if (!logical_grid.inBounds(start.x, start.y) || !logical_grid.inBounds(end.x, end.y)) { return solutions; }
+        const int startIdx = toIndex(start.x, start.y, log_width);
+        const int endIdx = toIndex(end.x, end.y, log_width);
+        const GridCellData& startCell = logical_grid.at(start.x, start.y);
+        if (startCell.value <= 0.0f || startCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return solutions; }
+        const GridCellData& endCell = logical_grid.at(end.x, end.y);
+        if (endCell.value <= 0.0f || endCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return solutions; }
+
+        auto elapsedMs = [&]() { return std::chrono::duration<double, std::milli>(Clock::now() - start_time).count(); };
+        auto publish = [&](std::vector<int> path, float cost, float epsilon, float bound, std::size_t expansions) {
+            AnytimeSolution solution;
+            solution.path = std::move(path);
+            solution.cost = cost;
+            solution.epsilon = epsilon;
+            solution.suboptimality_bound = bound;
+            solution.elapsed_ms = elapsedMs();
+            solution.expansions = expansions;
+            if (on_solution) { on_solution(solution); }
+            solutions.push_back(std::move(solution));
+        };
+
+        if (startIdx == endIdx) {
+            publish({ startIdx }, 0.0f, 1.0f, 1.0f, 0);
+            return solutions;
+        }
+        if (!workspace.beginQuery(static_cast<size_t>(log_size))) { return solutions; }
+
+        // --- Consistent heuristic (see BidirectionalToblerSampled), shrunk for rounded Float16 costs ---
+        const bool approximate_costs = edge_costs != nullptr && edge_costs->precision() == EdgeCostCache::Precision::Float16;
+        const float h_scale = context.min_terrain_cost * (approximate_costs ? 1.0f - EdgeCostCache::FLOAT16_MAX_RELATIVE_ERROR : 1.0f);
+        auto heuristic = [&](int idx) {
+            int hx, hy;
+            toCoords(idx, log_width, hx, hy);
+            return h_scale * internal::euclidean_distance(hx, hy, end.x, end.y);
+        };
+
+        // Cost of the in-bounds step idx -> (nx, ny) = neighborIdx in direction dir (max() = impossible)
+        auto moveCost = [&](int idx, int neighborIdx, int nx, int ny, int dir) {
+            if (edge_costs != nullptr) { return edge_costs->cost(idx, dir); }
+            const GridCellData& neighborCell = logical_grid.at(nx, ny);
+            if (neighborCell.value <= 0.0f || neighborCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return std::numeric_limits<float>::max(); }
+            const float delta_h = cell_elevation->atIndex(neighborIdx) - cell_elevation->atIndex(idx);
+            return toblerStepCost(dir, log_cell_resolution, delta_h, neighborCell.value);
+        };
+        // Parents may have improved after the goal was reached, so a path can be cheaper than g(goal)
+        auto pathCost = [&](const std::vector<int>& path) {
+            float cost = 0.0f;
+            for (size_t i = 1; i < path.size(); ++i) {
+                int x0, y0, x1, y1;
+                toCoords(path[i - 1], log_width, x0, y0);
+                toCoords(path[i], log_width, x1, y1);
+                int dir = 0;
+                while (dir < NUM_DIRECTIONS && (x0 + dx[dir] != x1 || y0 + dy[dir] != y1)) { ++dir; }
+                cost += moveCost(path[i - 1], path[i], x1, y1, dir);
+            }
+            return cost;
+        };
+
+        float epsilon = std::max(1.0f, settings.initial_epsilon);
+        const float epsilon_step = (settings.epsilon_step > 0.0f) ? settings.epsilon_step : epsilon - 1.0f;
+        const bool has_deadline = settings.time_budget_ms > 0.0;
+        const auto deadline = start_time + std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double, std::milli>(has_deadline ? settings.time_budget_ms : 0.0));
+
+        BinaryHeapQueue openQueue;
+        std::vector<int> closed_cells; // Closed in the current iteration (reopened before the next one)
+        std::vector<int> incons;       // Improved after being closed; reconsidered in the next iteration
+        std::vector<int> carried;      // Scratch for re-keying the open list
+        std::size_t expansions = 0;
+
+        workspace.setScore(startIdx, 0.0f, -1);
+        openQueue.push(epsilon * heuristic(startIdx), startIdx);
+
+        while (true) {
+            // --- ImprovePath: weighted A* until no open cell can beat the current goal cost ---
+            bool out_of_time = false;
+            while (!openQueue.empty()) {
+                auto [current_f, currentIdx] = openQueue.popMin();
+                if (workspace.isClosed(currentIdx)) { continue; } // stale entry
+                if (current_f >= workspace.g(endIdx)) { openQueue.push(current_f, currentIdx); break; }
+                // Deadline only applies once a route exists; checked every 256 expansions
+                if (has_deadline && !solutions.empty() && (expansions & 255u) == 0 && Clock::now() >= deadline) {
+                    openQueue.push(current_f, currentIdx);
+                    out_of_time = true;
+                    break;
+                }
+                workspace.close(currentIdx);
+                closed_cells.push_back(currentIdx);
+                ++expansions;
+
+                int x, y;
+                toCoords(currentIdx, log_width, x, y);
+                const float current_g = workspace.g(currentIdx);
+
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    const int nx = x + dx[dir];
+                    const int ny = y + dy[dir];
+                    if (nx < 0 || nx >= log_width || ny < 0 || ny >= log_height) { continue; }
+                    const int neighborIdx = toIndex(nx, ny, log_width);
+
+                    const float final_move_cost = moveCost(currentIdx, neighborIdx, nx, ny, dir);
+                    if (final_move_cost >= std::numeric_limits<float>::max()) { continue; }
+
+                    const float tentative_g = current_g + final_move_cost;
+                    if (tentative_g < workspace.g(neighborIdx)) {
+                        workspace.setScore(neighborIdx, tentative_g, currentIdx);
+                        if (workspace.isClosed(neighborIdx)) { incons.push_back(neighborIdx); }
+                        else { openQueue.push(tentative_g + epsilon * heuristic(neighborIdx), neighborIdx); }
+                    }
+                }
+            }
+            if (out_of_time) { break; }
+
+            const float goal_g = workspace.g(endIdx);
+            if (goal_g >= std::numeric_limits<float>::max()) { break; } // No path at all
+
+            // --- Collect OPEN and INCONS (re-keyed below), and the bound they prove ---
+            carried.clear();
+            while (!openQueue.empty()) {
+                const int idx = openQueue.popMin().second;
+                if (!workspace.isClosed(idx)) { carried.push_back(idx); }
+            }
+            carried.insert(carried.end(), incons.begin(), incons.end());
+            incons.clear();
+            std::sort(carried.begin(), carried.end());
+            carried.erase(std::unique(carried.begin(), carried.end()), carried.end());
+
+            std::vector<int> path = reconstructPath(workspace, startIdx, endIdx, log_size);
+            if (path.empty()) { break; }
+            float cost = std::min(goal_g, pathCost(path));
+            // Path costs need not fall with g(goal); keep the previous route if it is still better
+            if (!solutions.empty() && solutions.back().cost <= cost) {
+                path = solutions.back().path;
+                cost = solutions.back().cost;
+            }
+
+            float min_unexpanded_f = std::numeric_limits<float>::max();
+            for (int idx : carried) { min_unexpanded_f = std::min(min_unexpanded_f, workspace.g(idx) + heuristic(idx)); }
+            float bound = (min_unexpanded_f > 0.0f && min_unexpanded_f < std::numeric_limits<float>::max())
+                ? std::min(epsilon, cost / min_unexpanded_f) : 1.0f;
+            bound = std::max(1.0f, bound);
+            publish(std::move(path), cost, epsilon, bound, expansions);
+
+            if (epsilon <= 1.0f || bound <= 1.0f) { break; }
+            if (has_deadline && Clock::now() >= deadline) { break; }
+
+            // --- Next iteration: lower epsilon, forget CLOSED, re-key OPEN u INCONS ---
+            epsilon = std::max(1.0f, std::min(epsilon - epsilon_step, bound));
+            for (int idx : closed_cells) { workspace.reopen(idx); }
+            closed_cells.clear();
+            for (int idx : carried) { openQueue.push(workspace.g(idx) + epsilon * heuristic(idx), idx); }
+        }
+
+        return solutions;
+    }
+
+} // namespace Pathfinding
@@ -6,11 +6,17 @@
 #include "map/MapProcessingCommon.h"  // For Grid_V3, GridCellData, FLAG_IMPASSABLE
 #include "map/PathfindingUtils.hpp"   // For constants, heuristic, GridPoint, etc.
 #include "map/ElevationSampler.hpp"   // For the ElevationSampler class
+#include "map/ElevationRaster.hpp"    // For the shared per-grid elevation raster
+#include "algoritms/EdgeCostCache.hpp" // For the optional precomputed edge costs
+#include "algoritms/SearchKernels.hpp" // For the cost-model, heuristic and open-list policies
+#include "algoritms/LandmarkHeuristic.hpp" // For the ALT heuristic
+#include "algoritms/TravelTimeField.hpp"   // For the exact cost-to-target heuristic
 
 #include <vector>
 #include <queue>
 #include <limits>
 #include <cmath>
+#include <algorithm>
 #include <stdexcept>
 #include <iostream> // For optional debug/error output
 #include <string>   // For error messages
@@ -21,6 +27,144 @@ using namespace PathfindingUtils;
 
 namespace Pathfinding {
 
+    namespace {
+
+        // A* search body, instantiated per open list, connectivity, cost model and heuristic (see SearchKernels.hpp)
+        template <typename OpenQueue, int Directions, typename CostPolicy, typename Heuristic>
+        std::vector<int> runAStar(
+            const PathfindingContext& context,
+            SearchWorkspace& workspace,
+            const GridPoint& start,
+            const GridPoint& end,
+            const CostPolicy& cost_policy,
+            const Heuristic& heuristic
+        ) {
+            std::vector<int> resultPath;
+            const Grid_V3& logical_grid = *context.grid;
+            const int log_width = static_cast<int>(logical_grid.width());
+            const int log_height = static_cast<int>(logical_grid.height());
+            const int log_size = log_width * log_height;
+            // Storage layout of the workspace and the cost policy's data; indices below are layout
+            // indices, heuristics get row-major ones
+            const auto& layout = cost_policy.layout();
+
+            const int startIdx = layout.toIndex(start.x, start.y);
+            const int endIdx = layout.toIndex(end.x, end.y);
+
+            // --- Search state: generation-stamped, so no O(grid) reset per query ---
+            if (!workspace.beginQuery(layout.storageSize())) { return resultPath; }
+
+            // --- Open list: (key, node_index) entries, stale duplicates skipped via the closed set ---
+            OpenQueue openQueue;
+
+            // --- Initialization ---
+            workspace.setScore(startIdx, 0.0f, -1);
+            float h_start = heuristic(start.x, start.y, toIndex(start.x, start.y, log_width));
+            openQueue.push(h_start, startIdx);
+
+            // --- A* Main Loop ---
+            while (!openQueue.empty()) {
+                auto [current_f, currentIdx] = openQueue.popMin();
+
+                if (currentIdx == endIdx) { break; }
+                if (workspace.isClosed(currentIdx)) { continue; } // stale entry
+                workspace.close(currentIdx);
+
+                int x, y;
+                layout.toCoords(currentIdx, x, y);
+                const float current_g = workspace.g(currentIdx);
+
+                // All outgoing costs of the current cell at once; obstacles, impassable slopes and
+                // out-of-bounds neighbours come out as max()
+                alignas(32) float cell_costs[NUM_DIRECTIONS];
+                cost_policy.cellCosts(x, y, currentIdx, cell_costs);
+
+                // --- Explore Neighbors ---
+                for (int dir = 0; dir < Directions; ++dir) {
+                    const int nx = x + dx[dir];
+                    const int ny = y + dy[dir];
+
+                    if (nx < 0 || nx >= log_width || ny < 0 || ny >= log_height) { continue; } // Logical bounds
+
+                    const int neighborIdx = layout.toIndex(nx, ny);
+                    const int neighborCell = toIndex(nx, ny, log_width); // Row-major, for the heuristic
+                    const float final_move_cost = cell_costs[dir];
+                    if (final_move_cost >= std::numeric_limits<float>::max()) { continue; }
+
+                    // --- Update Neighbor ---
+                    float tentative_g = current_g + final_move_cost;
+
+                    if constexpr (Heuristic::PRUNES_UNREACHABLE) {
+                        if (!heuristic.reachable(neighborCell)) { continue; }
+                    }
+
+                    if (tentative_g < workspace.g(neighborIdx)) {
+                        workspace.setScore(neighborIdx, tentative_g, currentIdx);
+                        if constexpr (!Heuristic::CONSISTENT) {
+                            if (workspace.isClosed(neighborIdx)) { workspace.reopen(neighborIdx); }
+                        }
+                        float new_f = tentative_g + heuristic(nx, ny, neighborCell);
+                        openQueue.push(new_f, neighborIdx);
+                    }
+                } // End neighbor loop
+            } // End while openQueue not empty
+
+            // --- Path Reconstruction ---
+            if (workspace.parent(endIdx) == -1 && startIdx != endIdx) { return resultPath; }
+            std::vector<int> path_reversed;
+            int current = endIdx;
+            size_t safety_count = 0;
+            const size_t max_path_len = static_cast<size_t>(log_size) + 1;
+            while (current != -1 && safety_count < max_path_len) {
+                int cx, cy;
+                layout.toCoords(current, cx, cy);
+                path_reversed.push_back(toIndex(cx, cy, log_width)); // Paths are row-major
+                if (current == startIdx) break;
+                current = workspace.parent(current);
+                safety_count++;
+            }
+            if (current != startIdx && startIdx != endIdx) return std::vector<int>(); // Failed
+            if (safety_count >= max_path_len) return std::vector<int>();           // Failed (cycle?)
+
+            resultPath.assign(path_reversed.rbegin(), path_reversed.rend());
+            return resultPath;
+        }
+
+        /**
+         * Calls fn with the heuristic policy for heuristic_type. A travel-time field ending at the
+         * target overrides heuristic_type; the field and the ALT tables hold Tobler costs, so both are
+         * only used when the cost model matches them (costsMatchTobler()). Unknown types (and ALT
+         * without tables) are Euclidean.
+         */
+        template <typename Fn>
+        std::vector<int> withHeuristic(const PathfindingContext& context, const GridPoint& end, int heuristic_type, Fn&& fn) {
+            const int endIdx = toIndex(end.x, end.y, static_cast<int>(context.grid->width()));
+            const bool tobler_costs = context.costsMatchTobler();
+            if (tobler_costs && context.hasTravelTimeTo(endIdx)) {
+                // Cheapest step: an axial step on the cheapest terrain at no slope penalty, less the Float16 rounding
+                const bool approximate_costs = context.hasEdgeCosts() && context.edge_costs->precision() == EdgeCostCache::Precision::Float16;
+                const float min_step_cost = context.min_terrain_cost * (approximate_costs ? 1.0f - EdgeCostCache::FLOAT16_MAX_RELATIVE_ERROR : 1.0f);
+                return fn(TravelTimeHeuristic{ context.travel_time, (min_step_cost > 0.0f) ? 1.0f / min_step_cost : 0.0f });
+            }
+            switch (heuristic_type) {
+            case HEURISTIC_DIAGONAL: return fn(DiagonalHeuristic{ end.x, end.y });
+            case HEURISTIC_MANHATTAN: return fn(ManhattanHeuristic{ end.x, end.y });
+            case HEURISTIC_MIN_COST: return fn(MinCostHeuristic{ end.x, end.y });
+            case HEURISTIC_ALT:
+                if (tobler_costs && context.hasLandmarks()) {
+                    const bool approximate_costs = context.hasEdgeCosts() && context.edge_costs->precision() == EdgeCostCache::Precision::Float16;
+                    LandmarkBoundHeuristic alt{ context.landmarks->forTarget(endIdx, approximate_costs ? 1.0f - EdgeCostCache::FLOAT16_MAX_RELATIVE_ERROR : 1.0f),
+                        context.min_terrain_cost, end.x, end.y };
+                    return fn(alt);
+                }
+                break;
+            default: break;
+            }
+            return fn(EuclideanHeuristic{ end.x, end.y });
+        }
+
+    } // end anonymous namespace
+
     std::vector<int> findAStarPath_Tobler_Sampled(
         const Grid_V3& logical_grid,
         const std::vector<float>& elevation_values,
@@ -34,19 +178,14 @@ namespace Pathfinding {
         const GridPoint& end,
         int heuristic_type
     ) {
-        const int log_width = static_cast<int>(logical_grid.width());
-        const int log_height = static_cast<int>(logical_grid.height());
-        const int log_size = log_width * log_height;
-        std::vector<int> resultPath;
-
         // --- Input Validation ---
         if (!logical_grid.isValid() || log_cell_resolution <= EPSILON) {
             // std::cerr << "A* Error: Invalid logical grid or resolution.\n";
-            return resultPath;
+            return std::vector<int>();
         }
 
-        // Validate and create elevation sampler (constructor throws on error)
-         // Wrap in try-catch if constructor exceptions need graceful handling here
+        // Legacy entry point: resample elevation for this call only (constructor throws on error).
+        // Callers running several legs should build the raster/context once and use the overload below.
         ElevationSampler elevation_sampler(
             elevation_values,
             elevation_width,
@@ -55,123 +194,49 @@ namespace Pathfinding {
             origin_offset_x,
             origin_offset_y
         );
+        const ElevationRaster elevation_raster = ElevationRaster::fromSampler(
+            elevation_sampler, logical_grid.width(), logical_grid.height(), log_cell_resolution);
 
+        return findAStarPath_Tobler_Sampled(
+            makePathfindingContext(logical_grid, &elevation_raster, log_cell_resolution),
+            start, end, heuristic_type);
+    }
 
-        if (!logical_grid.inBounds(start.x, start.y) || !logical_grid.inBounds(end.x, end.y)) {
-            // std::cerr << "A* Error: Start/End out of logical bounds.\n";
-            return resultPath;
-        }
+    std::vector<int> findAStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end,
+        int heuristic_type
+    ) {
+        return findAStarPath_Tobler_Sampled(context, threadLocalSearchWorkspace(), start, end, heuristic_type);
+    }
 
-        const int startIdx = toIndex(start.x, start.y, log_width);
-        const int endIdx = toIndex(end.x, end.y, log_width);
+    std::vector<int> findAStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end,
+        int heuristic_type
+    ) {
+        // Elevation is only needed when Tobler costs are not precomputed
+        if (!searchCostsAvailable(context)) { return {}; }
+        const Grid_V3& logical_grid = *context.grid;
+        if (!logical_grid.inBounds(start.x, start.y) || !logical_grid.inBounds(end.x, end.y)) { return {}; }
 
         // Obstacle Check Start/End
         const GridCellData& startCell = logical_grid.at(start.x, start.y);
-        if (startCell.value <= 0.0f || startCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return resultPath; }
+        if (startCell.value <= 0.0f || startCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return {}; }
         const GridCellData& endCell = logical_grid.at(end.x, end.y);
-        if (endCell.value <= 0.0f || endCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return resultPath; }
-
-        if (startIdx == endIdx) { resultPath.push_back(startIdx); return resultPath; }
-
-        // --- A* Data Structures ---
-        static thread_local std::vector<float> g_scores;
-        static thread_local std::vector<float> f_scores;
-        static thread_local std::vector<bool> closed;
-        static thread_local std::vector<int> parents;
-        static thread_local std::vector<float> cell_elevation;
-        try {
-            g_scores.assign(log_size, std::numeric_limits<float>::max());
-            f_scores.assign(log_size, std::numeric_limits<float>::max());
-            closed.assign(log_size, false);
-            parents.assign(log_size, -1);
-            cell_elevation.resize(static_cast<size_t>(log_size));
-        }
-        catch (const std::bad_alloc&) { return resultPath; }
-
-        // Precompute elevation for every cell centre once to avoid repeated sampling.
-        for (int cy = 0; cy < log_height; ++cy) {
-            for (int cx = 0; cx < log_width; ++cx) {
-                float wx = (static_cast<float>(cx) + 0.5f) * log_cell_resolution;
-                float wy = (static_cast<float>(cy) + 0.5f) * log_cell_resolution;
-                cell_elevation[toIndex(cx, cy, log_width)] = elevation_sampler.getElevationAt(wx, wy);
-            }
-        }
-
-        // --- Priority Queue: store (f_score, node_index) pairs to avoid stale comparator captures ---
-        using PQEntry = std::pair<float, int>;
-        std::priority_queue<PQEntry, std::vector<PQEntry>, std::greater<PQEntry>> openQueue;
-
-        // --- Initialization ---
-        g_scores[startIdx] = 0.0f;
-        float h_start = calculate_heuristic(start.x, start.y, end.x, end.y, heuristic_type);
-        f_scores[startIdx] = h_start;
-        openQueue.push({h_start, startIdx});
-
-        // --- A* Main Loop ---
-        while (!openQueue.empty()) {
-            auto [current_f, currentIdx] = openQueue.top();
-            openQueue.pop();
+        if (endCell.value <= 0.0f || endCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return {}; }
 
-            if (currentIdx == endIdx) { break; }
-            if (closed[currentIdx]) { continue; } // stale entry
-            closed[currentIdx] = true;
-
-            int x, y;
-            toCoords(currentIdx, log_width, x, y);
-            const float current_g = g_scores[currentIdx];
-
-            // Lookup precomputed elevation for current cell.
-            float current_elevation = cell_elevation[currentIdx];
-
-            // --- Explore Neighbors ---
-            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
-                const int nx = x + dx[dir];
-                const int ny = y + dy[dir];
-
-                if (nx < 0 || nx >= log_width || ny < 0 || ny >= log_height) { continue; } // Logical bounds
-
-                const int neighborIdx = toIndex(nx, ny, log_width);
-                const GridCellData& neighborCell = logical_grid.at(nx, ny);
-
-                // Obstacle Check
-                if (neighborCell.value <= 0.0f || neighborCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { continue; }
-
-                // --- Cost Calculation via shared Tobler function ---
-                float neighbor_elevation = cell_elevation[neighborIdx];
-                float delta_h = neighbor_elevation - current_elevation;
-                float final_move_cost = toblerEdgeCost(dir, log_cell_resolution, delta_h, neighborCell.value);
-                if (final_move_cost >= std::numeric_limits<float>::max()) { continue; }
-
-                // --- Update Neighbor ---
-                float tentative_g = current_g + final_move_cost;
-
-                if (tentative_g < g_scores[neighborIdx]) {
-                    parents[neighborIdx] = currentIdx;
-                    g_scores[neighborIdx] = tentative_g;
-                    float new_f = tentative_g + calculate_heuristic(nx, ny, end.x, end.y, heuristic_type);
-                    f_scores[neighborIdx] = new_f;
-                    openQueue.push({new_f, neighborIdx});
-                }
-            } // End neighbor loop
-        } // End while openQueue not empty
-
-        // --- Path Reconstruction ---
-        if (parents[endIdx] == -1 && startIdx != endIdx) { return resultPath; }
-        std::vector<int> path_reversed;
-        int current = endIdx;
-        size_t safety_count = 0;
-        const size_t max_path_len = static_cast<size_t>(log_size) + 1;
-        while (current != -1 && safety_count < max_path_len) {
-            path_reversed.push_back(current);
-            if (current == startIdx) break;
-            current = parents[current];
-            safety_count++;
-        }
-        if (current != startIdx && startIdx != endIdx) return std::vector<int>(); // Failed
-        if (safety_count >= max_path_len) return std::vector<int>();           // Failed (cycle?)
+        if (start == end) { return { toIndex(start.x, start.y, static_cast<int>(logical_grid.width())) }; }
 
-        resultPath.assign(path_reversed.rbegin(), path_reversed.rend());
-        return resultPath;
+        return withSearchKernel(context, [&](auto queue_tag, const auto& cost_policy, auto connectivity) {
+            using OpenQueue = typename decltype(queue_tag)::type;
+            return withHeuristic(context, end, heuristic_type, [&](const auto& heuristic) {
+                return runAStar<OpenQueue, decltype(connectivity)::value>(context, workspace, start, end, cost_policy, heuristic);
+            });
+        });
     }
 
 }// namespace Pathfinding
\ No newline at end of file
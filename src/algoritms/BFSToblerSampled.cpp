@@ -1,4 +1,3 @@
-#pragma once
 #include "algoritms/BFSToblerSampled.hpp"   // Include the header declaring the function
 #include "map/MapProcessingCommon.h"
 #include "map/PathfindingUtils.hpp"
@@ -29,15 +28,38 @@ namespace Pathfinding {
         const GridPoint& start,
         const GridPoint& end
     ) {
-        const int log_width = static_cast<int>(logical_grid.width());
-        const int log_height = static_cast<int>(logical_grid.height());
-        const int log_size = log_width * log_height;
-        std::vector<int> resultPath;
-
         // --- Input Validation (Same as A*) ---
         if (!logical_grid.isValid()) { // Resolution not strictly needed for BFS core logic
+            return std::vector<int>();
+        }
+        PathfindingContext context;
+        context.grid = &logical_grid;
+        context.log_cell_resolution = (log_cell_resolution > EPSILON) ? log_cell_resolution : 1.0f;
+        return findBFSPath_Tobler_Sampled(context, start, end);
+    }
+
+    std::vector<int> findBFSPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end
+    ) {
+        return findBFSPath_Tobler_Sampled(context, threadLocalSearchWorkspace(), start, end);
+    }
+
+    std::vector<int> findBFSPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end
+    ) {
+        std::vector<int> resultPath;
+        if (!context.isValid()) {
             return resultPath;
         }
+        const Grid_V3& logical_grid = *context.grid;
+        const int log_width = static_cast<int>(logical_grid.width());
+        const int log_height = static_cast<int>(logical_grid.height());
+        const int log_size = log_width * log_height;
 
         // Elevation Sampler is NOT created or used for BFS pathfinding logic
         // ElevationSampler elevation_sampler(...); // Removed
@@ -57,21 +79,15 @@ namespace Pathfinding {
 
         if (startIdx == endIdx) { resultPath.push_back(startIdx); return resultPath; }
 
-        // --- BFS Data Structures ---
-        // No costs (g_scores, f_scores) needed
-        static thread_local std::vector<bool> visited; // Replaces 'closed' set
-        static thread_local std::vector<int> parents;  // Path reconstruction
-        try {
-            visited.assign(log_size, false);
-            parents.assign(log_size, -1);
-        }
-        catch (const std::bad_alloc&) { return resultPath; }
+        // --- Search state: generation-stamped, so no O(grid) reset per query ---
+        if (!workspace.beginQuery(static_cast<size_t>(log_size))) { return resultPath; }
 
         // --- Queue (FIFO) ---
         std::queue<int> openQueue; // Standard queue for BFS
 
         // --- Initialization ---
-        visited[startIdx] = true; // Mark start as visited
+        workspace.close(startIdx); // Mark start as visited
+        workspace.setScore(startIdx, 0.0f, -1);
         openQueue.push(startIdx); // Enqueue start node
 
         // --- BFS Main Loop ---
@@ -98,7 +114,7 @@ namespace Pathfinding {
                 const int neighborIdx = toIndex(nx, ny, log_width);
 
                 // Check if visited *before* checking grid obstacles for efficiency
-                if (visited[neighborIdx]) { continue; }
+                if (workspace.isClosed(neighborIdx)) { continue; }
 
                 const GridCellData& neighborCell = logical_grid.at(nx, ny);
 
@@ -110,8 +126,8 @@ namespace Pathfinding {
                 // --- Process Unvisited, Valid Neighbor ---
                 // No cost calculation needed for BFS
 
-                visited[neighborIdx] = true;      // Mark as visited
-                parents[neighborIdx] = currentIdx; // Set parent for path reconstruction
+                workspace.close(neighborIdx);     // Mark as visited
+                workspace.setScore(neighborIdx, workspace.g(currentIdx) + 1.0f, currentIdx); // Hop count + parent for reconstruction
                 openQueue.push(neighborIdx);      // Enqueue the neighbor
             } // End neighbor loop
         } // End while openQueue not empty
@@ -119,7 +135,7 @@ namespace Pathfinding {
         // --- Path Reconstruction (Same as A*) ---
         if (!found) { return resultPath; } // If loop finished without finding endIdx
 
-        // Path reconstruction logic remains identical using the parents array
+        // Path reconstruction logic remains identical using the workspace parents
         std::vector<int> path_reversed;
         int current = endIdx;
         size_t safety_count = 0;
@@ -127,7 +143,7 @@ namespace Pathfinding {
         while (current != -1 && safety_count < max_path_len) {
             path_reversed.push_back(current);
             if (current == startIdx) break;
-            current = parents[current];
+            current = workspace.parent(current);
             safety_count++;
         }
         // Check if reconstruction succeeded
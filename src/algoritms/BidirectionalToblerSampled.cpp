@@ -0,0 +1,186 @@
+// File: BidirectionalToblerSampled.cpp
+
+#include "algoritms/BidirectionalToblerSampled.hpp"
+#include "map/MapProcessingCommon.h"
+#include "map/PathfindingUtils.hpp"
+#include "map/ElevationRaster.hpp"
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"
+#include "algoritms/SearchQueues.hpp"
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        /**
+         * @brief Tobler cost of the edge from -> to, where to = from + (dx[dir], dy[dir]).
+         * Caller guarantees both cells are in bounds and `from` is passable.
+         */
+        inline float edgeCost(const Grid_V3& grid, const ElevationRaster* elevation, const EdgeCostCache* edge_costs,
+            float log_cell_resolution, int fromIdx, int toIdx, int dir)
+        {
+            if (edge_costs != nullptr) { return edge_costs->cost(fromIdx, dir); }
+            const GridCellData& toCell = grid.data()[static_cast<size_t>(toIdx)];
+            if (!isPassable(toCell)) { return std::numeric_limits<float>::max(); }
+            const float delta_h = elevation->atIndex(toIdx) - elevation->atIndex(fromIdx);
+            return toblerStepCost(dir, log_cell_resolution, delta_h, toCell.value);
+        }
+
+        template <typename OpenQueue>
+        std::vector<int> runBidirectional(
+            const PathfindingContext& context,
+            SearchWorkspace& fwd,
+            SearchWorkspace& bwd,
+            const GridPoint& start,
+            const GridPoint& end,
+            bool use_heuristic)
+        {
+            std::vector<int> resultPath;
+            const EdgeCostCache* edge_costs = context.hasEdgeCosts() ? context.edge_costs : nullptr;
+            if (!context.isValid() || (edge_costs == nullptr && !context.hasElevation())) {
+                return resultPath;
+            }
+            const Grid_V3& grid = *context.grid;
+            const ElevationRaster* elevation = context.elevation;
+            const float res = context.log_cell_resolution;
+            const int width = static_cast<int>(grid.width());
+            const int height = static_cast<int>(grid.height());
+            const int size = width * height;
+
+            if (!grid.inBounds(start.x, start.y) || !grid.inBounds(end.x, end.y)) { return resultPath; }
+            if (!isPassable(grid.at(start.x, start.y)) || !isPassable(grid.at(end.x, end.y))) { return resultPath; }
+            const int startIdx = toIndex(start.x, start.y, width);
+            const int endIdx = toIndex(end.x, end.y, width);
+            if (startIdx == endIdx) { resultPath.push_back(startIdx); return resultPath; }
+
+            if (!fwd.beginQuery(static_cast<size_t>(size)) || !bwd.beginQuery(static_cast<size_t>(size))) { return resultPath; }
+
+            // Average potential: p_f(v) = (h_end(v) - h_start(v)) / 2, backward uses -p_f. Zero for plain Dijkstra.
+            const float h_scale = use_heuristic ? context.min_terrain_cost : 0.0f;
+            auto forwardPotential = [&](int x, int y) {
+                if (h_scale <= 0.0f) { return 0.0f; }
+                return 0.5f * h_scale * (internal::euclidean_distance(x, y, end.x, end.y) -
+                    internal::euclidean_distance(x, y, start.x, start.y));
+            };
+
+            OpenQueue forwardQueue;
+            OpenQueue backwardQueue;
+            fwd.setScore(startIdx, 0.0f, -1);
+            bwd.setScore(endIdx, 0.0f, -1);
+            float lastForwardKey = forwardPotential(start.x, start.y);
+            float lastBackwardKey = -forwardPotential(end.x, end.y);
+            forwardQueue.push(lastForwardKey, startIdx);
+            backwardQueue.push(lastBackwardKey, endIdx);
+
+            float best = std::numeric_limits<float>::max(); // Best start -> end cost seen so far (mu)
+            int meetIdx = -1;
+
+            while (!forwardQueue.empty() && !backwardQueue.empty()) {
+                // Advance the side with the smaller frontier
+                const bool forward = forwardQueue.size() <= backwardQueue.size();
+                OpenQueue& queue = forward ? forwardQueue : backwardQueue;
+                SearchWorkspace& own = forward ? fwd : bwd;
+                const SearchWorkspace& other = forward ? bwd : fwd;
+
+                const auto [key, currentIdx] = queue.popMin();
+                if (own.isClosed(currentIdx)) { continue; } // stale entry
+                (forward ? lastForwardKey : lastBackwardKey) = key;
+
+                // Stopping criterion: no unexplored path can beat the best meeting cost.
+                // The last popped keys are lower bounds on the two queue minima.
+                if (lastForwardKey + lastBackwardKey >= best) { break; }
+                own.close(currentIdx);
+
+                int x, y;
+                toCoords(currentIdx, width, x, y);
+                const float current_g = own.g(currentIdx);
+
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    // Forward walks edges current -> neighbour; backward walks them in reverse (neighbour -> current)
+                    const int nx = forward ? x + dx[dir] : x - dx[dir];
+                    const int ny = forward ? y + dy[dir] : y - dy[dir];
+                    if (nx < 0 || nx >= width || ny < 0 || ny >= height) { continue; }
+                    const int neighborIdx = toIndex(nx, ny, width);
+                    if (own.isClosed(neighborIdx)) { continue; }
+
+                    float move_cost;
+                    if (forward) {
+                        move_cost = edgeCost(grid, elevation, edge_costs, res, currentIdx, neighborIdx, dir);
+                    }
+                    else {
+                        // The reversed edge starts at the neighbour, so it must be passable itself
+                        if (!isPassable(grid.data()[static_cast<size_t>(neighborIdx)])) { continue; }
+                        move_cost = edgeCost(grid, elevation, edge_costs, res, neighborIdx, currentIdx, dir);
+                    }
+                    if (move_cost >= std::numeric_limits<float>::max()) { continue; }
+
+                    const float tentative_g = current_g + move_cost;
+                    if (tentative_g < own.g(neighborIdx)) {
+                        own.setScore(neighborIdx, tentative_g, currentIdx);
+                        const float potential = forward ? forwardPotential(nx, ny) : -forwardPotential(nx, ny);
+                        queue.push(tentative_g + potential, neighborIdx);
+
+                        const float other_g = other.g(neighborIdx);
+                        if (other_g < std::numeric_limits<float>::max() && tentative_g + other_g < best) {
+                            best = tentative_g + other_g;
+                            meetIdx = neighborIdx;
+                        }
+                    }
+                }
+            }
+
+            if (meetIdx == -1) { return resultPath; } // The searches never met: no path
+
+            // --- Path Reconstruction: start -> meet from the forward tree, meet -> end from the backward tree ---
+            const size_t max_path_len = static_cast<size_t>(size) + 1;
+            std::vector<int> forward_part;
+            for (int current = meetIdx; current != -1 && forward_part.size() < max_path_len; current = fwd.parent(current)) {
+                forward_part.push_back(current);
+            }
+            if (forward_part.empty() || forward_part.back() != startIdx) { return resultPath; }
+            resultPath.assign(forward_part.rbegin(), forward_part.rend());
+
+            size_t safety_count = 0;
+            for (int current = bwd.parent(meetIdx); current != -1 && safety_count < max_path_len; current = bwd.parent(current), ++safety_count) {
+                resultPath.push_back(current);
+            }
+            if (resultPath.back() != endIdx) { return std::vector<int>(); }
+            return resultPath;
+        }
+
+    } // end anonymous namespace
+
+    std::vector<int> findBidirectionalPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& forward_workspace,
+        SearchWorkspace& backward_workspace,
+        const GridPoint& start,
+        const GridPoint& end,
+        bool use_heuristic
+    ) {
+        if (&forward_workspace == &backward_workspace) { return std::vector<int>(); } // Each side needs its own state
+        if (context.queue_type == QueueType::RadixHeap) {
+            return runBidirectional<RadixHeapQueue>(context, forward_workspace, backward_workspace, start, end, use_heuristic);
+        }
+        return runBidirectional<BinaryHeapQueue>(context, forward_workspace, backward_workspace, start, end, use_heuristic);
+    }
+
+    std::vector<int> findBidirectionalPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end,
+        bool use_heuristic
+    ) {
+        static thread_local SearchWorkspace backward_workspace;
+        return findBidirectionalPath_Tobler_Sampled(context, threadLocalSearchWorkspace(), backward_workspace, start, end, use_heuristic);
+    }
+
+} // namespace Pathfinding
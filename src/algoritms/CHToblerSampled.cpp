@@ -0,0 +1,143 @@
+// File: CHToblerSampled.cpp
+
+#include "algoritms/CHToblerSampled.hpp"
+#include "algoritms/ContractionHierarchy.hpp"
+#include "algoritms/SearchQueues.hpp"
+#include "map/MapProcessingCommon.h"
+#include "map/PathfindingUtils.hpp"
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        template <typename OpenQueue>
+        std::vector<int> runCHQuery(
+            const ContractionHierarchy& ch,
+            SearchWorkspace& fwd,
+            SearchWorkspace& bwd,
+            int startIdx,
+            int endIdx)
+        {
+            std::vector<int> resultPath;
+            const size_t size = static_cast<size_t>(ch.width()) * static_cast<size_t>(ch.height());
+            if (!fwd.beginQuery(size) || !bwd.beginQuery(size)) { return resultPath; }
+
+            OpenQueue forwardQueue;
+            OpenQueue backwardQueue;
+            fwd.setScore(startIdx, 0.0f, -1);
+            forwardQueue.push(0.0f, startIdx);
+            bwd.setScore(endIdx, 0.0f, -1);
+            backwardQueue.push(0.0f, endIdx);
+
+            float best = std::numeric_limits<float>::max();
+            int meetIdx = -1;
+            bool forward_done = false;
+            bool backward_done = false;
+            bool forward = false;
+
+            while (!forward_done || !backward_done) {
+                // Alternate sides; a side is finished once its queue is empty or its smallest key reaches best
+                forward = backward_done ? true : (forward_done ? false : !forward);
+                OpenQueue& queue = forward ? forwardQueue : backwardQueue;
+                SearchWorkspace& own = forward ? fwd : bwd;
+                const SearchWorkspace& other = forward ? bwd : fwd;
+                bool& done = forward ? forward_done : backward_done;
+
+                if (queue.empty()) { done = true; continue; }
+                const auto [key, current] = queue.popMin();
+                if (key >= best) { done = true; continue; }
+                if (own.isClosed(current)) { continue; } // stale entry
+                own.close(current);
+
+                const float current_g = own.g(current);
+                const float other_g = other.g(current);
+                if (other_g < std::numeric_limits<float>::max() && current_g + other_g < best) {
+                    best = current_g + other_g;
+                    meetIdx = current;
+                }
+
+                // Stall-on-demand: a higher cell already offers a cheaper way here, so nothing above is optimal via this one
+                const ContractionHierarchy::Arc* stallBegin = forward ? ch.downBegin(current) : ch.upBegin(current);
+                const ContractionHierarchy::Arc* stallEnd = forward ? ch.downEnd(current) : ch.upEnd(current);
+                bool stalled = false;
+                for (const ContractionHierarchy::Arc* a = stallBegin; a != stallEnd; ++a) {
+                    if (own.g(a->node) + a->weight < current_g) { stalled = true; break; }
+                }
+                if (stalled) { continue; }
+
+                // Forward relaxes current -> higher; backward relaxes higher -> current in reverse
+                const ContractionHierarchy::Arc* arcBegin = forward ? ch.upBegin(current) : ch.downBegin(current);
+                const ContractionHierarchy::Arc* arcEnd = forward ? ch.upEnd(current) : ch.downEnd(current);
+                for (const ContractionHierarchy::Arc* a = arcBegin; a != arcEnd; ++a) {
+                    const float tentative = current_g + a->weight;
+                    if (tentative < own.g(a->node)) {
+                        own.setScore(a->node, tentative, current);
+                        queue.push(tentative, a->node);
+                    }
+                }
+            }
+
+            if (meetIdx == -1) { return resultPath; } // The searches never met: no path
+
+            // --- Path Reconstruction: CH path start -> meet -> end, then every arc unpacked to grid steps ---
+            std::vector<int> chPath;
+            for (int current = meetIdx; current != -1; current = fwd.parent(current)) { chPath.push_back(current); }
+            std::reverse(chPath.begin(), chPath.end());
+            for (int current = bwd.parent(meetIdx); current != -1; current = bwd.parent(current)) { chPath.push_back(current); }
+            if (chPath.front() != startIdx || chPath.back() != endIdx) { return resultPath; }
+
+            resultPath.push_back(startIdx);
+            for (size_t i = 0; i + 1 < chPath.size(); ++i) {
+                if (!ch.unpackArc(chPath[i], chPath[i + 1], resultPath)) { return std::vector<int>(); }
+            }
+            return resultPath;
+        }
+
+    } // end anonymous namespace
+
+    std::vector<int> findCHPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& forward_workspace,
+        SearchWorkspace& backward_workspace,
+        const GridPoint& start,
+        const GridPoint& end
+    ) {
+        std::vector<int> resultPath;
+        const ContractionHierarchy* ch = context.contraction;
+        if (!context.isValid() || ch == nullptr || !ch->isValid()) { return resultPath; }
+        if (&forward_workspace == &backward_workspace) { return resultPath; } // Each side needs its own state
+        const Grid_V3& logical_grid = *context.grid;
+        const int log_width = static_cast<int>(logical_grid.width());
+        if (ch->width() != log_width || ch->height() != static_cast<int>(logical_grid.height())) { return resultPath; }
+
+        if (!logical_grid.inBounds(start.x, start.y) || !logical_grid.inBounds(end.x, end.y)) { return resultPath; }
+        const int startIdx = toIndex(start.x, start.y, log_width);
+        const int endIdx = toIndex(end.x, end.y, log_width);
+
+        // Obstacle Check Start/End (impassable cells are not in the hierarchy)
+        if (ch->rank(startIdx) < 0 || ch->rank(endIdx) < 0) { return resultPath; }
+        if (startIdx == endIdx) { resultPath.push_back(startIdx); return resultPath; }
+
+        if (context.queue_type == QueueType::RadixHeap) {
+            return runCHQuery<RadixHeapQueue>(*ch, forward_workspace, backward_workspace, startIdx, endIdx);
+        }
+        return runCHQuery<BinaryHeapQueue>(*ch, forward_workspace, backward_workspace, startIdx, endIdx);
+    }
+
+    std::vector<int> findCHPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end
+    ) {
+        static thread_local SearchWorkspace backward_workspace;
+        return findCHPath_Tobler_Sampled(context, threadLocalSearchWorkspace(), backward_workspace, start, end);
+    }
+
+} // namespace Pathfinding
@@ -0,0 +1,701 @@
+// File: ContractionHierarchy.cpp
+
+#include "algoritms/ContractionHierarchy.hpp"
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"
+#include "map/PathfindingUtils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+#include <omp.h>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        using Arc = ContractionHierarchy::Arc;
+        using ArcLists = std::vector<std::vector<Arc>>;
+
+        constexpr float INF = std::numeric_limits<float>::max();
+
+        // Direction of the grid step from -> to, -1 if the cells are not neighbours (a shortcut)
+        int stepDirection(int from, int to, int width) {
+            int fx, fy, tx, ty;
+            toCoords(from, width, fx, fy);
+            toCoords(to, width, tx, ty);
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                if (fx + dx[dir] == tx && fy + dy[dir] == ty) { return dir; }
+            }
+            return -1;
+        }
+
+        struct Shortcut {
+            int from;
+            int to;
+            float weight;
+            int middle;
+        };
+
+        // Bounded Dijkstra over the not yet contracted graph (one per thread, reused across searches)
+        class WitnessSearch {
+        public:
+            bool init(std::size_t node_count) {
+                try {
+                    dist_.assign(node_count, INF);
+                    stamp_.assign(node_count, 0);
+                    target_stamp_.assign(node_count, 0);
+                    target_via_.assign(node_count, 0.0f);
+                    heap_.reserve(256);
+                }
+                catch (const std::bad_alloc&) {
+                    return false;
+                }
+                return true;
+            }
+
+            /**
+             * Searches from source for witnesses, never entering `avoid` or a cell flagged in `excluded`
+             * (may be null). via_cost is the cost of each target (out arc of avoid) through avoid. Stops
+             * once every target has a path of at most its via cost, once the smallest key exceeds the
+             * largest via cost still unmatched, or after settle_limit settled cells.
+             */
+            void run(const ArcLists& out, int source, int avoid, const std::vector<char>* excluded,
+                const std::vector<Arc>& targets, float in_weight, int settle_limit)
+            {
+                if (++generation_ == 0) {
+                    std::fill(stamp_.begin(), stamp_.end(), 0u);
+                    std::fill(target_stamp_.begin(), target_stamp_.end(), 0u);
+                    generation_ = 1;
+                }
+                int unmatched = 0;
+                for (const Arc& t : targets) {
+                    if (t.node == source) { continue; }
+                    target_stamp_[static_cast<std::size_t>(t.node)] = generation_;
+                    target_via_[static_cast<std::size_t>(t.node)] = in_weight + t.weight;
+                    ++unmatched;
+                }
+                float bound = maxUnmatched(targets, source);
+                heap_.clear();
+                setDist(source, 0.0f);
+                push(0.0f, source);
+                int settled = 0;
+                while (!heap_.empty() && unmatched > 0) {
+                    std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+                    const auto [key, current] = heap_.back();
+                    heap_.pop_back();
+                    if (key > dist(current)) { continue; } // stale entry
+                    if (key > bound) {
+                        bound = maxUnmatched(targets, source);
+                        if (key > bound) { break; }
+                    }
+                    if (++settled > settle_limit) { break; }
+                    for (const Arc& arc : out[static_cast<std::size_t>(current)]) {
+                        const std::size_t next = static_cast<std::size_t>(arc.node);
+                        if (arc.node == avoid || (excluded != nullptr && (*excluded)[next])) { continue; }
+                        const float tentative = key + arc.weight;
+                        const float old = dist(arc.node);
+                        if (tentative < old) {
+                            setDist(arc.node, tentative);
+                            push(tentative, arc.node);
+                            if (target_stamp_[next] == generation_ && tentative <= target_via_[next] && old > target_via_[next]) { --unmatched; }
+                        }
+                    }
+                }
+            }
+
+            float dist(int node) const {
+                return stamp_[static_cast<std::size_t>(node)] == generation_ ? dist_[static_cast<std::size_t>(node)] : INF;
+            }
+
+            std::size_t memoryBytes() const { return dist_.size() * (2 * sizeof(float) + 2 * sizeof(std::uint32_t)); }
+
+        private:
+            float maxUnmatched(const std::vector<Arc>& targets, int source) const {
+                float result = -1.0f;
+                for (const Arc& t : targets) {
+                    const std::size_t n = static_cast<std::size_t>(t.node);
+                    if (t.node != source && dist(t.node) > target_via_[n]) { result = std::max(result, target_via_[n]); }
+                }
+                return result;
+            }
+
+            void setDist(int node, float d) {
+                stamp_[static_cast<std::size_t>(node)] = generation_;
+                dist_[static_cast<std::size_t>(node)] = d;
+            }
+            void push(float key, int node) {
+                heap_.emplace_back(key, node);
+                std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+            }
+
+            std::vector<float> dist_;
+            std::vector<std::uint32_t> stamp_;
+            std::vector<std::uint32_t> target_stamp_; // Out-neighbours of the contracted cell, per generation
+            std::vector<float> target_via_;           // Their cost through the contracted cell
+            std::uint32_t generation_ = 0;
+            std::vector<std::pair<float, int>> heap_;
+        };
+
+        /**
+         * Shortcuts needed to contract v: one per in/out neighbour pair (u, x) without a witness path
+         * u -> x of at most the cost via v. Returns their number; collects them if shortcuts is set.
+         */
+        int contractNode(const ArcLists& out, const ArcLists& in, int v, WitnessSearch& search,
+            const std::vector<char>* excluded, int settle_limit, std::vector<Shortcut>* shortcuts)
+        {
+            int count = 0;
+            const std::vector<Arc>& out_v = out[static_cast<std::size_t>(v)];
+            for (const Arc& in_arc : in[static_cast<std::size_t>(v)]) {
+                const int u = in_arc.node;
+                search.run(out, u, v, excluded, out_v, in_arc.weight, settle_limit);
+                for (const Arc& out_arc : out_v) {
+                    if (out_arc.node == u) { continue; }
+                    const float via = in_arc.weight + out_arc.weight;
+                    if (search.dist(out_arc.node) > via) {
+                        ++count;
+                        if (shortcuts != nullptr) { shortcuts->push_back({ u, out_arc.node, via, v }); }
+                    }
+                }
+            }
+            return count;
+        }
+
+        // Adds arc from -> to, or lowers an existing one (keeps at most one arc per ordered pair)
+        void insertArc(ArcLists& out, ArcLists& in, const Shortcut& s, std::ptrdiff_t& arc_delta) {
+            for (Arc& arc : out[static_cast<std::size_t>(s.from)]) {
+                if (arc.node != s.to) { continue; }
+                if (s.weight < arc.weight) {
+                    arc.weight = s.weight;
+                    arc.middle = s.middle;
+                    for (Arc& back : in[static_cast<std::size_t>(s.to)]) {
+                        if (back.node == s.from) { back.weight = s.weight; back.middle = s.middle; break; }
+                    }
+                }
+                return;
+            }
+            out[static_cast<std::size_t>(s.from)].push_back({ s.to, s.weight, s.middle });
+            in[static_cast<std::size_t>(s.to)].push_back({ s.from, s.weight, s.middle });
+            arc_delta += 2;
+        }
+
+        /**
+         * Customizable contraction of v: adds every missing arc u -> x between its in- and out-neighbours,
+         * with weight max() (customize() sets the weights). stamp marks the heads of out[u].
+         */
+        void addFillArcs(ArcLists& out, ArcLists& in, int v, std::vector<std::uint32_t>& stamp, std::uint32_t& generation,
+            std::ptrdiff_t& arc_delta, std::size_t& added)
+        {
+            for (const Arc& in_arc : in[static_cast<std::size_t>(v)]) {
+                const int u = in_arc.node;
+                if (++generation == 0) {
+                    std::fill(stamp.begin(), stamp.end(), 0u);
+                    generation = 1;
+                }
+                for (const Arc& a : out[static_cast<std::size_t>(u)]) { stamp[static_cast<std::size_t>(a.node)] = generation; }
+                for (const Arc& out_arc : out[static_cast<std::size_t>(v)]) {
+                    const int x = out_arc.node;
+                    if (x == u || stamp[static_cast<std::size_t>(x)] == generation) { continue; }
+                    out[static_cast<std::size_t>(u)].push_back({ x, INF, v });
+                    in[static_cast<std::size_t>(x)].push_back({ u, INF, v });
+                    arc_delta += 2;
+                    ++added;
+                }
+            }
+        }
+
+        void removeArcsTo(std::vector<Arc>& arcs, int node) {
+            arcs.erase(std::remove_if(arcs.begin(), arcs.end(), [node](const Arc& a) { return a.node == node; }), arcs.end());
+        }
+
+        /**
+         * Nested dissection of the rectangle [x0, x1) x [y0, y1): both halves of the longer side first,
+         * then the line between them, which separates them on the 8-connected grid. Contracting in this
+         * order without witnesses keeps the fill-in near O(n log n), unlike a greedy order.
+         */
+        void dissect(int x0, int y0, int x1, int y1, int width, std::vector<int>& position, int& next) {
+            if ((x1 - x0) * (y1 - y0) <= 4) {
+                for (int y = y0; y < y1; ++y) {
+                    for (int x = x0; x < x1; ++x) { position[static_cast<std::size_t>(toIndex(x, y, width))] = next++; }
+                }
+                return;
+            }
+            if (x1 - x0 >= y1 - y0) {
+                const int mid = x0 + (x1 - x0) / 2;
+                dissect(x0, y0, mid, y1, width, position, next);
+                dissect(mid + 1, y0, x1, y1, width, position, next);
+                for (int y = y0; y < y1; ++y) { position[static_cast<std::size_t>(toIndex(mid, y, width))] = next++; }
+            }
+            else {
+                const int mid = y0 + (y1 - y0) / 2;
+                dissect(x0, y0, x1, mid, width, position, next);
+                dissect(x0, mid + 1, x1, y1, width, position, next);
+                for (int x = x0; x < x1; ++x) { position[static_cast<std::size_t>(toIndex(x, mid, width))] = next++; }
+            }
+        }
+
+        // Spatially uncorrelated tie-break, so equal priorities do not contract the grid row by row
+        std::uint32_t tieBreak(int node) { return static_cast<std::uint32_t>(node) * 2654435761u; }
+
+    } // end anonymous namespace
+
+    ContractionHierarchy ContractionHierarchy::build(const PathfindingContext& context, const Settings& settings) {
+        ContractionHierarchy result;
+        const EdgeCostCache* edge_costs = context.hasEdgeCosts() ? context.edge_costs : nullptr;
+        if (!context.isValid() || (edge_costs == nullptr && !context.hasElevation())) { return result; }
+        const Grid_V3& grid = *context.grid;
+        const int width = static_cast<int>(grid.width());
+        const int height = static_cast<int>(grid.height());
+        if (grid.width() * grid.height() > MAX_CELLS) { return result; }
+        const int node_count = width * height;
+        const int witness_limit = std::max(1, settings.witness_settle_limit);
+        const int priority_limit = std::max(1, settings.priority_settle_limit);
+        const bool customizable = settings.customizable; // No witness searches: fill arcs instead, fixed order
+
+        try {
+            // --- Grid graph: out[v] holds v -> w, in[v] holds w -> v ---
+            ArcLists out(static_cast<std::size_t>(node_count));
+            ArcLists in(static_cast<std::size_t>(node_count));
+#pragma omp parallel for schedule(dynamic, 16)
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    if (!isPassable(grid, x, y)) { continue; }
+                    const int idx = toIndex(x, y, width);
+                    for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                        const int nx = x + dx[dir];
+                        const int ny = y + dy[dir];
+                        if (nx < 0 || nx >= width || ny < 0 || ny >= height || !isPassable(grid, nx, ny)) { continue; }
+                        const int neighborIdx = toIndex(nx, ny, width);
+                        // Both lists of a cell are filled by the thread that owns the cell's row. A customizable
+                        // topology keeps impossible steps too (as max()), since other costs may allow them.
+                        const float cost_out = stepCost(context, edge_costs, x, y, dir);
+                        if (cost_out < INF || customizable) { out[static_cast<std::size_t>(idx)].push_back({ neighborIdx, cost_out, -1 }); }
+                        const float cost_in = stepCost(context, edge_costs, nx, ny, reverse_dir[dir]);
+                        if (cost_in < INF || customizable) { in[static_cast<std::size_t>(idx)].push_back({ neighborIdx, cost_in, -1 }); }
+                    }
+                }
+            }
+
+            std::vector<int> remaining;
+            std::ptrdiff_t live_arcs = 0;
+            for (int v = 0; v < node_count; ++v) {
+                if (isPassable(grid, v % width, v / width)) {
+                    remaining.push_back(v);
+                    live_arcs += static_cast<std::ptrdiff_t>(out[static_cast<std::size_t>(v)].size() + in[static_cast<std::size_t>(v)].size());
+                }
+            }
+
+            const int thread_count = omp_get_max_threads();
+            std::vector<WitnessSearch> searches(static_cast<std::size_t>(thread_count));
+            for (WitnessSearch& search : searches) {
+                if (!customizable && !search.init(static_cast<std::size_t>(node_count))) { return ContractionHierarchy(); }
+            }
+
+            std::vector<int> priority(static_cast<std::size_t>(node_count), 0);
+            std::vector<int> deleted_neighbors(static_cast<std::size_t>(node_count), 0);
+            std::vector<int> level(static_cast<std::size_t>(node_count), 0);
+            std::vector<char> in_round(static_cast<std::size_t>(node_count), 0);
+            std::vector<char> dirty(static_cast<std::size_t>(node_count), 0);
+            std::vector<int> rank(static_cast<std::size_t>(node_count), -1);
+            std::vector<std::uint32_t> fill_stamp(customizable ? static_cast<std::size_t>(node_count) : 0, 0u);
+            std::uint32_t fill_generation = 0;
+            ArcLists up(static_cast<std::size_t>(node_count));
+            ArcLists down(static_cast<std::size_t>(node_count));
+
+            // Edge difference (simulated with cheap witness searches), plus terms that spread contraction evenly.
+            // A customizable hierarchy uses the fixed nested-dissection position instead.
+            auto computePriority = [&](int v) {
+                if (customizable) { return; }
+                WitnessSearch& search = searches[static_cast<std::size_t>(omp_get_thread_num())];
+                const int shortcuts = contractNode(out, in, v, search, nullptr, priority_limit, nullptr);
+                const int removed = static_cast<int>(out[static_cast<std::size_t>(v)].size() + in[static_cast<std::size_t>(v)].size());
+                priority[static_cast<std::size_t>(v)] = 2 * (shortcuts - removed) + deleted_neighbors[static_cast<std::size_t>(v)] + level[static_cast<std::size_t>(v)];
+            };
+            auto before = [&](int a, int b) {
+                const int pa = priority[static_cast<std::size_t>(a)], pb = priority[static_cast<std::size_t>(b)];
+                return pa != pb ? pa < pb : tieBreak(a) < tieBreak(b);
+            };
+
+            if (customizable) {
+                int next_position = 0;
+                dissect(0, 0, width, height, width, priority, next_position);
+            }
+            const int remaining_count = static_cast<int>(remaining.size());
+#pragma omp parallel for schedule(dynamic, 256)
+            for (int i = 0; i < remaining_count; ++i) { computePriority(remaining[static_cast<std::size_t>(i)]); }
+
+            const std::size_t fixed_bytes = static_cast<std::size_t>(node_count) *
+                (4 * sizeof(std::vector<Arc>) + 4 * sizeof(int) + 2 * sizeof(char)) +
+                static_cast<std::size_t>(thread_count) * searches.front().memoryBytes();
+            std::size_t final_arcs = 0;
+            std::size_t peak_bytes = 0;
+            std::size_t shortcut_count = 0;
+            int next_rank = 0;
+            int rounds = 0;
+            std::vector<int> selected;
+            std::vector<std::vector<Shortcut>> round_shortcuts;
+
+            while (!remaining.empty()) {
+                ++rounds;
+                // --- Select cells that come before all their neighbours: an independent set ---
+                const int count = static_cast<int>(remaining.size());
+#pragma omp parallel for schedule(dynamic, 256)
+                for (int i = 0; i < count; ++i) {
+                    const int v = remaining[static_cast<std::size_t>(i)];
+                    bool is_min = true;
+                    for (const ArcLists* lists : { &out, &in }) {
+                        for (const Arc& a : (*lists)[static_cast<std::size_t>(v)]) {
+                            if (before(a.node, v)) { is_min = false; break; }
+                        }
+                        if (!is_min) { break; }
+                    }
+                    in_round[static_cast<std::size_t>(v)] = is_min ? 1 : 0;
+                }
+                selected.clear();
+                for (int v : remaining) {
+                    if (in_round[static_cast<std::size_t>(v)]) { selected.push_back(v); }
+                }
+
+                // Lazy priority updates: only candidates whose neighbourhood changed are re-simulated, then re-checked
+                const int candidate_count = static_cast<int>(selected.size());
+#pragma omp parallel for schedule(dynamic, 16)
+                for (int i = 0; i < candidate_count; ++i) {
+                    const int v = selected[static_cast<std::size_t>(i)];
+                    if (!dirty[static_cast<std::size_t>(v)]) { continue; }
+                    dirty[static_cast<std::size_t>(v)] = 0;
+                    computePriority(v);
+                }
+                selected.erase(std::remove_if(selected.begin(), selected.end(), [&](int v) {
+                    for (const ArcLists* lists : { &out, &in }) {
+                        for (const Arc& a : (*lists)[static_cast<std::size_t>(v)]) {
+                            if (before(a.node, v)) { in_round[static_cast<std::size_t>(v)] = 0; return true; }
+                        }
+                    }
+                    return false;
+                }), selected.end());
+
+                // --- Witness searches against the graph before the round, avoiding every selected cell ---
+                const int selected_count = static_cast<int>(selected.size());
+                round_shortcuts.resize(static_cast<std::size_t>(selected_count));
+#pragma omp parallel for schedule(dynamic, 16) if(!customizable)
+                for (int i = 0; i < selected_count; ++i) {
+                    if (customizable) { continue; }
+                    std::vector<Shortcut>& shortcuts = round_shortcuts[static_cast<std::size_t>(i)];
+                    shortcuts.clear();
+                    WitnessSearch& search = searches[static_cast<std::size_t>(omp_get_thread_num())];
+                    contractNode(out, in, selected[static_cast<std::size_t>(i)], search, &in_round, witness_limit, &shortcuts);
+                }
+
+                // --- Contract (serial: selected cells may share neighbours; cheap next to the searches) ---
+                std::ptrdiff_t arc_delta = 0;
+                std::size_t added = 0;
+                for (int i = 0; i < selected_count; ++i) {
+                    const int v = selected[static_cast<std::size_t>(i)];
+                    std::vector<Arc>& out_v = out[static_cast<std::size_t>(v)];
+                    std::vector<Arc>& in_v = in[static_cast<std::size_t>(v)];
+                    const int next_level = level[static_cast<std::size_t>(v)] + 1;
+                    for (const std::vector<Arc>* own : { &out_v, &in_v }) {
+                        for (const Arc& a : *own) {
+                            const std::size_t n = static_cast<std::size_t>(a.node);
+                            ++deleted_neighbors[n];
+                            level[n] = std::max(level[n], next_level);
+                            dirty[n] = 1;
+                        }
+                    }
+                    for (const Arc& a : out_v) { removeArcsTo(in[static_cast<std::size_t>(a.node)], v); }
+                    for (const Arc& a : in_v) { removeArcsTo(out[static_cast<std::size_t>(a.node)], v); }
+                    arc_delta -= 2 * static_cast<std::ptrdiff_t>(out_v.size() + in_v.size());
+                    if (customizable) {
+                        addFillArcs(out, in, v, fill_stamp, fill_generation, arc_delta, added);
+                    }
+                    for (const Shortcut& s : round_shortcuts[static_cast<std::size_t>(i)]) {
+                        const std::ptrdiff_t before_insert = arc_delta;
+                        insertArc(out, in, s, arc_delta);
+                        if (arc_delta != before_insert) { ++added; }
+                    }
+                    // The remaining arcs of v all lead to cells contracted later: they become its upward arcs
+                    up[static_cast<std::size_t>(v)] = std::move(out_v);
+                    down[static_cast<std::size_t>(v)] = std::move(in_v);
+                    std::vector<Arc>().swap(out_v);
+                    std::vector<Arc>().swap(in_v);
+                }
+                live_arcs += arc_delta;
+                shortcut_count += added;
+
+                for (int v : selected) {
+                    rank[static_cast<std::size_t>(v)] = next_rank++;
+                    final_arcs += up[static_cast<std::size_t>(v)].size() + down[static_cast<std::size_t>(v)].size();
+                    in_round[static_cast<std::size_t>(v)] = 0;
+                }
+                remaining.erase(std::remove_if(remaining.begin(), remaining.end(),
+                    [&](int v) { return rank[static_cast<std::size_t>(v)] >= 0; }), remaining.end());
+                peak_bytes = std::max(peak_bytes, fixed_bytes + (static_cast<std::size_t>(live_arcs) + final_arcs) * sizeof(Arc));
+            }
+
+            // --- Flatten to CSR ---
+            result.up_offsets_.assign(static_cast<std::size_t>(node_count) + 1, 0);
+            result.down_offsets_.assign(static_cast<std::size_t>(node_count) + 1, 0);
+            for (int v = 0; v < node_count; ++v) {
+                result.up_offsets_[static_cast<std::size_t>(v) + 1] = result.up_offsets_[static_cast<std::size_t>(v)] + up[static_cast<std::size_t>(v)].size();
+                result.down_offsets_[static_cast<std::size_t>(v) + 1] = result.down_offsets_[static_cast<std::size_t>(v)] + down[static_cast<std::size_t>(v)].size();
+            }
+            result.up_arcs_.resize(result.up_offsets_.back());
+            result.down_arcs_.resize(result.down_offsets_.back());
+#pragma omp parallel for schedule(static)
+            for (int v = 0; v < node_count; ++v) {
+                std::copy(up[static_cast<std::size_t>(v)].begin(), up[static_cast<std::size_t>(v)].end(),
+                    result.up_arcs_.begin() + static_cast<std::ptrdiff_t>(result.up_offsets_[static_cast<std::size_t>(v)]));
+                std::copy(down[static_cast<std::size_t>(v)].begin(), down[static_cast<std::size_t>(v)].end(),
+                    result.down_arcs_.begin() + static_cast<std::ptrdiff_t>(result.down_offsets_[static_cast<std::size_t>(v)]));
+            }
+
+            result.width_ = width;
+            result.height_ = height;
+            result.rounds_ = rounds;
+            result.shortcut_count_ = shortcut_count;
+            result.peak_build_bytes_ = std::max(peak_bytes, fixed_bytes + result.memoryBytes());
+            result.customizable_ = customizable;
+            result.rank_ = std::move(rank);
+
+            if (customizable) {
+                // Up and down arcs of a cell then list the same cells in the same order (see customize())
+                auto byNode = [](const Arc& a, const Arc& b) { return a.node < b.node; };
+#pragma omp parallel for schedule(dynamic, 256)
+                for (int v = 0; v < node_count; ++v) {
+                    const std::size_t n = static_cast<std::size_t>(v);
+                    std::sort(result.up_arcs_.begin() + static_cast<std::ptrdiff_t>(result.up_offsets_[n]),
+                        result.up_arcs_.begin() + static_cast<std::ptrdiff_t>(result.up_offsets_[n + 1]), byNode);
+                    std::sort(result.down_arcs_.begin() + static_cast<std::ptrdiff_t>(result.down_offsets_[n]),
+                        result.down_arcs_.begin() + static_cast<std::ptrdiff_t>(result.down_offsets_[n + 1]), byNode);
+                }
+                if (!result.customize(context)) { return ContractionHierarchy(); }
+            }
+        }
+        catch (const std::bad_alloc&) {
+            return ContractionHierarchy();
+        }
+        return result;
+    }
+
+    ContractionHierarchy ContractionHierarchy::fromArrays(int width, int height, int rounds, std::size_t shortcut_count,
+        std::vector<int> rank, std::vector<std::size_t> up_offsets, std::vector<Arc> up_arcs,
+        std::vector<std::size_t> down_offsets, std::vector<Arc> down_arcs)
+    {
+        ContractionHierarchy result;
+        if (width <= 0 || height <= 0) { return result; }
+        const std::size_t node_count = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+        if (node_count > MAX_CELLS || rank.size() != node_count ||
+            up_offsets.size() != node_count + 1 || down_offsets.size() != node_count + 1 ||
+            up_offsets.front() != 0 || down_offsets.front() != 0 ||
+            up_offsets.back() != up_arcs.size() || down_offsets.back() != down_arcs.size()) {
+            return result;
+        }
+        // Ranks must be 0 .. ranked cells - 1, each once; every arc must lead upward from a ranked cell, so
+        // queries and unpacking stay in bounds and terminate; up and down arcs must list the same cells in
+        // ascending order (see customize())
+        const int ranked = static_cast<int>(std::count_if(rank.begin(), rank.end(), [](int r) { return r >= 0; }));
+        std::vector<char> rank_seen(static_cast<std::size_t>(ranked), 0);
+        const int node_limit = static_cast<int>(node_count);
+        for (std::size_t v = 0; v < node_count; ++v) {
+            if (rank[v] < -1 || rank[v] >= ranked) { return result; }
+            if (rank[v] >= 0) {
+                if (rank_seen[static_cast<std::size_t>(rank[v])]) { return result; }
+                rank_seen[static_cast<std::size_t>(rank[v])] = 1;
+            }
+            const std::size_t begin = up_offsets[v];
+            const std::size_t end = up_offsets[v + 1];
+            if (begin > end || down_offsets[v] > down_offsets[v + 1] || end - begin != down_offsets[v + 1] - down_offsets[v] ||
+                (begin != end && rank[v] < 0)) {
+                return result;
+            }
+            for (std::size_t i = 0; i < end - begin; ++i) {
+                const Arc& a = up_arcs[begin + i];
+                const Arc& b = down_arcs[down_offsets[v] + i];
+                if (a.node < 0 || a.node >= node_limit || b.node != a.node || rank[static_cast<std::size_t>(a.node)] <= rank[v] ||
+                    (i > 0 && up_arcs[begin + i - 1].node >= a.node)) {
+                    return result;
+                }
+                for (const Arc* arc : { &a, &b }) {
+                    if (arc->middle < -1 || arc->middle >= node_limit) { return result; }
+                }
+            }
+        }
+        result.width_ = width;
+        result.height_ = height;
+        result.rounds_ = rounds;
+        result.shortcut_count_ = shortcut_count;
+        result.customizable_ = true;
+        result.rank_ = std::move(rank);
+        result.up_offsets_ = std::move(up_offsets);
+        result.up_arcs_ = std::move(up_arcs);
+        result.down_offsets_ = std::move(down_offsets);
+        result.down_arcs_ = std::move(down_arcs);
+        result.peak_build_bytes_ = result.memoryBytes();
+        return result;
+    }
+
+    bool ContractionHierarchy::customize(const PathfindingContext& context) {
+        const EdgeCostCache* edge_costs = context.hasEdgeCosts() ? context.edge_costs : nullptr;
+        if (!isValid() || !customizable_ || !context.isValid() || (edge_costs == nullptr && !context.hasElevation())) { return false; }
+        const Grid_V3& grid = *context.grid;
+        if (static_cast<int>(grid.width()) != width_ || static_cast<int>(grid.height()) != height_) { return false; }
+        const int node_count = width_ * height_;
+
+        // The topology holds only for the passable cells it was built from
+        int mismatches = 0;
+#pragma omp parallel for schedule(static) reduction(+:mismatches)
+        for (int v = 0; v < node_count; ++v) {
+            if ((rank_[static_cast<std::size_t>(v)] >= 0) != isPassable(grid, v % width_, v / width_)) { ++mismatches; }
+        }
+        if (mismatches > 0) { return false; }
+
+        // --- Lower neighbours (transposed up arcs) and elimination-tree levels, before touching any weight ---
+        std::vector<std::size_t> lower_offsets;
+        std::vector<int> lower;
+        std::vector<std::size_t> level_offsets;
+        std::vector<int> by_level;
+        int level_count = 0;
+        try {
+            lower_offsets.assign(static_cast<std::size_t>(node_count) + 1, 0);
+            for (const Arc& a : up_arcs_) { ++lower_offsets[static_cast<std::size_t>(a.node) + 1]; }
+            for (std::size_t n = 0; n < static_cast<std::size_t>(node_count); ++n) { lower_offsets[n + 1] += lower_offsets[n]; }
+            lower.resize(up_arcs_.size());
+            std::vector<std::size_t> cursor(lower_offsets.begin(), lower_offsets.end() - 1);
+            for (int m = 0; m < node_count; ++m) {
+                for (const Arc* a = upBegin(m); a != upEnd(m); ++a) { lower[cursor[static_cast<std::size_t>(a->node)]++] = m; }
+            }
+
+            std::vector<int> order(static_cast<std::size_t>(node_count), -1);
+            for (int v = 0; v < node_count; ++v) {
+                const int r = rank_[static_cast<std::size_t>(v)];
+                if (r >= 0) { order[static_cast<std::size_t>(r)] = v; }
+            }
+            std::vector<int> level(static_cast<std::size_t>(node_count), 0);
+            for (const int m : order) {
+                if (m < 0) { break; } // Ranks are dense: the rest belongs to impassable cells
+                const int next_level = level[static_cast<std::size_t>(m)] + 1;
+                level_count = std::max(level_count, next_level);
+                for (const Arc* a = upBegin(m); a != upEnd(m); ++a) {
+                    level[static_cast<std::size_t>(a->node)] = std::max(level[static_cast<std::size_t>(a->node)], next_level);
+                }
+            }
+            level_offsets.assign(static_cast<std::size_t>(level_count) + 1, 0);
+            for (const int v : order) {
+                if (v < 0) { break; }
+                ++level_offsets[static_cast<std::size_t>(level[static_cast<std::size_t>(v)]) + 1];
+            }
+            for (std::size_t l = 0; l < static_cast<std::size_t>(level_count); ++l) { level_offsets[l + 1] += level_offsets[l]; }
+            by_level.resize(level_offsets.back());
+            cursor.assign(level_offsets.begin(), level_offsets.end() - 1);
+            for (const int v : order) {
+                if (v < 0) { break; }
+                by_level[cursor[static_cast<std::size_t>(level[static_cast<std::size_t>(v)])]++] = v;
+            }
+        }
+        catch (const std::bad_alloc&) {
+            return false;
+        }
+
+        // --- Grid steps (every cell owns its arc ranges); shortcuts start out impossible ---
+#pragma omp parallel for schedule(dynamic, 256)
+        for (int v = 0; v < node_count; ++v) {
+            const std::size_t n = static_cast<std::size_t>(v);
+            for (std::size_t i = up_offsets_[n]; i < up_offsets_[n + 1]; ++i) {
+                Arc& a = up_arcs_[i];
+                const int dir = stepDirection(v, a.node, width_);
+                a.weight = dir < 0 ? INF : stepCost(context, edge_costs, v % width_, v / width_, dir);
+                a.middle = -1;
+            }
+            for (std::size_t i = down_offsets_[n]; i < down_offsets_[n + 1]; ++i) {
+                Arc& a = down_arcs_[i];
+                const int dir = stepDirection(a.node, v, width_);
+                a.weight = dir < 0 ? INF : stepCost(context, edge_costs, a.node % width_, a.node / width_, dir);
+                a.middle = -1;
+            }
+        }
+
+        // --- Lower triangles: arc u <-> x is lowered through every common neighbour m below both ---
+        // Each cell u pulls into its own arcs from its lower neighbours, whose arcs must be final, so the
+        // cells are processed by elimination-tree level (1 + the highest level below), in parallel within one.
+        for (int l = 1; l < level_count; ++l) { // Level 0 has no lower neighbours
+            const long long first = static_cast<long long>(level_offsets[static_cast<std::size_t>(l)]);
+            const long long last = static_cast<long long>(level_offsets[static_cast<std::size_t>(l) + 1]);
+#pragma omp parallel for schedule(dynamic, 64)
+            for (long long c = first; c < last; ++c) {
+                const int u = by_level[static_cast<std::size_t>(c)];
+                const int u_rank = rank(u);
+                Arc* u_up = up_arcs_.data() + up_offsets_[static_cast<std::size_t>(u)];
+                Arc* u_down = down_arcs_.data() + down_offsets_[static_cast<std::size_t>(u)];
+                const std::size_t u_degree = up_offsets_[static_cast<std::size_t>(u) + 1] - up_offsets_[static_cast<std::size_t>(u)];
+                for (std::size_t lo = lower_offsets[static_cast<std::size_t>(u)]; lo < lower_offsets[static_cast<std::size_t>(u) + 1]; ++lo) {
+                    // Up and down arcs of m list the same cells in ascending order; u is one of them
+                    const int m = lower[lo];
+                    const Arc* m_up = upBegin(m);
+                    const Arc* m_down = downBegin(m);
+                    const std::size_t degree = static_cast<std::size_t>(upEnd(m) - m_up);
+                    const std::size_t i = static_cast<std::size_t>(std::lower_bound(m_up, m_up + degree, u,
+                        [](const Arc& a, int node) { return a.node < node; }) - m_up);
+                    std::size_t k = 0;
+                    for (std::size_t j = 0; j < degree; ++j) {
+                        const int x = m_up[j].node;
+                        if (j == i || rank(x) < u_rank) { continue; } // x <-> u is stored at x
+                        while (k < u_degree && u_up[k].node < x) { ++k; }
+                        if (k == u_degree) { break; }
+                        if (u_up[k].node != x) { continue; }
+                        const float via_out = m_down[i].weight + m_up[j].weight; // u -> m -> x
+                        if (via_out < u_up[k].weight) { u_up[k].weight = via_out; u_up[k].middle = m; }
+                        const float via_in = m_down[j].weight + m_up[i].weight;  // x -> m -> u
+                        if (via_in < u_down[k].weight) { u_down[k].weight = via_in; u_down[k].middle = m; }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    std::size_t ContractionHierarchy::memoryBytes() const {
+        return rank_.size() * sizeof(int) +
+            (up_offsets_.size() + down_offsets_.size()) * sizeof(std::size_t) +
+            (up_arcs_.size() + down_arcs_.size()) * sizeof(Arc);
+    }
+
+    const ContractionHierarchy::Arc* ContractionHierarchy::findArc(int from, int to) const {
+        // Every arc is stored once, at its lower-ranked end
+        if (rank(to) > rank(from)) {
+            for (const Arc* a = upBegin(from); a != upEnd(from); ++a) {
+                if (a->node == to) { return a; }
+            }
+        }
+        else {
+            for (const Arc* a = downBegin(to); a != downEnd(to); ++a) {
+                if (a->node == from) { return a; }
+            }
+        }
+        return nullptr;
+    }
+
+    bool ContractionHierarchy::unpackArc(int from, int to, std::vector<int>& path) const {
+        std::vector<std::pair<int, int>> stack{ { from, to } };
+        while (!stack.empty()) {
+            const auto [a, b] = stack.back();
+            stack.pop_back();
+            const Arc* arc = findArc(a, b);
+            if (arc == nullptr) { return false; }
+            if (arc->middle < 0) {
+                path.push_back(b);
+            }
+            else {
+                // Expand a -> middle before middle -> b
+                stack.emplace_back(arc->middle, b);
+                stack.emplace_back(a, arc->middle);
+            }
+        }
+        return true;
+    }
+
+} // namespace Pathfinding
@@ -0,0 +1,136 @@
+// File: DeltaSteppingCPU.cpp
+
+#include "algoritms/DeltaSteppingCPU.hpp"
+#include "algoritms/DeltaSteppingEngine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        // HADS cone pruning: h = W * Euclidean cells to the goal, tabulated within the radius (as the GPU precompute)
+        class HADSPruning {
+        public:
+            HADSPruning(int width, int height, int goal_x, int goal_y, int radius_cells, float prune_factor, float weight)
+                : goal_x_(goal_x), goal_y_(goal_y), prune_factor_(prune_factor), weight_(weight) {
+                const long long radius = std::max(0, radius_cells);
+                box_x0_ = static_cast<int>(std::max(0LL, goal_x - radius));
+                box_y0_ = static_cast<int>(std::max(0LL, goal_y - radius));
+                box_w_ = static_cast<int>(std::min<long long>(width - 1, goal_x + radius)) - box_x0_ + 1;
+                box_h_ = static_cast<int>(std::min<long long>(height - 1, goal_y + radius)) - box_y0_ + 1;
+                const float radius_sq = static_cast<float>(radius) * static_cast<float>(radius);
+                table_.assign(static_cast<std::size_t>(box_w_) * static_cast<std::size_t>(box_h_), -1.0f);
+#pragma omp parallel for schedule(static)
+                for (int by = 0; by < box_h_; ++by) {
+                    for (int bx = 0; bx < box_w_; ++bx) {
+                        const float hx = static_cast<float>(box_x0_ + bx - goal_x_);
+                        const float hy = static_cast<float>(box_y0_ + by - goal_y_);
+                        if (hx * hx + hy * hy <= radius_sq) {
+                            table_[static_cast<std::size_t>(by) * static_cast<std::size_t>(box_w_) + static_cast<std::size_t>(bx)] = weight_ * std::sqrt(hx * hx + hy * hy);
+                        }
+                    }
+                }
+            }
+
+            /** @brief True if the step (x, y) -> (nx, ny) leaves the cone towards the goal. */
+            bool prunes(int x, int y, int nx, int ny) const { return h(nx, ny) > h(x, y) * prune_factor_; }
+
+        private:
+            float h(int x, int y) const {
+                const int bx = x - box_x0_;
+                const int by = y - box_y0_;
+                if (bx >= 0 && by >= 0 && bx < box_w_ && by < box_h_) {
+                    const float cached = table_[static_cast<std::size_t>(by) * static_cast<std::size_t>(box_w_) + static_cast<std::size_t>(bx)];
+                    if (cached >= 0.0f) { return cached; }
+                }
+                return weight_ * internal::euclidean_distance(x, y, goal_x_, goal_y_);
+            }
+
+            int goal_x_, goal_y_;
+            float prune_factor_, weight_;
+            int box_x0_ = 0, box_y0_ = 0, box_w_ = 0, box_h_ = 0;
+            std::vector<float> table_;
+        };
+
+        template <typename Pruning>
+        std::vector<int> runDeltaStepping(
+            const PathfindingContext& context,
+            const GridPoint& start,
+            const GridPoint& end,
+            float delta,
+            float light_threshold,
+            const Pruning& pruning
+        ) {
+            std::vector<int> resultPath;
+            if (!context.isValid()) { return resultPath; }
+            const Grid_V3& grid = *context.grid;
+            if (!grid.inBounds(start.x, start.y) || !grid.inBounds(end.x, end.y)) { return resultPath; }
+            if (!isPassable(grid, start.x, start.y) || !isPassable(grid, end.x, end.y)) { return resultPath; }
+            const int width = static_cast<int>(grid.width());
+            const int cell_count = width * static_cast<int>(grid.height());
+            const int startIdx = toIndex(start.x, start.y, width);
+            const int endIdx = toIndex(end.x, end.y, width);
+            if (startIdx == endIdx) { resultPath.push_back(startIdx); return resultPath; }
+
+            delta_stepping::Labels<true> labels;
+            if (!delta_stepping::run<delta_stepping::EdgeDirection::Outgoing>(context, startIdx, delta, light_threshold, endIdx, pruning, labels)) {
+                return resultPath;
+            }
+
+            // --- Reconstruct Path ---
+            if (labels.distBits(endIdx) == delta_stepping::Labels<true>::UNREACHED) { return resultPath; }
+            int current = endIdx;
+            while (current != -1 && static_cast<int>(resultPath.size()) <= cell_count) {
+                resultPath.push_back(current);
+                if (current == startIdx) { break; }
+                current = labels.parent(current);
+            }
+            if (resultPath.empty() || resultPath.back() != startIdx) { return {}; }
+            std::reverse(resultPath.begin(), resultPath.end());
+            return resultPath;
+        }
+
+        // Same fallbacks as the GPU wrappers for out-of-range tuning values
+        void sanitizeDeltaParams(float& delta_param, float& light_edge_threshold_param) {
+            if (!(delta_param > 1e-6f)) { delta_param = 1.0f; }
+            if (!(light_edge_threshold_param > 0.0f)) { light_edge_threshold_param = delta_param; }
+        }
+
+    } // end anonymous namespace
+
+    std::vector<int> findDeltaSteppingPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end,
+        float delta_param,
+        float light_edge_threshold_param
+    ) {
+        sanitizeDeltaParams(delta_param, light_edge_threshold_param);
+        return runDeltaStepping(context, start, end, delta_param, light_edge_threshold_param, delta_stepping::NoPruning{});
+    }
+
+    std::vector<int> findHADSPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end,
+        float delta_param,
+        float light_edge_threshold_param,
+        int heuristic_radius_cells,
+        float prune_factor,
+        float heuristic_weight
+    ) {
+        if (!context.isValid() || !context.grid->inBounds(end.x, end.y)) { return {}; }
+        sanitizeDeltaParams(delta_param, light_edge_threshold_param);
+        if (!(heuristic_weight > 0.0f)) { heuristic_weight = 1.0f; }
+        const HADSPruning pruning(static_cast<int>(context.grid->width()), static_cast<int>(context.grid->height()),
+            end.x, end.y, heuristic_radius_cells, prune_factor, heuristic_weight);
+        return runDeltaStepping(context, start, end, delta_param, light_edge_threshold_param, pruning);
+    }
+
+} // namespace Pathfinding
@@ -2,7 +2,10 @@
 #include "map/MapProcessingCommon.h"
 #include "map/PathfindingUtils.hpp"
 #include "map/ElevationSampler.hpp"
+#include "map/ElevationRaster.hpp"
+#include "algoritms/SearchKernels.hpp"
 
+#include <algorithm>
 #include <vector>
 #include <queue>
 #include <limits>
@@ -16,6 +19,164 @@ using namespace PathfindingUtils;
 
 namespace Pathfinding {
 
+    namespace {
+
+        // Dijkstra main loop from startIdx (a layout index) until stop(settled cell) returns true or the
+        // open list runs dry. Instantiated per open list, connectivity and cost model (see SearchKernels.hpp);
+        // the caller has started the workspace query.
+        template <typename OpenQueue, int Directions, typename CostPolicy, typename StopFn>
+        void runDijkstraLoop(
+            const PathfindingContext& context,
+            SearchWorkspace& workspace,
+            int startIdx,
+            const CostPolicy& cost_policy,
+            StopFn&& stop
+        ) {
+            const Grid_V3& logical_grid = *context.grid;
+            const int log_width = static_cast<int>(logical_grid.width());
+            const int log_height = static_cast<int>(logical_grid.height());
+            // Storage layout of the workspace and the cost policy's data; indices below are layout indices
+            const auto& layout = cost_policy.layout();
+
+            // --- Open list: (key, node_index) entries, stale duplicates skipped via the closed set ---
+            OpenQueue openQueue;
+
+            // --- Initialization ---
+            workspace.setScore(startIdx, 0.0f, -1);
+            openQueue.push(0.0f, startIdx);
+
+            // --- Dijkstra Main Loop ---
+            while (!openQueue.empty()) {
+                const int currentIdx = openQueue.popMin().second;
+
+                if (workspace.isClosed(currentIdx)) { continue; } // stale entry
+                workspace.close(currentIdx);
+                if (stop(currentIdx)) { break; } // Goal (or last target) settled
+
+                int x, y;
+                layout.toCoords(currentIdx, x, y);
+                const float current_g = workspace.g(currentIdx);
+
+                // All outgoing costs of the current cell at once (blocked = max())
+                alignas(32) float cell_costs[NUM_DIRECTIONS];
+                cost_policy.cellCosts(x, y, currentIdx, cell_costs);
+
+                // --- Explore Neighbors (Same logic as A*) ---
+                for (int dir = 0; dir < Directions; ++dir) {
+                    const int nx = x + dx[dir];
+                    const int ny = y + dy[dir];
+
+                    if (nx < 0 || nx >= log_width || ny < 0 || ny >= log_height) { continue; }
+
+                    const int neighborIdx = layout.toIndex(nx, ny);
+                    if (workspace.isClosed(neighborIdx)) { continue; } // Optimization: Skip already closed nodes
+
+                    const float final_move_cost = cell_costs[dir];
+                    if (final_move_cost >= std::numeric_limits<float>::max()) { continue; }
+
+                    // --- Update Neighbor ---
+                    float tentative_g = current_g + final_move_cost;
+
+                    // Relaxation step: If new path is cheaper
+                    if (tentative_g < workspace.g(neighborIdx)) {
+                        workspace.setScore(neighborIdx, tentative_g, currentIdx);
+                        openQueue.push(tentative_g, neighborIdx);
+                    }
+                } // End neighbor loop
+            } // End while openQueue not empty
+        }
+
+        // Row-major path startIdx -> endIdx (layout indices) from the workspace parents; empty if endIdx was not reached
+        template <typename Layout>
+        std::vector<int> reconstructPath(const SearchWorkspace& workspace, const Layout& layout, int log_width, int log_size, int startIdx, int endIdx) {
+            if (workspace.parent(endIdx) == -1 && startIdx != endIdx) { return {}; }
+            std::vector<int> path_reversed;
+            int current = endIdx;
+            size_t safety_count = 0;
+            const size_t max_path_len = static_cast<size_t>(log_size) + 1;
+            while (current != -1 && safety_count < max_path_len) {
+                int cx, cy;
+                layout.toCoords(current, cx, cy);
+                path_reversed.push_back(toIndex(cx, cy, log_width)); // Paths are row-major
+                if (current == startIdx) break;
+                current = workspace.parent(current);
+                safety_count++;
+            }
+            if (current != startIdx && startIdx != endIdx) return std::vector<int>(); // Failed
+            if (safety_count >= max_path_len) return std::vector<int>();           // Failed (cycle?)
+
+            return std::vector<int>(path_reversed.rbegin(), path_reversed.rend());
+        }
+
+        template <typename OpenQueue, int Directions, typename CostPolicy>
+        std::vector<int> runDijkstra(
+            const PathfindingContext& context,
+            SearchWorkspace& workspace,
+            const GridPoint& start,
+            const GridPoint& end,
+            const CostPolicy& cost_policy
+        ) {
+            const int log_width = static_cast<int>(context.grid->width());
+            const int log_size = log_width * static_cast<int>(context.grid->height());
+            const auto& layout = cost_policy.layout();
+            const int startIdx = layout.toIndex(start.x, start.y);
+            const int endIdx = layout.toIndex(end.x, end.y);
+
+            // --- Search state: generation-stamped, so no O(grid) reset per query ---
+            if (!workspace.beginQuery(layout.storageSize())) { return {}; }
+            runDijkstraLoop<OpenQueue, Directions>(context, workspace, startIdx, cost_policy,
+                [endIdx](int idx) { return idx == endIdx; });
+            return reconstructPath(workspace, layout, log_width, log_size, startIdx, endIdx);
+        }
+
+        // One-to-many: settles cells until every passable target is closed, then fills costs (and paths)
+        // per entry of targets; unreached and impassable targets keep max() and an empty path
+        template <typename OpenQueue, int Directions, typename CostPolicy>
+        void runDijkstraOneToMany(
+            const PathfindingContext& context,
+            SearchWorkspace& workspace,
+            const GridPoint& source,
+            const std::vector<GridPoint>& targets,
+            const std::vector<bool>& target_passable,
+            const CostPolicy& cost_policy,
+            std::vector<float>& costs,
+            std::vector<std::vector<int>>* paths
+        ) {
+            const int log_width = static_cast<int>(context.grid->width());
+            const int log_size = log_width * static_cast<int>(context.grid->height());
+            const auto& layout = cost_policy.layout();
+            const int sourceIdx = layout.toIndex(source.x, source.y);
+
+            // Distinct passable target cells (sorted); the search ends once all of them are settled
+            std::vector<int> target_cells;
+            for (std::size_t t = 0; t < targets.size(); ++t) {
+                if (target_passable[t]) { target_cells.push_back(layout.toIndex(targets[t].x, targets[t].y)); }
+            }
+            std::sort(target_cells.begin(), target_cells.end());
+            target_cells.erase(std::unique(target_cells.begin(), target_cells.end()), target_cells.end());
+            if (target_cells.empty()) { return; }
+
+            if (!workspace.beginQuery(layout.storageSize())) { return; }
+            std::size_t targets_left = target_cells.size();
+            runDijkstraLoop<OpenQueue, Directions>(context, workspace, sourceIdx, cost_policy, [&](int idx) {
+                if (std::binary_search(target_cells.begin(), target_cells.end(), idx)) { --targets_left; }
+                return targets_left == 0;
+            });
+
+            for (std::size_t t = 0; t < targets.size(); ++t) {
+                if (!target_passable[t]) { continue; }
+                const int targetIdx = layout.toIndex(targets[t].x, targets[t].y);
+                if (!workspace.isClosed(targetIdx)) { continue; } // Not reached
+                if (paths != nullptr) {
+                    (*paths)[t] = reconstructPath(workspace, layout, log_width, log_size, sourceIdx, targetIdx);
+                    if ((*paths)[t].empty()) { continue; }
+                }
+                costs[t] = workspace.g(targetIdx);
+            }
+        }
+
+    } // end anonymous namespace
+
     std::vector<int> findDijkstraPath_Tobler_Sampled(
         const Grid_V3& logical_grid,
         const std::vector<float>& elevation_values,
@@ -28,16 +189,11 @@ namespace Pathfinding {
         const GridPoint& start,
         const GridPoint& end
     ) {
-        const int log_width = static_cast<int>(logical_grid.width());
-        const int log_height = static_cast<int>(logical_grid.height());
-        const int log_size = log_width * log_height;
-        std::vector<int> resultPath;
-
         // --- Input Validation (Same as A*) ---
         if (!logical_grid.isValid() || log_cell_resolution <= EPSILON) {
-            return resultPath;
+            return std::vector<int>();
         }
-        // Wrap in try-catch if constructor exceptions need graceful handling here
+        // Legacy entry point: resample elevation for this call only (constructor throws on error)
         ElevationSampler elevation_sampler(
             elevation_values,
             elevation_width,
@@ -46,116 +202,68 @@ namespace Pathfinding {
             origin_offset_x,
             origin_offset_y
         );
+        const ElevationRaster elevation_raster = ElevationRaster::fromSampler(
+            elevation_sampler, logical_grid.width(), logical_grid.height(), log_cell_resolution);
 
-        if (!logical_grid.inBounds(start.x, start.y) || !logical_grid.inBounds(end.x, end.y)) {
-            return resultPath;
-        }
+        return findDijkstraPath_Tobler_Sampled(
+            makePathfindingContext(logical_grid, &elevation_raster, log_cell_resolution), start, end);
+    }
 
-        const int startIdx = toIndex(start.x, start.y, log_width);
-        const int endIdx = toIndex(end.x, end.y, log_width);
+    std::vector<int> findDijkstraPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end
+    ) {
+        return findDijkstraPath_Tobler_Sampled(context, threadLocalSearchWorkspace(), start, end);
+    }
+
+    std::vector<int> findDijkstraPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end
+    ) {
+        // Elevation is only needed when Tobler costs are not precomputed
+        if (!searchCostsAvailable(context)) { return {}; }
+        const Grid_V3& logical_grid = *context.grid;
+        if (!logical_grid.inBounds(start.x, start.y) || !logical_grid.inBounds(end.x, end.y)) { return {}; }
 
         const GridCellData& startCell = logical_grid.at(start.x, start.y);
-        if (startCell.value <= 0.0f || startCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return resultPath; }
+        if (startCell.value <= 0.0f || startCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return {}; }
         const GridCellData& endCell = logical_grid.at(end.x, end.y);
-        if (endCell.value <= 0.0f || endCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return resultPath; }
-
-        if (startIdx == endIdx) { resultPath.push_back(startIdx); return resultPath; }
-
-        // --- Dijkstra Data Structures ---
-        // Note: No f_scores needed for Dijkstra
-        static thread_local std::vector<float> g_scores; // Cost from start
-        static thread_local std::vector<bool> closed;    // Visited set
-        static thread_local std::vector<int> parents;   // Path reconstruction
-        static thread_local std::vector<float> cell_elevation;
-        try {
-            g_scores.assign(log_size, std::numeric_limits<float>::max());
-            closed.assign(log_size, false);
-            parents.assign(log_size, -1);
-            cell_elevation.resize(static_cast<size_t>(log_size));
-        }
-        catch (const std::bad_alloc&) { return resultPath; }
-
-        // Precompute elevation for every cell centre once.
-        for (int cy = 0; cy < log_height; ++cy) {
-            for (int cx = 0; cx < log_width; ++cx) {
-                float wx = (static_cast<float>(cx) + 0.5f) * log_cell_resolution;
-                float wy = (static_cast<float>(cy) + 0.5f) * log_cell_resolution;
-                cell_elevation[toIndex(cx, cy, log_width)] = elevation_sampler.getElevationAt(wx, wy);
-            }
-        }
-
-        // --- Priority Queue (Ordered by g_score) using pairs to avoid stale captures ---
-        using PQEntry = std::pair<float, int>;
-        std::priority_queue<PQEntry, std::vector<PQEntry>, std::greater<PQEntry>> openQueue;
-
-        // --- Initialization ---
-        g_scores[startIdx] = 0.0f;
-        openQueue.push({0.0f, startIdx});
-
-        // --- Dijkstra Main Loop ---
-        while (!openQueue.empty()) {
-            auto [current_dist, currentIdx] = openQueue.top();
-            openQueue.pop();
-
-            if (currentIdx == endIdx) { break; } // Goal found
-            if (closed[currentIdx]) { continue; } // stale entry
-            closed[currentIdx] = true;
-
-            int x, y;
-            toCoords(currentIdx, log_width, x, y);
-            const float current_g = g_scores[currentIdx];
-
-            // Lookup precomputed elevation for current cell.
-            float current_elevation = cell_elevation[currentIdx];
+        if (endCell.value <= 0.0f || endCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return {}; }
 
-            // --- Explore Neighbors (Same logic as A*) ---
-            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
-                const int nx = x + dx[dir];
-                const int ny = y + dy[dir];
+        if (start == end) { return { toIndex(start.x, start.y, static_cast<int>(logical_grid.width())) }; }
 
-                if (nx < 0 || nx >= log_width || ny < 0 || ny >= log_height) { continue; }
-
-                const int neighborIdx = toIndex(nx, ny, log_width);
-                if (closed[neighborIdx]) { continue; } // Optimization: Skip already closed nodes
-
-                const GridCellData& neighborCell = logical_grid.at(nx, ny);
-                if (neighborCell.value <= 0.0f || neighborCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { continue; }
-
-                // --- Cost Calculation via shared Tobler function ---
-                float neighbor_elevation = cell_elevation[neighborIdx];
-                float delta_h = neighbor_elevation - current_elevation;
-                float final_move_cost = toblerEdgeCost(dir, log_cell_resolution, delta_h, neighborCell.value);
-                if (final_move_cost >= std::numeric_limits<float>::max()) { continue; }
+        return withSearchKernel(context, [&](auto queue_tag, const auto& cost_policy, auto connectivity) {
+            using OpenQueue = typename decltype(queue_tag)::type;
+            return runDijkstra<OpenQueue, decltype(connectivity)::value>(context, workspace, start, end, cost_policy);
+        });
+    }
 
-                // --- Update Neighbor ---
-                float tentative_g = current_g + final_move_cost;
+    std::vector<float> findDijkstraOneToMany_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& source,
+        const std::vector<GridPoint>& targets,
+        std::vector<std::vector<int>>* paths
+    ) {
+        std::vector<float> costs(targets.size(), std::numeric_limits<float>::max());
+        if (paths != nullptr) { paths->assign(targets.size(), std::vector<int>()); }
+        if (!searchCostsAvailable(context)) { return costs; }
+        const Grid_V3& logical_grid = *context.grid;
+        const auto passable = [&](const GridPoint& p) { return logical_grid.inBounds(p.x, p.y) && isPassable(logical_grid, p.x, p.y); };
+        if (!passable(source)) { return costs; }
 
-                // Relaxation step: If new path is cheaper
-                if (tentative_g < g_scores[neighborIdx]) {
-                    parents[neighborIdx] = currentIdx;
-                    g_scores[neighborIdx] = tentative_g;
-                    openQueue.push({tentative_g, neighborIdx});
-                }
-            } // End neighbor loop
-        } // End while openQueue not empty
-
-        // --- Path Reconstruction (Same as A*) ---
-        if (parents[endIdx] == -1 && startIdx != endIdx) { return resultPath; }
-        std::vector<int> path_reversed;
-        int current = endIdx;
-        size_t safety_count = 0;
-        const size_t max_path_len = static_cast<size_t>(log_size) + 1;
-        while (current != -1 && safety_count < max_path_len) {
-            path_reversed.push_back(current);
-            if (current == startIdx) break;
-            current = parents[current];
-            safety_count++;
-        }
-        if (current != startIdx && startIdx != endIdx) return std::vector<int>(); // Failed
-        if (safety_count >= max_path_len) return std::vector<int>();           // Failed (cycle?)
+        std::vector<bool> target_passable(targets.size());
+        for (std::size_t t = 0; t < targets.size(); ++t) { target_passable[t] = passable(targets[t]); }
 
-        resultPath.assign(path_reversed.rbegin(), path_reversed.rend());
-        return resultPath;
+        withSearchKernel(context, [&](auto queue_tag, const auto& cost_policy, auto connectivity) {
+            using OpenQueue = typename decltype(queue_tag)::type;
+            runDijkstraOneToMany<OpenQueue, decltype(connectivity)::value>(
+                context, workspace, source, targets, target_passable, cost_policy, costs, paths);
+        });
+        return costs;
     }
 
-}// namespace Pathfinding
\ No newline at end of file
+}// namespace Pathfinding
@@ -0,0 +1,129 @@
+// File: EdgeCostCache.cpp
+
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <new>
+#include <omp.h>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        // Fills the 8 outgoing edge costs of every cell in row cy (the same kernel as the on-the-fly A*/Dijkstra relaxation).
+        template <typename StoreFn>
+        void computeRowCosts(const Grid_V3& grid, const ElevationRaster& elevation, float log_cell_resolution, int cy, StoreFn store) {
+            const int width = static_cast<int>(grid.width());
+            alignas(32) float cell_costs[NUM_DIRECTIONS];
+            for (int cx = 0; cx < width; ++cx) {
+                const int idx = toIndex(cx, cy, width);
+                toblerNeighborCosts(grid, elevation, log_cell_resolution, cx, cy, cell_costs);
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    store(static_cast<std::size_t>(idx) * NUM_DIRECTIONS + static_cast<std::size_t>(dir), cell_costs[dir]);
+                }
+            }
+        }
+
+    } // end anonymous namespace
+
+    std::uint16_t EdgeCostCache::floatToHalf(float value) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const std::uint16_t sign = static_cast<std::uint16_t>((bits >> 16) & 0x8000u);
+        const std::uint32_t abs_bits = bits & 0x7FFFFFFFu;
+
+        if (abs_bits >= 0x7F800000u) { // Inf / NaN
+            return static_cast<std::uint16_t>(sign | (abs_bits > 0x7F800000u ? 0x7E00u : HALF_INFINITY));
+        }
+        if (abs_bits >= 0x477FF000u) { // Rounds to >= 65520: overflow
+            return static_cast<std::uint16_t>(sign | HALF_INFINITY);
+        }
+        if (abs_bits < 0x38800000u) { // Below the smallest normal half: subnormal or zero
+            if (abs_bits < 0x33000000u) { return sign; } // < 2^-25 rounds to zero
+            const std::uint32_t exponent = abs_bits >> 23;
+            const std::uint32_t mantissa = (abs_bits & 0x7FFFFFu) | 0x800000u;
+            const std::uint32_t shift = 126u - exponent; // 14..24
+            std::uint32_t half_mantissa = mantissa >> shift;
+            const std::uint32_t remainder = mantissa & ((1u << shift) - 1u);
+            const std::uint32_t halfway = 1u << (shift - 1u);
+            if (remainder > halfway || (remainder == halfway && (half_mantissa & 1u))) { ++half_mantissa; }
+            return static_cast<std::uint16_t>(sign | half_mantissa);
+        }
+        // Normal: rebias exponent, round mantissa to nearest even (carry may bump the exponent, which is correct)
+        std::uint32_t half_bits = ((abs_bits - 0x38000000u) >> 13);
+        const std::uint32_t remainder = abs_bits & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (half_bits & 1u))) { ++half_bits; }
+        return static_cast<std::uint16_t>(sign | half_bits);
+    }
+
+    EdgeCostCache EdgeCostCache::build(const Grid_V3& grid, const ElevationRaster& elevation,
+        float log_cell_resolution, Precision precision)
+    {
+        EdgeCostCache cache;
+        if (!grid.isValid() || !elevation.isValid() || log_cell_resolution <= EPSILON ||
+            elevation.width() != grid.width() || elevation.height() != grid.height()) {
+            return cache;
+        }
+        const int height = static_cast<int>(grid.height());
+        const std::size_t slots = grid.width() * grid.height() * NUM_DIRECTIONS;
+
+        try {
+            if (precision == Precision::Float32) {
+                cache.costs_f32_.resize(slots);
+            }
+            else {
+                cache.costs_f16_.resize(slots);
+            }
+        }
+        catch (const std::bad_alloc&) {
+            return EdgeCostCache();
+        }
+        cache.width_ = grid.width();
+        cache.height_ = grid.height();
+        cache.precision_ = precision;
+
+        if (precision == Precision::Float32) {
+            float* out = cache.costs_f32_.data();
+#pragma omp parallel for schedule(static)
+            for (int cy = 0; cy < height; ++cy) {
+                computeRowCosts(grid, elevation, log_cell_resolution, cy,
+                    [out](std::size_t slot, float c) { out[slot] = c; });
+            }
+            return cache;
+        }
+
+        // Float16: pick a power-of-two scale from the largest possible finite cost
+        // (longest edge * most expensive terrain * capped slope penalty) so nothing overflows, and as
+        // small as that allows so cheap edges stay in the normal half range.
+        const auto& cells = grid.data();
+        float max_terrain = 0.0f;
+#pragma omp parallel for reduction(max:max_terrain) schedule(static)
+        for (long long i = 0; i < static_cast<long long>(cells.size()); ++i) {
+            const GridCellData& cell = cells[static_cast<std::size_t>(i)];
+            if (cell.value > 0.0f && !cell.hasFlag(GridFlags::FLAG_IMPASSABLE)) {
+                max_terrain = std::max(max_terrain, cell.value);
+            }
+        }
+        const float max_cost_bound = costs[4] * max_terrain * MAX_TOBLER_PENALTY;
+        cache.scale_ = (max_cost_bound > 0.0f) ? std::exp2(std::ceil(std::log2(max_cost_bound / 32768.0f))) : 1.0f;
+        const float inv_scale = 1.0f / cache.scale_; // Exact: scale is a power of two
+
+        // Costs below the smallest normal half are rounded up to it (see the class doc)
+        std::uint16_t* out = cache.costs_f16_.data();
+#pragma omp parallel for schedule(static)
+        for (int cy = 0; cy < height; ++cy) {
+            computeRowCosts(grid, elevation, log_cell_resolution, cy,
+                [out, inv_scale](std::size_t slot, float c) {
+                    out[slot] = (c >= std::numeric_limits<float>::max()) ? HALF_INFINITY
+                        : floatToHalf(std::max(c * inv_scale, FLOAT16_MIN_NORMAL));
+                });
+        }
+        return cache;
+    }
+
+} // namespace Pathfinding
@@ -0,0 +1,224 @@
+// File: HPAStarToblerSampled.cpp
+
+#include "algoritms/HPAStarToblerSampled.hpp"
+#include "algoritms/HierarchicalGraph.hpp"
+#include "algoritms/SearchQueues.hpp"
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"
+#include "map/MapProcessingCommon.h"
+#include "map/PathfindingUtils.hpp"
+#include "map/ElevationRaster.hpp"
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        // A* over the cells of the corridor clusters only (same costs and tie handling as runAStar)
+        template <typename OpenQueue>
+        std::vector<int> runCorridorAStar(
+            const PathfindingContext& context,
+            const HierarchicalGraph& graph,
+            const std::vector<char>& in_corridor,
+            SearchWorkspace& workspace,
+            const GridPoint& start,
+            const GridPoint& end
+        ) {
+            std::vector<int> resultPath;
+            const EdgeCostCache* edge_costs = context.hasEdgeCosts() ? context.edge_costs : nullptr;
+            const Grid_V3& logical_grid = *context.grid;
+            const ElevationRaster* cell_elevation = context.elevation;
+            const int log_width = static_cast<int>(logical_grid.width());
+            const int log_height = static_cast<int>(logical_grid.height());
+            const int log_size = log_width * log_height;
+            const int startIdx = toIndex(start.x, start.y, log_width);
+            const int endIdx = toIndex(end.x, end.y, log_width);
+
+            if (!workspace.beginQuery(static_cast<size_t>(log_size))) { return resultPath; }
+            OpenQueue openQueue;
+            // Consistent: every step costs at least its length times the cheapest terrain (slope penalty >= 1)
+            auto heuristic = [&](int x, int y) { return context.min_terrain_cost * internal::euclidean_distance(x, y, end.x, end.y); };
+
+            workspace.setScore(startIdx, 0.0f, -1);
+            openQueue.push(heuristic(start.x, start.y), startIdx);
+
+            while (!openQueue.empty()) {
+                const int currentIdx = openQueue.popMin().second;
+                if (currentIdx == endIdx) { break; }
+                if (workspace.isClosed(currentIdx)) { continue; } // stale entry
+                workspace.close(currentIdx);
+
+                int x, y;
+                toCoords(currentIdx, log_width, x, y);
+                const float current_g = workspace.g(currentIdx);
+                // Batch-evaluate the 8 Tobler costs of the current cell (unused with precomputed edge costs).
+                alignas(32) float cell_costs[NUM_DIRECTIONS];
+                if (edge_costs == nullptr) { toblerNeighborCosts(logical_grid, *cell_elevation, context.log_cell_resolution, x, y, cell_costs); }
+
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    const int nx = x + dx[dir];
+                    const int ny = y + dy[dir];
+                    if (nx < 0 || nx >= log_width || ny < 0 || ny >= log_height) { continue; }
+                    if (!in_corridor[static_cast<std::size_t>(graph.clusterOf(nx, ny))]) { continue; }
+                    const int neighborIdx = toIndex(nx, ny, log_width);
+
+                    float final_move_cost;
+                    if (edge_costs != nullptr) {
+                        final_move_cost = edge_costs->cost(currentIdx, dir);
+                    }
+                    else {
+                        final_move_cost = cell_costs[dir]; // Out-of-bounds, obstacle and slope blocks are max() too
+                    }
+                    if (final_move_cost >= std::numeric_limits<float>::max()) { continue; }
+
+                    const float tentative_g = current_g + final_move_cost;
+                    if (tentative_g < workspace.g(neighborIdx)) {
+                        workspace.setScore(neighborIdx, tentative_g, currentIdx);
+                        openQueue.push(tentative_g + heuristic(nx, ny), neighborIdx);
+                    }
+                }
+            }
+
+            // --- Path Reconstruction ---
+            if (workspace.parent(endIdx) == -1) { return resultPath; }
+            for (int current = endIdx; current != -1; current = workspace.parent(current)) {
+                resultPath.push_back(current);
+                if (current == startIdx) { break; }
+            }
+            if (resultPath.back() != startIdx) { return std::vector<int>(); }
+            std::reverse(resultPath.begin(), resultPath.end());
+            return resultPath;
+        }
+
+    } // end anonymous namespace
+
+    std::vector<int> findHPAStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        SearchWorkspace& workspace,
+        const GridPoint& start,
+        const GridPoint& end
+    ) {
+        std::vector<int> resultPath;
+        const HierarchicalGraph* graph = context.hierarchy;
+        if (!context.isValid() || graph == nullptr || !graph->isValid()) { return resultPath; }
+        const Grid_V3& logical_grid = *context.grid;
+        const int log_width = static_cast<int>(logical_grid.width());
+        if (graph->width() != log_width || graph->height() != static_cast<int>(logical_grid.height())) { return resultPath; }
+
+        if (!logical_grid.inBounds(start.x, start.y) || !logical_grid.inBounds(end.x, end.y)) { return resultPath; }
+        const int startIdx = toIndex(start.x, start.y, log_width);
+        const int endIdx = toIndex(end.x, end.y, log_width);
+
+        // Obstacle Check Start/End
+        const GridCellData& startCell = logical_grid.at(start.x, start.y);
+        if (startCell.value <= 0.0f || startCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return resultPath; }
+        const GridCellData& endCell = logical_grid.at(end.x, end.y);
+        if (endCell.value <= 0.0f || endCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { return resultPath; }
+
+        if (startIdx == endIdx) { resultPath.push_back(startIdx); return resultPath; }
+
+        // --- Attach start and end to the entrances of their clusters ---
+        const int start_cluster = graph->clusterOf(start.x, start.y);
+        const int end_cluster = graph->clusterOf(end.x, end.y);
+        HierarchicalGraph::ClusterSearch from_start, to_end;
+        graph->searchCluster(context, start_cluster, startIdx, false, -1, from_start);
+        graph->searchCluster(context, end_cluster, endIdx, true, -1, to_end);
+
+        // --- Abstract A*: entrance nodes plus the start and end as two extra nodes ---
+        const int node_count = static_cast<int>(graph->nodeCount());
+        const int START_NODE = node_count;
+        const int GOAL_NODE = node_count + 1;
+        const std::size_t abstract_size = static_cast<std::size_t>(node_count) + 2;
+        std::vector<float> g_score(abstract_size, std::numeric_limits<float>::max());
+        std::vector<int> parent(abstract_size, -1);
+        std::vector<char> closed(abstract_size, 0);
+
+        // Consistent: every step costs at least its length times the cheapest terrain (slope penalty >= 1)
+        auto heuristic = [&](int node) -> float {
+            if (node == GOAL_NODE) { return 0.0f; }
+            int x = start.x, y = start.y;
+            if (node != START_NODE) { toCoords(graph->nodeCell(node), log_width, x, y); }
+            return context.min_terrain_cost * internal::euclidean_distance(x, y, end.x, end.y);
+        };
+
+        BinaryHeapQueue openQueue;
+        auto relax = [&](int from, int to, float edge_cost) {
+            if (edge_cost >= std::numeric_limits<float>::max() || closed[static_cast<std::size_t>(to)]) { return; }
+            const float tentative = g_score[static_cast<std::size_t>(from)] + edge_cost;
+            if (tentative < g_score[static_cast<std::size_t>(to)]) {
+                g_score[static_cast<std::size_t>(to)] = tentative;
+                parent[static_cast<std::size_t>(to)] = from;
+                openQueue.push(tentative + heuristic(to), to);
+            }
+        };
+
+        g_score[static_cast<std::size_t>(START_NODE)] = 0.0f;
+        openQueue.push(heuristic(START_NODE), START_NODE);
+        while (!openQueue.empty()) {
+            const int current = openQueue.popMin().second;
+            if (closed[static_cast<std::size_t>(current)]) { continue; } // stale entry
+            closed[static_cast<std::size_t>(current)] = 1;
+            if (current == GOAL_NODE) { break; }
+
+            if (current == START_NODE) {
+                for (int v = graph->clusterNodesBegin(start_cluster); v < graph->clusterNodesEnd(start_cluster); ++v) {
+                    int vx, vy;
+                    toCoords(graph->nodeCell(v), log_width, vx, vy);
+                    relax(START_NODE, v, from_start.distTo(vx, vy));
+                }
+                if (start_cluster == end_cluster) { relax(START_NODE, GOAL_NODE, from_start.distTo(end.x, end.y)); }
+                continue;
+            }
+            for (const HierarchicalGraph::Edge* e = graph->edgesBegin(current); e != graph->edgesEnd(current); ++e) {
+                relax(current, e->target, e->cost);
+            }
+            if (graph->nodeCluster(current) == end_cluster) {
+                int cx, cy;
+                toCoords(graph->nodeCell(current), log_width, cx, cy);
+                relax(current, GOAL_NODE, to_end.distTo(cx, cy));
+            }
+        }
+        if (parent[static_cast<std::size_t>(GOAL_NODE)] == -1) { return resultPath; }
+
+        // --- Refinement: A* confined to the clusters the abstract path passes through (plus a margin) ---
+        // The abstract path itself lies inside the corridor, so this never fails and is never worse.
+        const int radius = std::max(0, graph->corridorRadius());
+        std::vector<char> on_path(static_cast<std::size_t>(graph->clustersX()) * static_cast<std::size_t>(graph->clustersY()), 0);
+        on_path[static_cast<std::size_t>(start_cluster)] = 1;
+        on_path[static_cast<std::size_t>(end_cluster)] = 1;
+        for (int node = parent[static_cast<std::size_t>(GOAL_NODE)]; node != START_NODE; node = parent[static_cast<std::size_t>(node)]) {
+            on_path[static_cast<std::size_t>(graph->nodeCluster(node))] = 1;
+        }
+        std::vector<char> in_corridor(on_path.size(), 0);
+        for (int cy = 0; cy < graph->clustersY(); ++cy) {
+            for (int cx = 0; cx < graph->clustersX(); ++cx) {
+                if (!on_path[static_cast<std::size_t>(cy * graph->clustersX() + cx)]) { continue; }
+                for (int ny = std::max(0, cy - radius); ny <= std::min(graph->clustersY() - 1, cy + radius); ++ny) {
+                    for (int nx = std::max(0, cx - radius); nx <= std::min(graph->clustersX() - 1, cx + radius); ++nx) {
+                        in_corridor[static_cast<std::size_t>(ny * graph->clustersX() + nx)] = 1;
+                    }
+                }
+            }
+        }
+
+        if (context.queue_type == QueueType::RadixHeap) {
+            return runCorridorAStar<RadixHeapQueue>(context, *graph, in_corridor, workspace, start, end);
+        }
+        return runCorridorAStar<BinaryHeapQueue>(context, *graph, in_corridor, workspace, start, end);
+    }
+
+    std::vector<int> findHPAStarPath_Tobler_Sampled(
+        const PathfindingContext& context,
+        const GridPoint& start,
+        const GridPoint& end
+    ) {
+        return findHPAStarPath_Tobler_Sampled(context, threadLocalSearchWorkspace(), start, end);
+    }
+
+} // namespace Pathfinding
@@ -0,0 +1,231 @@
+// File: HierarchicalGraph.cpp
+
+#include "algoritms/HierarchicalGraph.hpp"
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"
+#include "algoritms/SearchQueues.hpp"
+#include "map/PathfindingUtils.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+#include <omp.h>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        int directionOf(int step_x, int step_y) {
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                if (dx[dir] == step_x && dy[dir] == step_y) { return dir; }
+            }
+            return -1;
+        }
+
+        struct Crossing {
+            int a_cell;
+            int b_cell;
+            int dir_ab; // Direction of the step a -> b
+        };
+
+    } // end anonymous namespace
+
+    std::size_t HierarchicalGraph::memoryBytes() const {
+        return node_cell_.size() * sizeof(int) + node_cluster_.size() * sizeof(int) +
+            cluster_first_node_.size() * sizeof(int) + edge_offsets_.size() * sizeof(std::size_t) +
+            edges_.size() * sizeof(Edge);
+    }
+
+    void HierarchicalGraph::searchCluster(const PathfindingContext& context, int cluster, int source_cell, bool reverse,
+        int target_cell, ClusterSearch& search) const
+    {
+        const Grid_V3& grid = *context.grid;
+        const EdgeCostCache* edge_costs = context.hasEdgeCosts() ? context.edge_costs : nullptr;
+
+        search.x0 = (cluster % clusters_x_) * cluster_size_;
+        search.y0 = (cluster / clusters_x_) * cluster_size_;
+        search.width = std::min(cluster_size_, width_ - search.x0);
+        search.height = std::min(cluster_size_, height_ - search.y0);
+        const std::size_t local_size = static_cast<std::size_t>(search.width) * static_cast<std::size_t>(search.height);
+        search.dist.assign(local_size, std::numeric_limits<float>::max());
+        search.parent.assign(local_size, -1);
+        search.closed.assign(local_size, 0);
+
+        int sx, sy;
+        toCoords(source_cell, width_, sx, sy);
+        if (!search.contains(sx, sy)) { return; }
+
+        RadixHeapQueue openQueue;
+        search.dist[static_cast<std::size_t>(search.localIndex(sx, sy))] = 0.0f;
+        openQueue.push(0.0f, search.localIndex(sx, sy));
+
+        while (!openQueue.empty()) {
+            const int local = openQueue.popMin().second;
+            if (search.closed[static_cast<std::size_t>(local)]) { continue; } // stale entry
+            search.closed[static_cast<std::size_t>(local)] = 1;
+
+            const int x = search.x0 + local % search.width;
+            const int y = search.y0 + local / search.width;
+            const int cell = toIndex(x, y, width_);
+            if (cell == target_cell) { break; }
+            const float current_dist = search.dist[static_cast<std::size_t>(local)];
+
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                const int nx = x + dx[dir];
+                const int ny = y + dy[dir];
+                if (!search.contains(nx, ny)) { continue; } // Stay inside the cluster
+
+                const float edge_cost = reverse ? reverseStepCost(context, edge_costs, x, y, dir) : stepCost(context, edge_costs, x, y, dir);
+                if (edge_cost >= std::numeric_limits<float>::max()) { continue; }
+
+                const int neighbor_local = search.localIndex(nx, ny);
+                const float tentative = current_dist + edge_cost;
+                if (tentative < search.dist[static_cast<std::size_t>(neighbor_local)]) {
+                    search.dist[static_cast<std::size_t>(neighbor_local)] = tentative;
+                    search.parent[static_cast<std::size_t>(neighbor_local)] = cell;
+                    openQueue.push(tentative, neighbor_local);
+                }
+            }
+        }
+    }
+
+    HierarchicalGraph HierarchicalGraph::build(const PathfindingContext& context, const Settings& settings) {
+        HierarchicalGraph graph;
+        const EdgeCostCache* edge_costs = context.hasEdgeCosts() ? context.edge_costs : nullptr;
+        if (!context.isValid() || (edge_costs == nullptr && !context.hasElevation()) || settings.cluster_size < 2) {
+            return graph;
+        }
+        const Grid_V3& grid = *context.grid;
+        const int width = static_cast<int>(grid.width());
+        const int height = static_cast<int>(grid.height());
+        const int cluster_size = settings.cluster_size;
+        const int entrance_spacing = std::max(1, settings.entrance_spacing);
+
+        graph.width_ = width;
+        graph.height_ = height;
+        graph.cluster_size_ = cluster_size;
+        graph.corridor_radius_ = std::max(0, settings.corridor_radius);
+        graph.clusters_x_ = (width + cluster_size - 1) / cluster_size;
+        graph.clusters_y_ = (height + cluster_size - 1) / cluster_size;
+        const int cluster_count = graph.clusters_x_ * graph.clusters_y_;
+
+        // --- 1. Entrances (serial; only the cells along cluster borders are scanned) ---
+        std::vector<std::vector<int>> cluster_cells(static_cast<std::size_t>(cluster_count));
+        std::vector<Crossing> crossings;
+
+        // Walks k = 0..length-1 along a border: a_k = (ax + k*sx, ay + k*sy) on one side, b_k = a_k + (bdx, bdy) on the other
+        auto scanBorder = [&](int ax, int ay, int step_x, int step_y, int bdx, int bdy, int length) {
+            const int dir_ab = directionOf(bdx, bdy);
+            auto addEntrance = [&](int k) {
+                const int cax = ax + k * step_x, cay = ay + k * step_y;
+                const int cbx = cax + bdx, cby = cay + bdy;
+                const int a_cell = toIndex(cax, cay, width);
+                const int b_cell = toIndex(cbx, cby, width);
+                cluster_cells[static_cast<std::size_t>(graph.clusterOf(cax, cay))].push_back(a_cell);
+                cluster_cells[static_cast<std::size_t>(graph.clusterOf(cbx, cby))].push_back(b_cell);
+                crossings.push_back({ a_cell, b_cell, dir_ab });
+            };
+
+            int run_start = -1;
+            for (int k = 0; k <= length; ++k) {
+                const bool open = k < length &&
+                    isPassable(grid, ax + k * step_x, ay + k * step_y) &&
+                    isPassable(grid, ax + k * step_x + bdx, ay + k * step_y + bdy);
+                if (open && run_start < 0) { run_start = k; }
+                if (!open && run_start >= 0) {
+                    // ceil(run / spacing) entrances, each in the middle of an equal share of the run
+                    const int run_length = k - run_start;
+                    const int entrances = (run_length + entrance_spacing - 1) / entrance_spacing;
+                    for (int e = 0; e < entrances; ++e) {
+                        addEntrance(run_start + ((2 * e + 1) * run_length) / (2 * entrances));
+                    }
+                    run_start = -1;
+                }
+            }
+        };
+
+        for (int bx = 1; bx < graph.clusters_x_; ++bx) { // Vertical borders, one run scan per cluster row
+            for (int cy = 0; cy < graph.clusters_y_; ++cy) {
+                const int y0 = cy * cluster_size;
+                scanBorder(bx * cluster_size - 1, y0, 0, 1, 1, 0, std::min(cluster_size, height - y0));
+            }
+        }
+        for (int by = 1; by < graph.clusters_y_; ++by) { // Horizontal borders, one run scan per cluster column
+            for (int cx = 0; cx < graph.clusters_x_; ++cx) {
+                const int x0 = cx * cluster_size;
+                scanBorder(x0, by * cluster_size - 1, 1, 0, 0, 1, std::min(cluster_size, width - x0));
+            }
+        }
+
+        // --- 2. Abstract nodes, grouped by cluster ---
+        graph.cluster_first_node_.assign(static_cast<std::size_t>(cluster_count) + 1, 0);
+        std::unordered_map<int, int> node_of_cell;
+        for (int c = 0; c < cluster_count; ++c) {
+            std::vector<int>& cells = cluster_cells[static_cast<std::size_t>(c)];
+            std::sort(cells.begin(), cells.end());
+            cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+            graph.cluster_first_node_[static_cast<std::size_t>(c)] = static_cast<int>(graph.node_cell_.size());
+            for (int cell : cells) {
+                node_of_cell.emplace(cell, static_cast<int>(graph.node_cell_.size()));
+                graph.node_cell_.push_back(cell);
+                graph.node_cluster_.push_back(c);
+            }
+        }
+        graph.cluster_first_node_[static_cast<std::size_t>(cluster_count)] = static_cast<int>(graph.node_cell_.size());
+        const int node_count = static_cast<int>(graph.node_cell_.size());
+
+        std::vector<std::vector<Edge>> adjacency(static_cast<std::size_t>(node_count));
+
+        // --- 3. Inter-cluster edges: the single step across the border, each direction costed separately ---
+        for (const Crossing& crossing : crossings) {
+            int ax, ay, bx, by;
+            toCoords(crossing.a_cell, width, ax, ay);
+            toCoords(crossing.b_cell, width, bx, by);
+            const int a_node = node_of_cell[crossing.a_cell];
+            const int b_node = node_of_cell[crossing.b_cell];
+            const float cost_ab = stepCost(context, edge_costs, ax, ay, crossing.dir_ab);
+            const float cost_ba = stepCost(context, edge_costs, bx, by, reverse_dir[crossing.dir_ab]);
+            if (cost_ab < std::numeric_limits<float>::max()) { adjacency[static_cast<std::size_t>(a_node)].push_back({ b_node, cost_ab }); }
+            if (cost_ba < std::numeric_limits<float>::max()) { adjacency[static_cast<std::size_t>(b_node)].push_back({ a_node, cost_ba }); }
+        }
+
+        // --- 4. Intra-cluster edges: one confined Dijkstra per entrance node (clusters in parallel) ---
+        // Each cluster only appends to the adjacency lists of its own nodes. Dynamic schedule since
+        // entrance counts vary a lot between open and obstructed clusters.
+#pragma omp parallel
+        {
+            ClusterSearch search;
+#pragma omp for schedule(dynamic, 4)
+            for (int c = 0; c < cluster_count; ++c) {
+                const int first = graph.clusterNodesBegin(c);
+                const int last = graph.clusterNodesEnd(c);
+                for (int u = first; u < last; ++u) {
+                    graph.searchCluster(context, c, graph.nodeCell(u), false, -1, search);
+                    for (int v = first; v < last; ++v) {
+                        if (v == u) { continue; }
+                        int vx, vy;
+                        toCoords(graph.nodeCell(v), width, vx, vy);
+                        const float cost = search.distTo(vx, vy);
+                        if (cost < std::numeric_limits<float>::max()) {
+                            adjacency[static_cast<std::size_t>(u)].push_back({ v, cost });
+                        }
+                    }
+                }
+            }
+        }
+
+        // --- 5. Flatten to CSR ---
+        graph.edge_offsets_.assign(static_cast<std::size_t>(node_count) + 1, 0);
+        for (int u = 0; u < node_count; ++u) {
+            graph.edge_offsets_[static_cast<std::size_t>(u) + 1] = graph.edge_offsets_[static_cast<std::size_t>(u)] + adjacency[static_cast<std::size_t>(u)].size();
+        }
+        graph.edges_.reserve(graph.edge_offsets_.back());
+        for (const std::vector<Edge>& edges : adjacency) {
+            graph.edges_.insert(graph.edges_.end(), edges.begin(), edges.end());
+        }
+        return graph;
+    }
+
+} // namespace Pathfinding
@@ -0,0 +1,218 @@
+// File: LPAStarToblerSampled.cpp
+
+#include "algoritms/LPAStarToblerSampled.hpp"
+#include "map/MapProcessingCommon.h"
+#include "map/ElevationRaster.hpp"
+#include "algoritms/ToblerKernel.hpp"
+
+#include <vector>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <new>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+        constexpr float INF = std::numeric_limits<float>::max();
+    } // end anonymous namespace
+
+    LPAStarPlanner::LPAStarPlanner(const PathfindingContext& context, const GridPoint& start, const GridPoint& end) {
+        if (!context.isValid() || !context.hasElevation()) { return; }
+        const Grid_V3& grid = *context.grid;
+        if (!grid.inBounds(start.x, start.y) || !grid.inBounds(end.x, end.y)) { return; }
+        width_ = static_cast<int>(grid.width());
+        height_ = static_cast<int>(grid.height());
+        start_idx_ = toIndex(start.x, start.y, width_);
+        end_idx_ = toIndex(end.x, end.y, width_);
+        h_scale_ = context.min_terrain_cost;
+        try {
+            g_.assign(grid.data().size(), INF);
+            rhs_.assign(grid.data().size(), INF);
+        }
+        catch (const std::bad_alloc&) {
+            g_.clear();
+            rhs_.clear();
+            return;
+        }
+        context_ = &context;
+
+        rhs_[static_cast<size_t>(start_idx_)] = 0.0f;
+        open_.push({ calculateKey(start_idx_), start_idx_ });
+    }
+
+    float LPAStarPlanner::heuristic(int idx) const {
+        int x, y, ex, ey;
+        toCoords(idx, width_, x, y);
+        toCoords(end_idx_, width_, ex, ey);
+        return h_scale_ * internal::euclidean_distance(x, y, ex, ey);
+    }
+
+    LPAStarPlanner::Key LPAStarPlanner::calculateKey(int idx) const {
+        const float m = std::min(g_[static_cast<size_t>(idx)], rhs_[static_cast<size_t>(idx)]);
+        if (m >= INF) { return { INF, INF }; }
+        return { m + heuristic(idx), m };
+    }
+
+    float LPAStarPlanner::edgeCost(int from, int to, int dir) const {
+        // Same cost as A*/Dijkstra: depends on the target cell's terrain and the elevation change
+        const GridCellData& cell = context_->grid->data()[static_cast<size_t>(to)];
+        if (!isPassable(cell)) { return INF; }
+        const float delta_h = context_->elevation->atIndex(to) - context_->elevation->atIndex(from);
+        return toblerStepCost(dir, context_->log_cell_resolution, delta_h, cell.value);
+    }
+
+    void LPAStarPlanner::updateVertex(int idx) {
+        const size_t i = static_cast<size_t>(idx);
+        if (idx != start_idx_) {
+            // rhs = best one-step lookahead over the 8 predecessors
+            int x, y;
+            toCoords(idx, width_, x, y);
+            float best = INF;
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                const int px = x - dx[dir];
+                const int py = y - dy[dir];
+                if (px < 0 || px >= width_ || py < 0 || py >= height_) { continue; }
+                const int predIdx = toIndex(px, py, width_);
+                const float pred_g = g_[static_cast<size_t>(predIdx)];
+                if (pred_g >= INF) { continue; }
+                const float cost = edgeCost(predIdx, idx, dir);
+                if (cost >= INF) { continue; }
+                best = std::min(best, pred_g + cost);
+            }
+            rhs_[i] = best;
+        }
+        // Lazy queue: a newer entry supersedes any older one for this cell
+        if (g_[i] != rhs_[i]) { open_.push({ calculateKey(idx), idx }); }
+    }
+
+    bool LPAStarPlanner::topKey(Key& key) {
+        while (!open_.empty()) {
+            const Entry& top = open_.top();
+            const size_t i = static_cast<size_t>(top.idx);
+            if (g_[i] != rhs_[i] && top.key == calculateKey(top.idx)) {
+                key = top.key;
+                return true;
+            }
+            open_.pop(); // Consistent by now, or superseded by a newer entry
+        }
+        return false;
+    }
+
+    void LPAStarPlanner::rebuildQueue() {
+        std::vector<int> pending;
+        pending.reserve(open_.size());
+        while (!open_.empty()) {
+            const int idx = open_.top().idx;
+            open_.pop();
+            if (g_[static_cast<size_t>(idx)] != rhs_[static_cast<size_t>(idx)]) { pending.push_back(idx); }
+        }
+        std::sort(pending.begin(), pending.end());
+        pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+        for (int idx : pending) { open_.push({ calculateKey(idx), idx }); }
+        needs_rekey_ = false;
+    }
+
+    void LPAStarPlanner::notifyCellChanged(int idx) {
+        if (!isValid() || idx < 0 || static_cast<size_t>(idx) >= g_.size()) { return; }
+        // Keep h admissible and consistent: it may never exceed the cheapest terrain times the distance
+        const GridCellData& cell = context_->grid->data()[static_cast<size_t>(idx)];
+        if (isPassable(cell) && cell.value < h_scale_) {
+            h_scale_ = cell.value;
+            needs_rekey_ = true;
+        }
+        updateVertex(idx);
+    }
+
+    float LPAStarPlanner::pathCost() const {
+        if (!isValid()) { return INF; }
+        return g_[static_cast<size_t>(end_idx_)];
+    }
+
+    std::vector<int> LPAStarPlanner::computePath() {
+        last_expansions_ = 0;
+        if (!isValid()) { return {}; }
+        const Grid_V3& grid = *context_->grid;
+        const GridCellData* cells = grid.data().data();
+        if (!isPassable(cells[static_cast<size_t>(start_idx_)]) || !isPassable(cells[static_cast<size_t>(end_idx_)])) { return {}; }
+        if (start_idx_ == end_idx_) { return { start_idx_ }; }
+        if (needs_rekey_) { rebuildQueue(); }
+
+        // --- ComputeShortestPath: expand inconsistent cells until the end is consistent and no cheaper key is left ---
+        const size_t end = static_cast<size_t>(end_idx_);
+        Key top;
+        while (topKey(top) && (top < calculateKey(end_idx_) || rhs_[end] != g_[end])) {
+            const int u = open_.top().idx;
+            open_.pop();
+            const size_t ui = static_cast<size_t>(u);
+            ++last_expansions_;
+
+            int x, y;
+            toCoords(u, width_, x, y);
+            if (g_[ui] > rhs_[ui]) {
+                // Overconsistent: settle, and offer the new cost to the successors
+                g_[ui] = rhs_[ui];
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    const int nx = x + dx[dir];
+                    const int ny = y + dy[dir];
+                    if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_) { continue; }
+                    const int s = toIndex(nx, ny, width_);
+                    if (s == start_idx_) { continue; }
+                    const float cost = edgeCost(u, s, dir);
+                    if (cost >= INF) { continue; }
+                    const float candidate = g_[ui] + cost;
+                    const size_t si = static_cast<size_t>(s);
+                    if (candidate < rhs_[si]) {
+                        rhs_[si] = candidate;
+                        if (g_[si] != rhs_[si]) { open_.push({ calculateKey(s), s }); }
+                    }
+                }
+            }
+            else {
+                // Underconsistent: forget g, and re-derive this cell and everything that may have relied on it
+                g_[ui] = INF;
+                updateVertex(u);
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    const int nx = x + dx[dir];
+                    const int ny = y + dy[dir];
+                    if (nx < 0 || nx >= width_ || ny < 0 || ny >= height_) { continue; }
+                    updateVertex(toIndex(nx, ny, width_));
+                }
+            }
+        }
+
+        // --- Path: walk back from the end along the predecessor that realises g ---
+        std::vector<int> path;
+        if (g_[end] >= INF) { return path; }
+        int current = end_idx_;
+        const size_t max_path_len = g_.size() + 1;
+        while (current != start_idx_ && path.size() < max_path_len) {
+            path.push_back(current);
+            int x, y;
+            toCoords(current, width_, x, y);
+            int best_pred = -1;
+            float best = INF;
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                const int px = x - dx[dir];
+                const int py = y - dy[dir];
+                if (px < 0 || px >= width_ || py < 0 || py >= height_) { continue; }
+                const int predIdx = toIndex(px, py, width_);
+                const float pred_g = g_[static_cast<size_t>(predIdx)];
+                if (pred_g >= INF) { continue; }
+                const float cost = edgeCost(predIdx, current, dir);
+                if (cost >= INF) { continue; }
+                if (pred_g + cost < best) { best = pred_g + cost; best_pred = predIdx; }
+            }
+            if (best_pred == -1) { return {}; }
+            current = best_pred;
+        }
+        if (current != start_idx_) { return {}; }
+        path.push_back(start_idx_);
+        std::reverse(path.begin(), path.end());
+        return path;
+    }
+
+} // namespace Pathfinding
@@ -0,0 +1,199 @@
+// File: LandmarkHeuristic.cpp
+
+#include "algoritms/LandmarkHeuristic.hpp"
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"
+#include "algoritms/SearchQueues.hpp"
+#include "map/PathfindingUtils.hpp"
+
+#include <cmath>
+#include <limits>
+#include <new>
+#include <utility>
+#include <omp.h>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        // Cells of ring r (r cells in from the border), clockwise from the top-left corner
+        std::vector<int> ringCells(int width, int height, int r) {
+            std::vector<int> cells;
+            const int x0 = r, y0 = r, x1 = width - 1 - r, y1 = height - 1 - r;
+            if (x0 > x1 || y0 > y1) { return cells; }
+            for (int x = x0; x <= x1; ++x) cells.push_back(toIndex(x, y0, width));
+            for (int y = y0 + 1; y <= y1; ++y) cells.push_back(toIndex(x1, y, width));
+            if (y1 > y0) { for (int x = x1 - 1; x >= x0; --x) cells.push_back(toIndex(x, y1, width)); }
+            if (x1 > x0) { for (int y = y1 - 1; y > y0; --y) cells.push_back(toIndex(x0, y, width)); }
+            return cells;
+        }
+
+        // Up to count passable cells spread evenly along the outermost ring that has any
+        std::vector<int> selectLandmarks(const Grid_V3& grid, int count) {
+            const int width = static_cast<int>(grid.width());
+            const int height = static_cast<int>(grid.height());
+            std::vector<int> landmarks;
+            for (int r = 0; 2 * r < std::min(width, height) && landmarks.empty(); ++r) {
+                const std::vector<int> ring = ringCells(width, height, r);
+                std::vector<char> passable(ring.size());
+                bool any = false;
+                for (std::size_t i = 0; i < ring.size(); ++i) {
+                    int x, y;
+                    toCoords(ring[i], width, x, y);
+                    passable[i] = isPassable(grid, x, y) ? 1 : 0;
+                    any = any || passable[i];
+                }
+                if (!any) { continue; }
+
+                const long long perimeter = static_cast<long long>(ring.size());
+                for (int l = 0; l < count; ++l) {
+                    // Ideal position: middle of the l-th of count equal arcs; take the nearest passable cell
+                    const long long ideal = (perimeter * (2 * l + 1)) / (2 * count);
+                    for (long long offset = 0; offset <= perimeter / 2; ++offset) {
+                        const long long a = (ideal + offset) % perimeter;
+                        const long long b = (ideal - offset + perimeter) % perimeter;
+                        const long long pick = passable[static_cast<std::size_t>(a)] ? a : (passable[static_cast<std::size_t>(b)] ? b : -1);
+                        if (pick < 0) { continue; }
+                        const int cell = ring[static_cast<std::size_t>(pick)];
+                        if (std::find(landmarks.begin(), landmarks.end(), cell) == landmarks.end()) { landmarks.push_back(cell); }
+                        break;
+                    }
+                }
+            }
+            return landmarks;
+        }
+
+        // Full-grid Dijkstra from (or, with reverse, to) source; dist must hold width*height entries
+        void landmarkDijkstra(const PathfindingContext& context, const EdgeCostCache* edge_costs, int source, bool reverse, std::vector<float>& dist) {
+            const Grid_V3& grid = *context.grid;
+            const int width = static_cast<int>(grid.width());
+            const int height = static_cast<int>(grid.height());
+            std::fill(dist.begin(), dist.end(), std::numeric_limits<float>::max());
+
+            RadixHeapQueue openQueue;
+            dist[static_cast<std::size_t>(source)] = 0.0f;
+            openQueue.push(0.0f, source);
+            while (!openQueue.empty()) {
+                const auto [key, current] = openQueue.popMin();
+                const float current_dist = dist[static_cast<std::size_t>(current)];
+                if (key > current_dist) { continue; } // stale entry
+                int x, y;
+                toCoords(current, width, x, y);
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    const int nx = x + dx[dir];
+                    const int ny = y + dy[dir];
+                    if (nx < 0 || nx >= width || ny < 0 || ny >= height) { continue; }
+                    const float edge_cost = reverse ? reverseStepCost(context, edge_costs, x, y, dir) : stepCost(context, edge_costs, x, y, dir);
+                    if (edge_cost >= std::numeric_limits<float>::max()) { continue; }
+                    const int neighborIdx = toIndex(nx, ny, width);
+                    const float tentative = current_dist + edge_cost;
+                    if (tentative < dist[static_cast<std::size_t>(neighborIdx)]) {
+                        dist[static_cast<std::size_t>(neighborIdx)] = tentative;
+                        openQueue.push(tentative, neighborIdx);
+                    }
+                }
+            }
+        }
+
+    } // end anonymous namespace
+
+    LandmarkHeuristic LandmarkHeuristic::build(const PathfindingContext& context, int landmark_count) {
+        LandmarkHeuristic result;
+        // Only the exact cache is used, so the tables do not depend on the cache mode
+        const EdgeCostCache* edge_costs = (context.hasEdgeCosts() && context.edge_costs->precision() == EdgeCostCache::Precision::Float32)
+            ? context.edge_costs : nullptr;
+        if (!context.isValid() || (edge_costs == nullptr && !context.hasElevation()) || landmark_count <= 0) {
+            return result;
+        }
+        const Grid_V3& grid = *context.grid;
+        const std::size_t cell_count = grid.width() * grid.height();
+
+        std::vector<int> landmarks = selectLandmarks(grid, landmark_count);
+        if (landmarks.empty()) { return result; }
+        const int stride = 2 * static_cast<int>(landmarks.size());
+
+        try {
+            result.distances_.assign(cell_count * static_cast<std::size_t>(stride), UNREACHABLE);
+        }
+        catch (const std::bad_alloc&) {
+            return LandmarkHeuristic();
+        }
+        result.scales_.assign(static_cast<std::size_t>(stride), 1.0f);
+
+        // One task per (landmark, direction); each thread reuses one float distance buffer
+        bool out_of_memory = false;
+#pragma omp parallel
+        {
+            std::vector<float> dist;
+            bool have_buffer = false;
+            try { dist.resize(cell_count); have_buffer = true; }
+            catch (const std::bad_alloc&) {}
+            if (!have_buffer) {
+#pragma omp atomic write
+                out_of_memory = true;
+            }
+
+#pragma omp for schedule(dynamic, 1)
+            for (int task = 0; task < stride; ++task) {
+                if (!have_buffer) { continue; }
+                landmarkDijkstra(context, edge_costs, landmarks[static_cast<std::size_t>(task / 2)], (task % 2) == 1, dist);
+
+                float max_dist = 0.0f;
+                for (float d : dist) {
+                    if (d < std::numeric_limits<float>::max()) { max_dist = std::max(max_dist, d); }
+                }
+                // 65534 finite levels; floor() so every stored level is <= the true distance
+                const float scale = (max_dist > 0.0f) ? max_dist / 65534.0f : 1.0f;
+                result.scales_[static_cast<std::size_t>(task)] = scale;
+                const float inv_scale = 1.0f / scale;
+                std::uint16_t* out = result.distances_.data() + task;
+                for (std::size_t i = 0; i < cell_count; ++i) {
+                    if (dist[i] < std::numeric_limits<float>::max()) {
+                        out[i * static_cast<std::size_t>(stride)] = static_cast<std::uint16_t>(std::min(65534.0f, std::floor(dist[i] * inv_scale)));
+                    }
+                }
+            }
+        }
+        if (out_of_memory) { return LandmarkHeuristic(); }
+
+        result.width_ = grid.width();
+        result.height_ = grid.height();
+        result.landmark_cells_ = std::move(landmarks);
+        return result;
+    }
+
+    LandmarkHeuristic LandmarkHeuristic::fromTables(std::size_t width, std::size_t height, std::vector<int> landmark_cells,
+        std::vector<float> scales, std::vector<std::uint16_t> distances)
+    {
+        LandmarkHeuristic result;
+        const std::size_t stride = 2 * landmark_cells.size();
+        if (width == 0 || height == 0 || landmark_cells.empty() || scales.size() != stride ||
+            distances.size() != width * height * stride) {
+            return result;
+        }
+        for (int cell : landmark_cells) {
+            if (cell < 0 || static_cast<std::size_t>(cell) >= width * height) { return result; }
+        }
+        result.width_ = width;
+        result.height_ = height;
+        result.landmark_cells_ = std::move(landmark_cells);
+        result.scales_ = std::move(scales);
+        result.distances_ = std::move(distances);
+        return result;
+    }
+
+    LandmarkHeuristic::Query LandmarkHeuristic::forTarget(int target_idx, float cost_shrink) const {
+        Query query;
+        query.table_ = this;
+        query.stride_ = 2 * landmarkCount();
+        const std::uint16_t* q = distances_.data() + static_cast<std::size_t>(target_idx) * static_cast<std::size_t>(query.stride_);
+        query.target_.assign(q, q + query.stride_);
+        query.scales_ = scales_;
+        query.shrink_ = cost_shrink;
+        return query;
+    }
+
+} // namespace Pathfinding
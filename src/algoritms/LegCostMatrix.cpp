@@ -0,0 +1,37 @@
+// File: LegCostMatrix.cpp
+
+#include "algoritms/LegCostMatrix.hpp"
+
+#include <algorithm>
+#include <omp.h>
+
+namespace Pathfinding {
+
+    LegCostMatrix computeLegCostMatrix(
+        const PathfindingContext& context,
+        const std::vector<GridPoint>& points,
+        bool with_paths
+    ) {
+        LegCostMatrix matrix;
+        const std::size_t n = points.size();
+        matrix.size = n;
+        matrix.costs.assign(n * n, std::numeric_limits<float>::max());
+        if (with_paths) { matrix.paths.assign(n * n, std::vector<int>()); }
+
+        // One search per source row; rows are independent, so threads never share output cells
+        const int rows = static_cast<int>(n);
+#pragma omp parallel for schedule(dynamic, 1)
+        for (int from = 0; from < rows; ++from) {
+            std::vector<std::vector<int>> rowPaths;
+            const std::vector<float> rowCosts = findDijkstraOneToMany_Tobler_Sampled(
+                context, threadLocalSearchWorkspace(), points[static_cast<std::size_t>(from)], points, with_paths ? &rowPaths : nullptr);
+            const std::size_t row = static_cast<std::size_t>(from) * n;
+            std::copy(rowCosts.begin(), rowCosts.end(), matrix.costs.begin() + static_cast<std::ptrdiff_t>(row));
+            if (with_paths) {
+                std::move(rowPaths.begin(), rowPaths.end(), matrix.paths.begin() + static_cast<std::ptrdiff_t>(row));
+            }
+        }
+        return matrix;
+    }
+
+} // namespace Pathfinding
@@ -0,0 +1,53 @@
+// File: PathfindingContext.cpp
+
+#include "algoritms/PathfindingContext.hpp"
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/LandmarkHeuristic.hpp"
+#include "algoritms/TravelTimeField.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <omp.h>
+
+using namespace mapgeo;
+
+namespace Pathfinding {
+
+    bool PathfindingContext::hasEdgeCosts() const {
+        return edge_costs != nullptr && edge_costs->isValid() && grid != nullptr &&
+            edge_costs->width() == grid->width() && edge_costs->height() == grid->height();
+    }
+
+    bool PathfindingContext::hasLandmarks() const {
+        return landmarks != nullptr && landmarks->isValid() && grid != nullptr &&
+            landmarks->width() == grid->width() && landmarks->height() == grid->height();
+    }
+
+    bool PathfindingContext::hasTravelTimeTo(int targetIdx) const {
+        return travel_time != nullptr && travel_time->isValid() && grid != nullptr &&
+            travel_time->width() == grid->width() && travel_time->height() == grid->height() &&
+            travel_time->targetIndex() == targetIdx;
+    }
+
+    PathfindingContext makePathfindingContext(const Grid_V3& grid, const ElevationRaster* elevation, float log_cell_resolution) {
+        PathfindingContext ctx;
+        ctx.grid = &grid;
+        ctx.elevation = elevation;
+        ctx.log_cell_resolution = log_cell_resolution;
+
+        // Minimum terrain cost over passable cells, used to keep the Theta* heuristics admissible.
+        // Zero- or negative-valued cells are impassable and excluded.
+        const auto& cells = grid.data();
+        float min_cost = std::numeric_limits<float>::max();
+#pragma omp parallel for reduction(min:min_cost) schedule(static)
+        for (long long i = 0; i < static_cast<long long>(cells.size()); ++i) {
+            const GridCellData& cell = cells[static_cast<std::size_t>(i)];
+            if (!cell.hasFlag(GridFlags::FLAG_IMPASSABLE) && cell.value > 0.0f) {
+                min_cost = std::min(min_cost, cell.value);
+            }
+        }
+        ctx.min_terrain_cost = (min_cost >= std::numeric_limits<float>::max()) ? 0.0f : min_cost;
+        return ctx;
+    }
+
+} // namespace Pathfinding
@@ -0,0 +1,35 @@
+// File: SearchWorkspace.cpp
+
+#include "algoritms/SearchWorkspace.hpp"
+
+#include <new>
+
+namespace Pathfinding {
+
+    bool SearchWorkspace::beginQuery(std::size_t cell_count) {
+        try {
+            if (cells_.size() < cell_count) {
+                cells_.resize(cell_count); // New cells carry stamp 0, which is never live
+            }
+        }
+        catch (const std::bad_alloc&) {
+            return false;
+        }
+
+        ++generation_;
+        if (generation_ == 0) {
+            // Counter wrapped: stale stamps could alias the new generation, so clear them once
+            for (Cell& c : cells_) { c.stamp = 0; c.closed_stamp = 0; }
+            generation_ = 1;
+        }
+        touched_ = 0;
+        segment_cache_.clear();
+        return true;
+    }
+
+    SearchWorkspace& threadLocalSearchWorkspace() {
+        static thread_local SearchWorkspace workspace;
+        return workspace;
+    }
+
+} // namespace Pathfinding
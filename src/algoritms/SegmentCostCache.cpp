@@ -0,0 +1,40 @@
+// File: SegmentCostCache.cpp
+
+#include "algoritms/SegmentCostCache.hpp"
+
+#include <new>
+
+namespace Pathfinding {
+
+    SegmentCostCache::SegmentCostCache(std::size_t capacity) {
+        // Round up to a power of two (at least PROBE_LIMIT slots) so slots wrap with a mask
+        capacity_ = static_cast<std::size_t>(PROBE_LIMIT);
+        shift_ = 64 - 2;
+        while (capacity_ < capacity) { capacity_ <<= 1; --shift_; }
+        mask_ = capacity_ - 1;
+    }
+
+    bool SegmentCostCache::allocate() {
+        try {
+            entries_.assign(capacity_, Entry{});
+        }
+        catch (const std::bad_alloc&) {
+            entries_.clear();
+            allocation_failed_ = true;
+            return false;
+        }
+        return true;
+    }
+
+    void SegmentCostCache::clear() {
+        ++generation_;
+        if (generation_ == 0) {
+            // Counter wrapped: stale stamps could alias the new generation, so clear them once
+            for (Entry& e : entries_) { e.stamp = 0; }
+            generation_ = 1;
+        }
+        hits_ = 0;
+        misses_ = 0;
+    }
+
+} // namespace Pathfinding
@@ -0,0 +1,162 @@
+// File: ToblerKernel.cpp
+
+#include "algoritms/ToblerKernel.hpp"
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TOBLER_KERNEL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TOBLER_TARGET_SSE2
+#define TOBLER_TARGET_AVX2
+#else
+#define TOBLER_TARGET_SSE2 __attribute__((target("sse2")))
+#define TOBLER_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define TOBLER_KERNEL_X86 0
+#endif
+
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        void costs8Scalar(float resolution, const float* delta_h, const float* terrain, float* out) {
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                out[dir] = (terrain[dir] > 0.0f)
+                    ? toblerStepCost(dir, resolution, delta_h[dir], terrain[dir])
+                    : std::numeric_limits<float>::max();
+            }
+        }
+
+#if TOBLER_KERNEL_X86
+        // The SIMD variants mirror toblerStepCost()/expNonNegative() operation for operation (no FMA),
+        // so they round identically. Blocked lanes are evaluated too and masked to max() at the end.
+        using namespace tobler_kernel_detail;
+
+        TOBLER_TARGET_SSE2 __m128 costs4Sse2(__m128 base, __m128 res, __m128 dh, __m128 terrain) {
+            const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            const __m128 S = _mm_div_ps(dh, _mm_mul_ps(base, res));
+            const __m128 x = _mm_mul_ps(_mm_set1_ps(SLOPE_RATE), _mm_and_ps(_mm_add_ps(S, _mm_set1_ps(SLOPE_OFFSET)), abs_mask));
+            const __m128 blocked = _mm_or_ps(_mm_cmpnlt_ps(x, _mm_set1_ps(LN_INV_EPSILON)), _mm_cmpngt_ps(terrain, _mm_setzero_ps()));
+
+            const __m128 xc = _mm_min_ps(x, _mm_set1_ps(EXP_CLAMP));
+            const __m128i n = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(xc, _mm_set1_ps(LOG2E)), _mm_set1_ps(0.5f)));
+            const __m128 fn = _mm_cvtepi32_ps(n);
+            const __m128 r = _mm_sub_ps(_mm_sub_ps(xc, _mm_mul_ps(fn, _mm_set1_ps(LN2_HI))), _mm_mul_ps(fn, _mm_set1_ps(LN2_LO)));
+            const __m128 z = _mm_mul_ps(r, r);
+            __m128 p = _mm_set1_ps(P0);
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(P1));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(P2));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(P3));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(P4));
+            p = _mm_add_ps(_mm_mul_ps(p, r), _mm_set1_ps(P5));
+            const __m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(p, z), r), _mm_set1_ps(1.0f));
+            const __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+            const __m128 penalty = _mm_min_ps(_mm_mul_ps(e, scale), _mm_set1_ps(MAX_TOBLER_PENALTY));
+
+            const __m128 cost = _mm_mul_ps(_mm_mul_ps(base, terrain), penalty);
+            return _mm_or_ps(_mm_and_ps(blocked, _mm_set1_ps(std::numeric_limits<float>::max())), _mm_andnot_ps(blocked, cost));
+        }
+
+        TOBLER_TARGET_SSE2 void costs8Sse2(float resolution, const float* delta_h, const float* terrain, float* out) {
+            const __m128 res = _mm_set1_ps(resolution);
+            _mm_storeu_ps(out, costs4Sse2(_mm_loadu_ps(costs), res, _mm_loadu_ps(delta_h), _mm_loadu_ps(terrain)));
+            _mm_storeu_ps(out + 4, costs4Sse2(_mm_loadu_ps(costs + 4), res, _mm_loadu_ps(delta_h + 4), _mm_loadu_ps(terrain + 4)));
+        }
+
+        TOBLER_TARGET_AVX2 void costs8Avx2(float resolution, const float* delta_h, const float* terrain, float* out) {
+            const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+            const __m256 base = _mm256_loadu_ps(costs);
+            const __m256 dh = _mm256_loadu_ps(delta_h);
+            const __m256 ter = _mm256_loadu_ps(terrain);
+            const __m256 S = _mm256_div_ps(dh, _mm256_mul_ps(base, _mm256_set1_ps(resolution)));
+            const __m256 x = _mm256_mul_ps(_mm256_set1_ps(SLOPE_RATE), _mm256_and_ps(_mm256_add_ps(S, _mm256_set1_ps(SLOPE_OFFSET)), abs_mask));
+            const __m256 blocked = _mm256_or_ps(_mm256_cmp_ps(x, _mm256_set1_ps(LN_INV_EPSILON), _CMP_NLT_UQ),
+                _mm256_cmp_ps(ter, _mm256_setzero_ps(), _CMP_NGT_UQ));
+
+            const __m256 xc = _mm256_min_ps(x, _mm256_set1_ps(EXP_CLAMP));
+            const __m256i n = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(xc, _mm256_set1_ps(LOG2E)), _mm256_set1_ps(0.5f)));
+            const __m256 fn = _mm256_cvtepi32_ps(n);
+            const __m256 r = _mm256_sub_ps(_mm256_sub_ps(xc, _mm256_mul_ps(fn, _mm256_set1_ps(LN2_HI))), _mm256_mul_ps(fn, _mm256_set1_ps(LN2_LO)));
+            const __m256 z = _mm256_mul_ps(r, r);
+            __m256 p = _mm256_set1_ps(P0);
+            p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(P1));
+            p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(P2));
+            p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(P3));
+            p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(P4));
+            p = _mm256_add_ps(_mm256_mul_ps(p, r), _mm256_set1_ps(P5));
+            const __m256 e = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(p, z), r), _mm256_set1_ps(1.0f));
+            const __m256 scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+            const __m256 penalty = _mm256_min_ps(_mm256_mul_ps(e, scale), _mm256_set1_ps(MAX_TOBLER_PENALTY));
+
+            const __m256 cost = _mm256_mul_ps(_mm256_mul_ps(base, ter), penalty);
+            _mm256_storeu_ps(out, _mm256_blendv_ps(cost, _mm256_set1_ps(std::numeric_limits<float>::max()), blocked));
+        }
+
+        bool cpuHasAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int regs[4];
+            __cpuid(regs, 0);
+            if (regs[0] < 7) { return false; }
+            __cpuid(regs, 1);
+            const bool osxsave_avx = (regs[2] & (1 << 27)) != 0 && (regs[2] & (1 << 28)) != 0;
+            if (!osxsave_avx || (_xgetbv(0) & 0x6) != 0x6) { return false; } // OS saves the YMM state
+            __cpuidex(regs, 7, 0);
+            return (regs[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        }
+
+        bool cpuHasSse2() {
+#if defined(__x86_64__) || defined(_M_X64)
+            return true; // Baseline of x86-64
+#elif defined(_MSC_VER) && !defined(__clang__)
+            int regs[4];
+            __cpuid(regs, 1);
+            return (regs[3] & (1 << 26)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("sse2") != 0;
+#endif
+        }
+#endif // TOBLER_KERNEL_X86
+
+        const ToblerKernelVariant& kernel() {
+            static const ToblerKernelVariant choice = toblerKernelVariants().front();
+            return choice;
+        }
+
+    } // end anonymous namespace
+
+    void toblerEdgeCosts8(float resolution, const float* delta_h, const float* terrain, float* out) {
+        if (resolution * costs[0] <= EPSILON) { // Degenerate resolution: every edge is impassable, as in the reference
+            std::fill(out, out + NUM_DIRECTIONS, std::numeric_limits<float>::max());
+            return;
+        }
+        kernel().fn(resolution, delta_h, terrain, out);
+    }
+
+    const char* toblerKernelVariant() {
+        return kernel().name;
+    }
+
+    std::vector<ToblerKernelVariant> toblerKernelVariants() {
+        std::vector<ToblerKernelVariant> variants;
+#if TOBLER_KERNEL_X86
+        if (cpuHasAvx2()) { variants.push_back({ costs8Avx2, "avx2" }); }
+        if (cpuHasSse2()) { variants.push_back({ costs8Sse2, "sse2" }); }
+#endif
+        variants.push_back({ costs8Scalar, "scalar" });
+        return variants;
+    }
+
+} // namespace Pathfinding
@@ -0,0 +1,77 @@
+// File: TravelTimeField.cpp
+
+#include "algoritms/TravelTimeField.hpp"
+#include "algoritms/DeltaSteppingEngine.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <new>
+
+using namespace mapgeo;
+using namespace PathfindingUtils;
+
+namespace Pathfinding {
+
+    namespace {
+
+        // Bucket width: a few mean edge costs, estimated from a strided sample of cells
+        float autoDelta(const PathfindingContext& context, const EdgeCostCache* edge_costs) {
+            const Grid_V3& grid = *context.grid;
+            const int width = static_cast<int>(grid.width());
+            const int height = static_cast<int>(grid.height());
+            const long long cell_count = static_cast<long long>(width) * height;
+            const long long stride = std::max(1LL, cell_count / 4096);
+            double sum = 0.0;
+            long long samples = 0;
+            for (long long i = 0; i < cell_count; i += stride) {
+                const int x = static_cast<int>(i % width);
+                const int y = static_cast<int>(i / width);
+                if (!isPassable(grid, x, y)) { continue; }
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    if (!grid.inBounds(x + dx[dir], y + dy[dir])) { continue; }
+                    const float cost = stepCost(context, edge_costs, x, y, dir);
+                    if (cost < std::numeric_limits<float>::max()) { sum += cost; ++samples; }
+                }
+            }
+            return samples > 0 ? static_cast<float>(4.0 * sum / static_cast<double>(samples)) : 1.0f;
+        }
+
+    } // end anonymous namespace
+
+    TravelTimeField TravelTimeField::compute(const PathfindingContext& context, const GridPoint& target, float delta) {
+        TravelTimeField result;
+        const EdgeCostCache* edge_costs = context.hasEdgeCosts() ? context.edge_costs : nullptr;
+        if (!context.isValid() || (edge_costs == nullptr && !context.hasElevation())) { return result; }
+        const Grid_V3& grid = *context.grid;
+        if (!grid.inBounds(target.x, target.y) || !isPassable(grid, target.x, target.y)) { return result; }
+        const int width = static_cast<int>(grid.width());
+        const int cell_count = width * static_cast<int>(grid.height());
+        const int targetIdx = toIndex(target.x, target.y, width);
+        if (!(delta > 0.0f)) { delta = autoDelta(context, edge_costs); }
+
+        try {
+            result.times_.resize(static_cast<std::size_t>(cell_count));
+        }
+        catch (const std::bad_alloc&) {
+            return result;
+        }
+
+        // Backward search over the reversed edges; every edge is light, and nothing stops it early
+        delta_stepping::Labels<false> labels;
+        if (!delta_stepping::run<delta_stepping::EdgeDirection::Incoming>(context, targetIdx, delta,
+                std::numeric_limits<float>::max(), -1, delta_stepping::NoPruning{}, labels)) {
+            return TravelTimeField();
+        }
+
+#pragma omp parallel for schedule(static)
+        for (int i = 0; i < cell_count; ++i) {
+            result.times_[static_cast<std::size_t>(i)] = labels.distance(i);
+        }
+        result.width_ = grid.width();
+        result.height_ = grid.height();
+        result.target_idx_ = targetIdx;
+        result.delta_ = labels.delta();
+        return result;
+    }
+
+} // namespace Pathfinding
@@ -1,6 +1,7 @@
 ﻿// src/gui/main_window.cpp
 #include "main_window.hpp"
 #include "logic/PathfindingLogic.hpp" 
+#include "logic/ReplanningSession.hpp"
 
 // --- Qt Headers ---
 #include <QAction>
@@ -35,12 +36,17 @@
 #include <QWidget>
 #include <QDebug>
 #include <QCheckBox> // Added
+#include <QPainter>
+#include <QPen>
+#include <QPointer>
+#include <QPolygonF>
 #include <QtConcurrent/QtConcurrent> // Added for async run
 #include <QFutureWatcher> // Added for async run
 
 // --- Standard Headers ---
 #include <thread>
 #include <vector>
+#include <map>
 #include <memory>
 #include <algorithm>
 #include <exception>
@@ -252,6 +258,108 @@ namespace app {
         }
     )";
 
+    // =========================================================================
+    // Path Overlay (map area: provisional ARA* legs while searching, then the final path)
+    // =========================================================================
+    namespace {
+
+        class PathOverlayWidget : public QFrame {
+        public:
+            explicit PathOverlayWidget(QWidget* parent = nullptr) : QFrame(parent) {
+                setFrameStyle(QFrame::Panel | QFrame::Sunken);
+                setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
+                setMinimumSize(400, 300);
+            }
+
+            // Drops the previous path; provisional legs are accepted until showFinalPath()/clear()
+            void beginRun(int gridWidth, int gridHeight) {
+                clear();
+                m_gridWidth = gridWidth;
+                m_gridHeight = gridHeight;
+                m_acceptProvisional = true;
+            }
+
+            // Replaces the leg's provisional route if it is cheaper (legs arrive from concurrent searches)
+            void showProvisionalLeg(const AnytimeLegSolution& solution) {
+                if (!m_acceptProvisional) { return; } // Late update of a finished run
+                ProvisionalLeg& leg = m_provisionalLegs[solution.legIndex];
+                if (!leg.pathIndices.empty() && leg.cost <= solution.cost) { return; }
+                leg.pathIndices = solution.pathIndices;
+                leg.cost = solution.cost;
+                leg.suboptimalityBound = solution.suboptimalityBound;
+                update();
+            }
+
+            void showFinalPath(const std::vector<int>& pathIndices, int gridWidth, int gridHeight) {
+                clear();
+                m_gridWidth = gridWidth;
+                m_gridHeight = gridHeight;
+                m_finalPath = pathIndices;
+                update();
+            }
+
+            void clear() {
+                m_acceptProvisional = false;
+                m_provisionalLegs.clear();
+                m_finalPath.clear();
+                update();
+            }
+
+        protected:
+            void paintEvent(QPaintEvent* event) override {
+                QFrame::paintEvent(event);
+                QPainter painter(this);
+                const QRectF area = QRectF(contentsRect()).adjusted(8, 8, -8, -8);
+                if ((m_finalPath.empty() && m_provisionalLegs.empty()) || m_gridWidth <= 0 || m_gridHeight <= 0) {
+                    painter.drawText(contentsRect(), Qt::AlignCenter, "Map Area (Visualization Placeholder)");
+                    return;
+                }
+
+                // Grid cells to widget pixels, aspect ratio kept, row 0 at the top
+                const double scale = std::min(area.width() / m_gridWidth, area.height() / m_gridHeight);
+                const QPointF origin(area.center().x() - 0.5 * scale * m_gridWidth, area.center().y() - 0.5 * scale * m_gridHeight);
+                auto toPolygon = [&](const std::vector<int>& pathIndices) {
+                    QPolygonF polygon;
+                    polygon.reserve(static_cast<int>(pathIndices.size()));
+                    for (int idx : pathIndices) {
+                        polygon << origin + QPointF((idx % m_gridWidth + 0.5) * scale, (idx / m_gridWidth + 0.5) * scale);
+                    }
+                    return polygon;
+                };
+                painter.setRenderHint(QPainter::Antialiasing);
+                painter.drawRect(QRectF(origin, QSizeF(scale * m_gridWidth, scale * m_gridHeight)));
+
+                if (!m_finalPath.empty()) {
+                    painter.setPen(QPen(QColor(200, 0, 120), 2.0));
+                    painter.drawPolyline(toPolygon(m_finalPath));
+                    return;
+                }
+                float worstBound = 1.0f;
+                painter.setPen(QPen(QColor(230, 120, 0), 1.5, Qt::DashLine));
+                for (const auto& entry : m_provisionalLegs) {
+                    painter.drawPolyline(toPolygon(entry.second.pathIndices));
+                    worstBound = std::max(worstBound, entry.second.suboptimalityBound);
+                }
+                painter.drawText(area, Qt::AlignTop | Qt::AlignLeft,
+                    QString("Provisional route: %1 leg(s), <= %2 x optimal").arg(m_provisionalLegs.size()).arg(worstBound, 0, 'f', 3));
+            }
+
+        private:
+            struct ProvisionalLeg {
+                std::vector<int> pathIndices;
+                float cost = 0.0f;
+                float suboptimalityBound = 1.0f;
+            };
+
+            int m_gridWidth = 0;
+            int m_gridHeight = 0;
+            bool m_acceptProvisional = false;
+            std::map<size_t, ProvisionalLeg> m_provisionalLegs; // Latest route per leg index
+            std::vector<int> m_finalPath;
+        };
+
+    } // end anonymous namespace
+
     // =========================================================================
     // Implementation Struct
     // =========================================================================
@@ -268,6 +376,7 @@ namespace app {
         QDockWidget* settingsDockWidget{ nullptr };
         QStackedWidget* settingsStack{ nullptr };
         QCheckBox* autoExportCheckBox{ nullptr };
+        PathOverlayWidget* pathOverlay{ nullptr }; // Map area
         PathfindingLogic pathfindingLogic;
 
         // Actions
@@ -293,6 +402,8 @@ namespace app {
         // Settings Widgets - Solver Panel
         QComboBox* algorithmComboBox{ nullptr };
         QComboBox* heuristicComboBox{ nullptr };
+        QSpinBox* hpaClusterSizeSpinBox{ nullptr };
+        QSpinBox* araTimeBudgetSpinBox{ nullptr };
 
         // State & Data
         QSettings* settings{ nullptr };
@@ -311,6 +422,7 @@ namespace app {
         float lastOriginOffsetX = 0.0f;
         float lastOriginOffsetY = 0.0f;
         std::vector<int> lastCalculatedPathIndices; // Store the resulting path
+        std::shared_ptr<app::ReplanningSession> lastReplanningSession; // LPA* search state, reused while map/controls/grid size stay the same
 
         // --- Stored Settings for Reuse Check ---
         mapgeo::ObstacleConfigMap lastUsedObstacleCosts; // Store for potential future reuse logic
@@ -364,13 +476,9 @@ namespace app {
         mainButtonsLayout->addStretch();
         centralLayout->addLayout(mainButtonsLayout);
 
-        // --- Map Placeholder ---
-        QLabel* mapPlaceholder = new QLabel("Map Area (Visualization Placeholder)");
-        mapPlaceholder->setAlignment(Qt::AlignCenter);
-        mapPlaceholder->setFrameStyle(QFrame::Panel | QFrame::Sunken);
-        mapPlaceholder->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-        mapPlaceholder->setMinimumSize(400, 300);
-        centralLayout->addWidget(mapPlaceholder);
+        // --- Map Area (path overlay) ---
+        m_impl->pathOverlay = new PathOverlayWidget(m_impl->centralWidget);
+        centralLayout->addWidget(m_impl->pathOverlay);
 
         setCentralWidget(m_impl->centralWidget);
 
@@ -576,7 +684,7 @@ namespace app {
 
         // --- GPU Parameters Group (Initially Hidden) ---
         m_impl->gpuParamsGroup = new QGroupBox("GPU Parameters");
-        m_impl->gpuParamsGroup->setToolTip("Settings specific to GPU-based algorithms (Delta-Stepping, HADS, A*).");
+        m_impl->gpuParamsGroup->setToolTip("Settings specific to GPU-based algorithms (Delta-Stepping, HADS, A*) and the CPU Delta-Stepping/HADS ports.");
         auto* gpuFormLayout = new QFormLayout(m_impl->gpuParamsGroup);
 
         m_impl->gpuDeltaSpinBox = new QDoubleSpinBox();
@@ -623,6 +731,14 @@ namespace app {
         m_impl->algorithmComboBox->addItem("BFS", QVariant(QString("BFS")));
         m_impl->algorithmComboBox->addItem("Theta*", QVariant(QString("Theta*")));
         m_impl->algorithmComboBox->addItem("Lazy Theta*", QVariant(QString("Lazy Theta*"))); // Ensure backend uses this exact name string
+        m_impl->algorithmComboBox->addItem("Bidirectional Dijkstra", QVariant(QString("Bidirectional Dijkstra")));
+        m_impl->algorithmComboBox->addItem("Bidirectional A*", QVariant(QString("Bidirectional A*")));
+        m_impl->algorithmComboBox->addItem("HPA*", QVariant(QString("HPA*")));
+        m_impl->algorithmComboBox->addItem("Contraction Hierarchy", QVariant(QString("Contraction Hierarchy")));
+        m_impl->algorithmComboBox->addItem("ARA*", QVariant(QString("ARA*")));
+        m_impl->algorithmComboBox->addItem("LPA* (Incremental)", QVariant(QString("LPA* (Incremental)")));
+        m_impl->algorithmComboBox->addItem("Delta Stepping - CPU", QVariant(QString("Delta Stepping - CPU")));
+        m_impl->algorithmComboBox->addItem("HADS - CPU", QVariant(QString("HADS - CPU")));
         m_impl->algorithmComboBox->addItem("Delta Stepping - GPU", QVariant(QString("Delta Stepping - GPU")));
         m_impl->algorithmComboBox->addItem("HADS - GPU", QVariant(QString("HADS - GPU")));
         m_impl->algorithmComboBox->addItem("A* - GPU", QVariant(QString("A* - GPU")));
@@ -635,10 +751,24 @@ namespace app {
         m_impl->heuristicComboBox->addItem("Diagonal", QVariant(PathfindingUtils::HEURISTIC_DIAGONAL));
         m_impl->heuristicComboBox->addItem("Manhattan", QVariant(PathfindingUtils::HEURISTIC_MANHATTAN));
         m_impl->heuristicComboBox->addItem("Min Cost", QVariant(PathfindingUtils::HEURISTIC_MIN_COST));
+        m_impl->heuristicComboBox->addItem("ALT (Landmarks, A* only)", QVariant(PathfindingUtils::HEURISTIC_ALT));
         m_impl->heuristicComboBox->setToolTip("Select the heuristic function for A* and related algorithms.");
         m_impl->heuristicComboBox->setEnabled(false); // Disabled by default
         formLayout->addRow("Heuristic (A*/Theta*):", m_impl->heuristicComboBox);
 
+        m_impl->hpaClusterSizeSpinBox = new QSpinBox();
+        m_impl->hpaClusterSizeSpinBox->setRange(4, 256);
+        m_impl->hpaClusterSizeSpinBox->setToolTip("HPA* cluster size in cells. Smaller builds the abstraction faster; larger gives slightly better paths but slower queries.");
+        m_impl->hpaClusterSizeSpinBox->setEnabled(false); // Enabled for HPA* only
+        formLayout->addRow("HPA* Cluster Size:", m_impl->hpaClusterSizeSpinBox);
+
+        m_impl->araTimeBudgetSpinBox = new QSpinBox();
+        m_impl->araTimeBudgetSpinBox->setRange(0, 600000); m_impl->araTimeBudgetSpinBox->setSingleStep(100);
+        m_impl->araTimeBudgetSpinBox->setSuffix(" ms");
+        m_impl->araTimeBudgetSpinBox->setToolTip("ARA* refinement budget per leg. The first route is always found; 0 refines until optimal.");
+        m_impl->araTimeBudgetSpinBox->setEnabled(false); // Enabled for ARA* only
+        formLayout->addRow("ARA* Time Budget:", m_impl->araTimeBudgetSpinBox);
+
 
         panelLayout->addWidget(algoGroup);
         panelLayout->addStretch();
@@ -691,6 +821,29 @@ namespace app {
         else {
             params.heuristicType = -1; // Indicate not applicable
         }
+        params.hpaClusterSize = m_impl->hpaClusterSizeSpinBox->value();
+        params.araTimeBudgetMs = m_impl->araTimeBudgetSpinBox->value();
+        if (params.algorithmName == "ARA*") {
+            // Draw each route as it improves (called on worker threads while the search runs, so hop to the GUI thread)
+            QPointer<QStatusBar> statusBar = m_impl->statusBar;
+            QPointer<PathOverlayWidget> pathOverlay = m_impl->pathOverlay;
+            params.onAnytimeSolution = [statusBar, pathOverlay](const AnytimeLegSolution& solution) {
+                const QString message = QString("ARA* leg %1: route after %L2 ms, cost %L3 (<= %4 x optimal)")
+                    .arg(solution.legIndex + 1)
+                    .arg(solution.elapsedMs, 0, 'f', 1)
+                    .arg(solution.cost, 0, 'f', 1)
+                    .arg(solution.suboptimalityBound, 0, 'f', 3);
+                if (!statusBar || !pathOverlay) { return; }
+                QMetaObject::invokeMethod(pathOverlay, [statusBar, pathOverlay, message, solution]() {
+                    if (pathOverlay) { pathOverlay->showProvisionalLeg(solution); }
+                    if (statusBar) { statusBar->showMessage(message, 5000); }
+                }, Qt::QueuedConnection);
+            };
+        }
+
+        if (params.algorithmName == "LPA* (Incremental)") {
+            params.replanningSession = m_impl->lastReplanningSession; // Only the changed costs are repaired if the course is the same
+        }
 
         // Get GPU Params (if applicable)
         if (m_impl->gpuParamsGroup->isVisible()) {
@@ -736,6 +889,7 @@ namespace app {
         }
 
         // 4. Start Asynchronous Calculation
+        m_impl->pathOverlay->beginRun(params.desiredGridWidth, params.desiredGridHeight);
         runBackendProcessingAsync(params);
     }
 
@@ -759,11 +913,13 @@ namespace app {
         m_impl->lastOriginOffsetX = result.finalOriginOffsetX;
         m_impl->lastOriginOffsetY = result.finalOriginOffsetY;
         m_impl->lastCalculatedPathIndices = std::move(result.fullPathIndices);
+        m_impl->lastReplanningSession = std::move(result.replanningSession);
 
 
         // --- Process Outcome ---
         if (result.success) {
             m_impl->exportButton->setEnabled(!m_impl->lastCalculatedPathIndices.empty());
+            m_impl->pathOverlay->showFinalPath(m_impl->lastCalculatedPathIndices, result.usedGridWidth, result.usedGridHeight);
 
             // Format result message
             QString statusMsg = QString("Path Found (%1 waypoints). Length: %2 nodes.")
@@ -776,6 +932,14 @@ namespace app {
             if (result.usedDummyElevation) {
                 statusMsg += " (Used dummy elevation data)";
             }
+            if (result.usedFlatTerrain) {
+                statusMsg += " (2D mode: flat terrain)";
+            }
+            if (m_impl->lastReplanningSession) {
+                timingMsg += QString(" | LPA*: %L1 cells changed, %L2 expanded")
+                    .arg(result.replanChangedCells)
+                    .arg(result.replanExpandedCells);
+            }
             m_impl->statusBar->showMessage(statusMsg + " | " + timingMsg, 15000);
 
             qDebug() << "MainWindow: Calculation successful. Path length:" << m_impl->lastCalculatedPathIndices.size();
@@ -803,6 +967,7 @@ namespace app {
             // Failure
             // m_impl->lastCalculatedPathIndices is already empty due to move or clear on failure
             m_impl->exportButton->setEnabled(false);
+            m_impl->pathOverlay->clear();
             QString error = QString::fromStdString(result.errorMessage);
             if (error.isEmpty()) error = "An unknown error occurred during processing.";
             QMessageBox::critical(this, "Calculation Error", error);
@@ -845,13 +1010,20 @@ namespace app {
         QString algoName = m_impl->algorithmComboBox->currentText(); // More robust than currentData maybe
 
         // Algorithms that use heuristics
-        bool usesHeuristic = algoName.contains("A*", Qt::CaseInsensitive) ||
-            algoName.contains("Theta*", Qt::CaseInsensitive);
+        // (Bidirectional A* and HPA* use their own consistent heuristic, so the selector does not apply)
+        bool usesHeuristic = (algoName.contains("A*", Qt::CaseInsensitive) ||
+            algoName.contains("Theta*", Qt::CaseInsensitive)) && !algoName.contains("Bidirectional", Qt::CaseInsensitive) &&
+            algoName != "HPA*" && algoName != "ARA*" && algoName != "LPA* (Incremental)";
+        bool usesHierarchy = (algoName == "HPA*");
+        bool usesAnytime = (algoName == "ARA*");
 
-        // Algorithms that are GPU based (for GPU params)
-        bool usesGpuParams = algoName.contains("GPU", Qt::CaseInsensitive);
+        // Algorithms that are GPU based, or CPU ports of the GPU kernels (for GPU params)
+        bool usesGpuParams = algoName.contains("GPU", Qt::CaseInsensitive) ||
+            algoName == "Delta Stepping - CPU" || algoName == "HADS - CPU";
 
         m_impl->heuristicComboBox->setEnabled(usesHeuristic);
+        m_impl->hpaClusterSizeSpinBox->setEnabled(usesHierarchy);
+        m_impl->araTimeBudgetSpinBox->setEnabled(usesAnytime);
         m_impl->gpuParamsGroup->setVisible(usesGpuParams);
 
         qDebug() << "Algorithm changed to:" << algoName << "Uses heuristic:" << usesHeuristic << "Uses GPU params:" << usesGpuParams;
@@ -1048,6 +1220,8 @@ namespace app {
         int savedHeuristic = m_impl->settings->value("heuristic", defaultHeuristic).toInt();
         int heuristicIndex = m_impl->heuristicComboBox->findData(QVariant(savedHeuristic));
         m_impl->heuristicComboBox->setCurrentIndex((heuristicIndex != -1) ? heuristicIndex : 3); // Default to Min Cost index
+        if (m_impl->hpaClusterSizeSpinBox) m_impl->hpaClusterSizeSpinBox->setValue(m_impl->settings->value("hpaClusterSize", 16).toInt());
+        if (m_impl->araTimeBudgetSpinBox) m_impl->araTimeBudgetSpinBox->setValue(m_impl->settings->value("araTimeBudgetMs", 1000).toInt());
 
         // GPU Defaults (from backend main example)
         if (m_impl->gpuDeltaSpinBox) m_impl->gpuDeltaSpinBox->setValue(m_impl->settings->value("gpuDelta", 50.0).toDouble());
@@ -1092,6 +1266,8 @@ namespace app {
         m_impl->settings->beginGroup("Solver");
         if (m_impl->algorithmComboBox) m_impl->settings->setValue("algorithm", m_impl->algorithmComboBox->currentText()); // Save name
         if (m_impl->heuristicComboBox) m_impl->settings->setValue("heuristic", m_impl->heuristicComboBox->currentData().toInt()); // Save int constant
+        if (m_impl->hpaClusterSizeSpinBox) m_impl->settings->setValue("hpaClusterSize", m_impl->hpaClusterSizeSpinBox->value());
+        if (m_impl->araTimeBudgetSpinBox) m_impl->settings->setValue("araTimeBudgetMs", m_impl->araTimeBudgetSpinBox->value());
 
         if (m_impl->gpuDeltaSpinBox) m_impl->settings->setValue("gpuDelta", m_impl->gpuDeltaSpinBox->value());
         if (m_impl->gpuThresholdSpinBox) m_impl->settings->setValue("gpuThreshold", m_impl->gpuThresholdSpinBox->value());
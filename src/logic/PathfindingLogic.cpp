@@ -1,4 +1,5 @@
 #include "logic/PathfindingLogic.hpp"
+#include "logic/ReplanningSession.hpp"
 
 // --- Standard Library Includes ---
 #include <stdexcept>
@@ -7,6 +8,8 @@
 #include <fstream>  // If doing file copy manually
 #include <cmath>
 #include <iterator> // For std::make_move_iterator
+#include <algorithm> // For std::min/std::max
+#include <sstream>   // For the LPA* session source key
 
 // --- Qt Includes ---
 #include <QDebug>   // For logging
@@ -18,6 +21,12 @@
 #include "map/WaypointExtractor.hpp"
 #include "map/ElevationFetcherPy.hpp" // Includes Python interaction
 #include "map/PathfindingUtils.hpp"   // Includes GridPoint definition, constants
+#include "IO/GridCache.hpp"           // Persistent grid cache
+#include "IO/RasterExport.hpp"        // Travel-time field export
+#include "map/ElevationSampler.hpp"
+#include "map/ElevationRaster.hpp"      // Elevation resampled once per grid
+#include "map/CompactGrid.hpp"          // Palette-coded grid for the A*/Dijkstra kernels
+#include "map/TiledGrid.hpp"            // Its tile-ordered copy
 // #include "debug/DebugUtils.hpp"    // Optional for backend debugging
 
 // --- Algorithm Includes ---
@@ -26,6 +35,19 @@
 #include "algoritms/BFSToblerSampled.hpp"
 #include "algoritms/ThetaStarToblerSampled.hpp"
 #include "algoritms/LazyThetaStarToblerSampled.hpp"
+#include "algoritms/BidirectionalToblerSampled.hpp"
+#include "algoritms/HPAStarToblerSampled.hpp"
+#include "algoritms/HierarchicalGraph.hpp"
+#include "algoritms/LandmarkHeuristic.hpp"
+#include "algoritms/CHToblerSampled.hpp"
+#include "algoritms/ContractionHierarchy.hpp"
+#include "algoritms/LegCostMatrix.hpp"
+#include "algoritms/TravelTimeField.hpp"
+#include "algoritms/DeltaSteppingCPU.hpp"
+#include "algoritms/ARAStarToblerSampled.hpp"
+#include "algoritms/PathfindingContext.hpp"
+#include "algoritms/SearchWorkspace.hpp"
+#include "algoritms/EdgeCostCache.hpp"
 
 #ifdef USE_CUDA
 //#include "algoritms/DeltaSteppingGPU.hpp"
@@ -72,6 +94,174 @@ using namespace waypoint;
 
 namespace app {
 
+    namespace {
+
+        /**
+         * @brief Runs the selected CPU algorithm for one leg.
+         * Only reads the shared context; all mutable search state lives in the given workspaces,
+         * so legs can be solved concurrently as long as each thread passes its own workspaces.
+         * @throws std::runtime_error if the algorithm name is not supported by this build.
+         */
+        std::vector<int> solveSegment(
+            const BackendInputParams& params,
+            const PathfindingContext& context,
+            SearchWorkspace& forwardWorkspace,
+            SearchWorkspace& backwardWorkspace, // Only used by the bidirectional searches
+            const GridPoint& start,
+            const GridPoint& end,
+            size_t legIndex,
+            std::vector<AnytimeLegSolution>& anytimeSolutions) // Only filled by ARA*
+        {
+            bool isGpuAlgorithm = params.algorithmName.find("GPU") != std::string::npos;
+
+#ifdef USE_CUDA
+            //// --- GPU Algorithm Calls ---
+            //if (params.algorithmName == "Delta Stepping - GPU") {
+            //    return findPathGPU_DeltaStepping(
+            //        grid, elevation_values_final, elevation_width_final, elevation_height_final,
+            //        log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
+            //        start, end, params.gpuDelta, params.gpuThreshold);
+            //}
+            //else if (params.algorithmName == "HADS - GPU") {
+            //    return findPathGPU_HADS(
+            //        grid, elevation_values_final, elevation_width_final, elevation_height_final,
+            //        log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
+            //        start, end,
+            //        params.gpuDelta, params.gpuThreshold, params.hadsRadius, params.hadsPruneFactor, params.hadsHeuristicWeight);
+            //}
+            //else if (params.algorithmName == "A* - GPU") {
+            //    return findPathGPU_AStar(
+            //        grid, elevation_values_final, elevation_width_final, elevation_height_final,
+            //        log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
+            //        start, end, params.heuristicType);
+            //}
+            //else
+#endif // USE_CUDA
+                // --- CPU Algorithm Calls ---
+                if (params.algorithmName == "Optimized A*") {
+                    return findAStarPath_Tobler_Sampled(
+                        context, forwardWorkspace, start, end, params.heuristicType);
+                }
+                else if (params.algorithmName == "Dijkstra") {
+                    return findDijkstraPath_Tobler_Sampled(
+                        context, forwardWorkspace, start, end);
+                }
+                else if (params.algorithmName == "BFS") {
+                    return findBFSPath_Tobler_Sampled(
+                        context, forwardWorkspace, start, end);
+                }
+                else if (params.algorithmName == "Theta*") {
+                    return findThetaStarPath_Tobler_Sampled(
+                        context, forwardWorkspace, start, end, params.heuristicType);
+                }
+                else if (params.algorithmName == "Lazy Theta*") {
+                    return findLazyThetaStarPath_Tobler_Sampled(
+                        context, forwardWorkspace, start, end, params.heuristicType);
+                }
+                else if (params.algorithmName == "Bidirectional Dijkstra" || params.algorithmName == "Bidirectional A*") {
+                    return findBidirectionalPath_Tobler_Sampled(
+                        context, forwardWorkspace, backwardWorkspace, start, end,
+                        params.algorithmName == "Bidirectional A*");
+                }
+                else if (params.algorithmName == "HPA*") {
+                    return findHPAStarPath_Tobler_Sampled(
+                        context, forwardWorkspace, start, end);
+                }
+                else if (params.algorithmName == "Contraction Hierarchy") {
+                    return findCHPath_Tobler_Sampled(
+                        context, forwardWorkspace, backwardWorkspace, start, end);
+                }
+                else if (params.algorithmName == "ARA*") {
+                    AnytimeSettings anytimeSettings;
+                    anytimeSettings.initial_epsilon = params.araInitialEpsilon;
+                    anytimeSettings.epsilon_step = params.araEpsilonStep;
+                    anytimeSettings.time_budget_ms = params.araTimeBudgetMs;
+                    const std::vector<AnytimeSolution> solutions = findARAStarPath_Tobler_Sampled(
+                        context, forwardWorkspace, start, end, anytimeSettings,
+                        [&](const AnytimeSolution& solution) {
+                            AnytimeLegSolution published;
+                            published.legIndex = legIndex;
+                            published.epsilon = solution.epsilon;
+                            published.suboptimalityBound = solution.suboptimality_bound;
+                            published.cost = solution.cost;
+                            published.elapsedMs = solution.elapsed_ms;
+                            published.pathIndices = solution.path;
+                            if (params.onAnytimeSolution) { params.onAnytimeSolution(published); }
+                            anytimeSolutions.push_back(std::move(published));
+                        });
+                    return solutions.empty() ? std::vector<int>() : solutions.back().path;
+                }
+                else if (params.algorithmName == "Delta Stepping - CPU") {
+                    return findDeltaSteppingPath_Tobler_Sampled(
+                        context, start, end, params.gpuDelta, params.gpuThreshold);
+                }
+                else if (params.algorithmName == "HADS - CPU") {
+                    return findHADSPath_Tobler_Sampled(
+                        context, start, end,
+                        params.gpuDelta, params.gpuThreshold, params.hadsRadius, params.hadsPruneFactor, params.hadsHeuristicWeight);
+                }
+            // --- Error Handling for Unknown Algorithm ---
+                else {
+                    // This logic handles the case where the name is unrecognized,
+                    // considering whether CUDA is enabled or not.
+                    std::string errorMsg;
+#ifdef USE_CUDA
+                    if (isGpuAlgorithm) { // Name contained GPU but didn't match known GPU types
+                        errorMsg = "Selected GPU algorithm '" + params.algorithmName + "' is not implemented.";
+                    }
+                    else { // Name did not contain GPU and didn't match known CPU types
+                        errorMsg = "Unsupported CPU algorithm selected: " + params.algorithmName;
+                    }
+#else // USE_CUDA not defined
+                    if (isGpuAlgorithm) { // Name contained GPU, but CUDA is off
+                        errorMsg = "GPU algorithm '" + params.algorithmName + "' selected, but CUDA is disabled in this build.";
+                    }
+                    else { // Name did not contain GPU and didn't match known CPU types
+                        errorMsg = "Unsupported CPU algorithm selected: " + params.algorithmName;
+                    }
+#endif // USE_CUDA
+                    throw std::runtime_error(errorMsg); // Throw exception for unsupported algorithm
+                }
+        }
+
+        MapProcessorConfig makeProcessorConfig(const BackendInputParams& params) {
+            MapProcessorConfig procConfig;
+            procConfig.grid_width = params.desiredGridWidth;
+            procConfig.grid_height = params.desiredGridHeight;
+            procConfig.layers_to_process = { "barrier", "course" }; // Layers for actual features
+            procConfig.use_tile_binned_merge = params.useTileBinnedMerge;
+            procConfig.merge_tile_size = params.mergeTileSize;
+            return procConfig;
+        }
+
+        // Size limit handed to the grid-cache save functions (they prune the directory to it)
+        std::uint64_t cacheBudgetBytes(const BackendInputParams& params) {
+            return static_cast<std::uint64_t>(std::max(0.0, params.gridCacheBudgetMB) * 1024.0 * 1024.0);
+        }
+
+        // Source key of an LPA* session: map and controls contents, processor config and the elevation
+        // settings the session's raster was built with (obstacle costs are applied incrementally instead)
+        std::optional<std::uint64_t> lpaSessionSourceKey(const BackendInputParams& params) {
+            std::ostringstream settings;
+            settings << params.desiredElevationResolution << '|' << params.pyModuleName << '|' << params.pyFetchFuncName << '|'
+                << params.pyConvertFuncName << '|' << params.flatTerrainMode;
+            return gridcache::computeSourceKey(params.mapFilePath, params.controlsFilePath, makeProcessorConfig(params), settings.str());
+        }
+
+        // Copies an LPA* replan into the result, with the session's current grid
+        void applyReplanResult(BackendResult& result, ReplanResult replanned, const std::shared_ptr<ReplanningSession>& session) {
+            result.processedGrid = session->grid();
+            result.pathfindingDurationMs = replanned.durationMs;
+            result.replanChangedCells = replanned.changedCells;
+            result.replanExpandedCells = replanned.expandedCells;
+            result.replanningSession = session;
+            result.success = replanned.success;
+            result.errorMessage = std::move(replanned.errorMessage);
+            result.fullPathIndices = std::move(replanned.fullPathIndices);
+        }
+
+    } // end anonymous namespace
+
     PathfindingLogic::PathfindingLogic() = default;
     PathfindingLogic::~PathfindingLogic() = default;
 
@@ -100,6 +290,27 @@ namespace app {
 
             auto start_full_proc = std::chrono::high_resolution_clock::now();
 
+            // Incremental replanning: a previous LPA* session of the same course only repairs what the new costs changed.
+            // Edited map or controls files, or changed settings, give a different source key and a fresh session.
+            std::optional<std::uint64_t> lpaSourceKey;
+            if (params.algorithmName == "LPA* (Incremental)") {
+                lpaSourceKey = lpaSessionSourceKey(params);
+            }
+            if (params.algorithmName == "LPA* (Incremental)" && params.replanningSession && lpaSourceKey &&
+                params.replanningSession->matches(params.mapFilePath, params.controlsFilePath, params.desiredGridWidth, params.desiredGridHeight, *lpaSourceKey))
+            {
+                std::shared_ptr<ReplanningSession> session = params.replanningSession;
+                result = session->runInfo();
+                auto start_map_proc = std::chrono::high_resolution_clock::now();
+                const size_t changed = session->updateObstacleCosts(params.obstacleCosts);
+                result.mapProcessingDurationMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start_map_proc).count();
+                result.elevationFetchDurationMs = 0.0;
+                qDebug() << "PathfindingLogic: Reusing LPA* session;" << changed << "cells changed cost (grid regenerated in"
+                    << result.mapProcessingDurationMs << "ms).";
+                applyReplanResult(result, session->replan(), session);
+                return result;
+            }
+
             //--------------------------------------------
             // 1. Map Scan & Processing
             //--------------------------------------------
@@ -110,7 +321,7 @@ namespace app {
             std::vector<std::string> layers_for_scan = { "barrier", "course" };
             mapscan::ScanResult scanResult = mapscan::scanXmlForGeoRefAndBounds(params.mapFilePath, layers_for_scan);
             bool canFetchElevation = false;
-            bool useRealElevation = true; // Assume dummy unless successfully fetched
+            bool useRealElevation = false; // Assume dummy unless successfully fetched
             double mapScaleFromXml = 10000.0; // Default scale
             if (scanResult.georeferencingFound && scanResult.refLatLon &&
                 scanResult.rawBoundsUM && scanResult.rawBoundsUM->initialized && scanResult.mapScale)
@@ -133,20 +344,41 @@ namespace app {
                 normInfo_opt = params.existingNormInfo; // Copy from input
             }
             else {
-                qDebug() << "PathfindingLogic: Processing map and generating grid...";
-                MapProcessorConfig procConfig;
-                procConfig.grid_width = params.desiredGridWidth;
-                procConfig.grid_height = params.desiredGridHeight;
-                procConfig.layers_to_process = { "barrier", "course" }; // Layers for actual features
-                MapProcessor processor(procConfig);
-                if (!processor.loadMap(params.mapFilePath)) {
-                    throw std::runtime_error("Map load failed: " + params.mapFilePath);
-                }
-                logical_grid_opt = processor.generateGrid(params.obstacleCosts);
-                if (!logical_grid_opt) { throw std::runtime_error("Grid generation failed"); }
-                normInfo_opt = processor.getNormalizationResult();
-                if (!normInfo_opt || !normInfo_opt->valid) { throw std::runtime_error("Normalization results invalid after grid generation."); }
-                qDebug() << "PathfindingLogic: New grid generated.";
+                MapProcessorConfig procConfig = makeProcessorConfig(params);
+
+                // Try the persistent grid cache first (keyed by map contents + processing config)
+                const std::string cacheDir = params.gridCacheDirectory.empty() ? gridcache::defaultCacheDirectory() : params.gridCacheDirectory;
+                std::optional<std::uint64_t> cacheKey;
+                if (params.useGridCache) {
+                    cacheKey = gridcache::computeGridCacheKey(params.mapFilePath, procConfig.grid_width, procConfig.grid_height,
+                        procConfig.layers_to_process, params.obstacleCosts, procConfig.use_tile_binned_merge);
+                    if (cacheKey) {
+                        if (auto cached = gridcache::loadGridCache(cacheDir, *cacheKey)) {
+                            if (cached->normInfo.valid) {
+                                qDebug() << "PathfindingLogic: Loaded grid from cache" << QString::fromStdString(gridcache::cacheFilePath(cacheDir, *cacheKey));
+                                logical_grid_opt = std::move(cached->grid);
+                                normInfo_opt = cached->normInfo;
+                            }
+                        }
+                    }
+                }
+
+                if (!logical_grid_opt) {
+                    qDebug() << "PathfindingLogic: Processing map and generating grid...";
+                    MapProcessor processor(procConfig);
+                    if (!processor.loadMap(params.mapFilePath)) {
+                        throw std::runtime_error("Map load failed: " + params.mapFilePath);
+                    }
+                    logical_grid_opt = processor.generateGrid(params.obstacleCosts);
+                    if (!logical_grid_opt) { throw std::runtime_error("Grid generation failed"); }
+                    normInfo_opt = processor.getNormalizationResult();
+                    if (!normInfo_opt || !normInfo_opt->valid) { throw std::runtime_error("Normalization results invalid after grid generation."); }
+                    qDebug() << "PathfindingLogic: New grid generated.";
+
+                    if (cacheKey && !gridcache::saveGridCache(cacheDir, *cacheKey, *logical_grid_opt, *normInfo_opt, cacheBudgetBytes(params))) {
+                        qWarning() << "PathfindingLogic: Failed to write grid cache (continuing without it).";
+                    }
+                }
             }
             auto end_map_proc = std::chrono::high_resolution_clock::now();
             result.mapProcessingDurationMs = std::chrono::duration<double, std::milli>(end_map_proc - start_map_proc).count();
@@ -192,7 +424,10 @@ namespace app {
             ElevationData elevationResult;
             
 
-            if (canFetchElevation) { // Only attempt if scan was successful
+            if (canFetchElevation && params.flatTerrainMode == 1) {
+                qDebug() << "PathfindingLogic: Skipping Python elevation fetch (2D mode requested).";
+            }
+            else if (canFetchElevation) { // Only attempt if scan was successful
                 qDebug() << "PathfindingLogic: Attempting Python elevation fetch...";
                 const auto& rawBounds = scanResult.rawBoundsUM.value(); // Safe now
                 const auto& anchorLatLon = scanResult.refLatLon.value(); // Safe now
@@ -294,6 +529,32 @@ namespace app {
                 origin_offset_y = 0.0f;
             }
             float elevation_resolution_final = static_cast<float>(elevation_resolution_final_dbl);
+
+            // 2D mode: dummy or near-flat elevation is replaced by one constant. Tobler's penalty at slope
+            // S differs from level ground by about 3.5 |S|; an elevation range of at most FLAT_SLOPE_TOLERANCE
+            // x the cell size bounds every slope by that value, keeping each edge within ~0.1% of its flat cost.
+            constexpr float FLAT_SLOPE_TOLERANCE = 2.5e-4f;
+            bool flatTerrain = false;
+            float flatElevation = 100.0f;
+            if (params.flatTerrainMode == 1) {
+                flatTerrain = true;
+            }
+            else if (params.flatTerrainMode == 0) {
+                if (!useRealElevation) {
+                    flatTerrain = true;
+                }
+                else if (!elevation_values_final.empty()) {
+                    const auto [minIt, maxIt] = std::minmax_element(elevation_values_final.begin(), elevation_values_final.end());
+                    if (*maxIt - *minIt <= FLAT_SLOPE_TOLERANCE * log_cell_resolution_meters) {
+                        flatTerrain = true;
+                        flatElevation = 0.5f * (*minIt + *maxIt);
+                    }
+                }
+            }
+            if (flatTerrain) {
+                std::vector<float>().swap(elevation_values_final); // Not sampled in 2D mode
+            }
+            result.usedFlatTerrain = flatTerrain;
             
             // Store final calculated parameters in result
             result.finalLogicalResolutionMeters = log_cell_resolution_meters;
@@ -314,16 +575,315 @@ namespace app {
 
             const Grid_V3& grid = logical_grid_opt.value(); // Use const ref to grid
 
-            for (size_t i = 0; i < waypoints.size() - 1; ++i) {
+            // Resample elevation onto the logical grid once; every CPU segment search shares it.
+            // In 2D mode the raster is a single value and nothing is sampled.
+            auto start_context = std::chrono::high_resolution_clock::now();
+            const ElevationRaster elevationRaster = flatTerrain
+                ? ElevationRaster::constant(grid.width(), grid.height(), log_cell_resolution_meters, flatElevation)
+                : ElevationRaster::fromSampler(
+                    ElevationSampler(elevation_values_final, elevation_width_final, elevation_height_final,
+                        elevation_resolution_final, origin_offset_x, origin_offset_y),
+                    grid.width(), grid.height(), log_cell_resolution_meters);
+            PathfindingContext pfContext = makePathfindingContext(grid, &elevationRaster, log_cell_resolution_meters);
+            pfContext.queue_type = (params.priorityQueueType == 0) ? QueueType::BinaryHeap : QueueType::RadixHeap;
+            // Cost model and connectivity pick the specialized A*/Dijkstra kernels (see SearchKernels.hpp);
+            // every other planner searches 8-connected Tobler costs
+            if (params.algorithmName == "Optimized A*" || params.algorithmName == "Dijkstra") {
+                pfContext.cost_model = (params.costModel == 2) ? CostModel::TerrainOnly
+                    : (params.costModel == 1) ? CostModel::FlatTobler : CostModel::Tobler;
+                pfContext.connectivity = (params.connectivity == 4) ? 4 : 8;
+                if (flatTerrain && pfContext.cost_model == CostModel::Tobler) {
+                    pfContext.cost_model = CostModel::FlatTobler; // Same costs on a constant raster, without the slope evaluation
+                }
+            }
+            else if (params.costModel != 0 || params.connectivity != 8) {
+                qDebug() << "PathfindingLogic: Cost model and connectivity only apply to Optimized A* and Dijkstra; using 8-connected Tobler costs.";
+            }
+            if (flatTerrain) {
+                qDebug() << "PathfindingLogic: 2D mode (flat terrain at" << flatElevation << "m): no elevation sampling, no edge-cost cache.";
+            }
+
+            // Optional precomputed 8-direction edge costs (read by the A*/Dijkstra family; BFS only tests passability)
+            EdgeCostCache edgeCostCache;
+            const bool algorithmUsesEdgeCosts = params.algorithmName == "Optimized A*" || params.algorithmName == "Dijkstra" ||
+                params.algorithmName == "Bidirectional Dijkstra" || params.algorithmName == "Bidirectional A*" ||
+                params.algorithmName == "HPA*" || params.algorithmName == "Contraction Hierarchy" ||
+                params.algorithmName == "Delta Stepping - CPU" || params.algorithmName == "HADS - CPU" ||
+                params.algorithmName == "ARA*";
+            if (algorithmUsesEdgeCosts && !flatTerrain && pfContext.cost_model == CostModel::Tobler && (params.edgeCostCacheMode == 1 || params.edgeCostCacheMode == 2)) {
+                const auto precision = (params.edgeCostCacheMode == 2) ? EdgeCostCache::Precision::Float16 : EdgeCostCache::Precision::Float32;
+                edgeCostCache = EdgeCostCache::build(grid, elevationRaster, log_cell_resolution_meters, precision);
+                if (edgeCostCache.isValid()) {
+                    pfContext.edge_costs = &edgeCostCache;
+                    qDebug() << "PathfindingLogic: Edge-cost cache built (" << (edgeCostCache.memoryBytes() / (1024.0 * 1024.0)) << "MB).";
+                }
+                else {
+                    qWarning() << "PathfindingLogic: Could not build edge-cost cache (out of memory?). Computing costs on the fly.";
+                }
+            }
+
+            // Compact grid: the A*/Dijkstra kernels read 1 byte per neighbour instead of a GridCellData
+            // when no edge-cost cache covers the costs (cache off, 2D mode, or another cost model)
+            CompactGrid compactGrid;
+            if ((params.algorithmName == "Optimized A*" || params.algorithmName == "Dijkstra") && params.useCompactGrid && !pfContext.hasEdgeCosts()) {
+                compactGrid = CompactGrid::fromGrid(grid);
+                if (compactGrid.isValid() && compactGrid.isNarrow()) {
+                    pfContext.compact_grid = &compactGrid;
+                    qDebug() << "PathfindingLogic: Compact grid built:" << compactGrid.paletteSize() << "distinct cells,"
+                        << (compactGrid.memoryBytes() / (1024.0 * 1024.0)) << "MB instead of"
+                        << (grid.data().size() * sizeof(GridCellData) / (1024.0 * 1024.0)) << "MB.";
+                }
+                else {
+                    qDebug() << "PathfindingLogic: Grid has too many distinct cells for 1-byte codes; searching the full grid.";
+                    compactGrid = CompactGrid();
+                }
+            }
+            TiledGrid tiledGrid;
+            if (pfContext.compact_grid != nullptr && params.searchLayout == 1) {
+                tiledGrid = TiledGrid::build(compactGrid, &elevationRaster);
+                if (tiledGrid.isValid()) {
+                    pfContext.tiled_grid = &tiledGrid;
+                    qDebug() << "PathfindingLogic: Tiled search layout built (" << (tiledGrid.memoryBytes() / (1024.0 * 1024.0)) << "MB).";
+                }
+            }
+
+            // ALT landmark tables: restored from the grid cache when possible, else built (2K full-grid searches)
+            std::optional<LandmarkHeuristic> landmarkTables;
+            if (params.algorithmName == "Optimized A*" && params.heuristicType == HEURISTIC_ALT && pfContext.costsMatchTobler()) {
+                const std::string cacheDir = params.gridCacheDirectory.empty() ? gridcache::defaultCacheDirectory() : params.gridCacheDirectory;
+                std::optional<std::uint64_t> landmarkKey;
+                if (params.useGridCache) {
+                    landmarkKey = gridcache::computeLandmarkCacheKey(grid, elevationRaster, log_cell_resolution_meters, params.altLandmarkCount);
+                    landmarkTables = gridcache::loadLandmarkCache(cacheDir, *landmarkKey);
+                    if (landmarkTables) {
+                        qDebug() << "PathfindingLogic: Loaded ALT landmark tables from cache" << QString::fromStdString(gridcache::landmarkCacheFilePath(cacheDir, *landmarkKey));
+                    }
+                }
+                if (!landmarkTables) {
+                    landmarkTables = LandmarkHeuristic::build(pfContext, params.altLandmarkCount);
+                    if (landmarkTables->isValid() && landmarkKey && !gridcache::saveLandmarkCache(cacheDir, *landmarkKey, *landmarkTables, cacheBudgetBytes(params))) {
+                        qWarning() << "PathfindingLogic: Failed to write landmark cache (continuing without it).";
+                    }
+                }
+                if (landmarkTables->isValid()) {
+                    pfContext.landmarks = &*landmarkTables;
+                    qDebug() << "PathfindingLogic: ALT ready:" << landmarkTables->landmarkCount() << "landmarks ("
+                        << (landmarkTables->memoryBytes() / (1024.0 * 1024.0)) << "MB).";
+                }
+                else {
+                    qWarning() << "PathfindingLogic: Could not build ALT landmark tables (no passable border cell or out of memory). Using the Euclidean bound.";
+                }
+            }
+
+            // HPA* abstraction: built once per run and shared by every leg
+            HierarchicalGraph hierarchy;
+            if (params.algorithmName == "HPA*") {
+                HierarchicalGraph::Settings hierarchySettings;
+                hierarchySettings.cluster_size = params.hpaClusterSize;
+                hierarchy = HierarchicalGraph::build(pfContext, hierarchySettings);
+                if (!hierarchy.isValid()) {
+                    throw std::runtime_error("Failed to build the HPA* abstraction (cluster size " + std::to_string(params.hpaClusterSize) + ").");
+                }
+                pfContext.hierarchy = &hierarchy;
+                qDebug() << "PathfindingLogic: HPA* abstraction built:" << hierarchy.clustersX() << "x" << hierarchy.clustersY() << "clusters,"
+                    << hierarchy.nodeCount() << "nodes," << hierarchy.edgeCount() << "edges ("
+                    << (hierarchy.memoryBytes() / (1024.0 * 1024.0)) << "MB).";
+            }
+
+            // Contraction hierarchy: the customizable topology (passability only) is restored from the grid cache and
+            // customized to this run's costs, else built in parallel; then every leg is a small query
+            ContractionHierarchy contraction;
+            if (params.algorithmName == "Contraction Hierarchy") {
+                const std::size_t cellCount = grid.width() * grid.height();
+                if (cellCount > ContractionHierarchy::MAX_CELLS) {
+                    throw std::runtime_error("Grid too large for the contraction hierarchy (" + std::to_string(cellCount) + " cells, limit " +
+                        std::to_string(ContractionHierarchy::MAX_CELLS) + "). Use Optimized A* or HPA*, or a coarser grid.");
+                }
+                const std::string cacheDir = params.gridCacheDirectory.empty() ? gridcache::defaultCacheDirectory() : params.gridCacheDirectory;
+                std::optional<std::uint64_t> contractionKey;
+                bool restored = false;
+                if (params.customizableContraction && params.useGridCache) {
+                    contractionKey = gridcache::computeContractionCacheKey(grid);
+                    std::optional<ContractionHierarchy> cached = gridcache::loadContractionCache(cacheDir, *contractionKey);
+                    auto start_customize = std::chrono::high_resolution_clock::now();
+                    if (cached && cached->customize(pfContext)) {
+                        contraction = std::move(*cached);
+                        restored = true;
+                        qDebug() << "PathfindingLogic: Loaded contraction hierarchy from cache" << QString::fromStdString(gridcache::contractionCacheFilePath(cacheDir, *contractionKey))
+                            << "and customized it in" << std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start_customize).count() << "ms.";
+                    }
+                }
+                if (!restored) {
+                    ContractionHierarchy::Settings contractionSettings;
+                    contractionSettings.customizable = params.customizableContraction;
+                    contraction = ContractionHierarchy::build(pfContext, contractionSettings);
+                    if (!contraction.isValid()) {
+                        throw std::runtime_error("Failed to build the contraction hierarchy (out of memory?).");
+                    }
+                    if (contractionKey && !gridcache::saveContractionCache(cacheDir, *contractionKey, contraction, cacheBudgetBytes(params))) {
+                        qWarning() << "PathfindingLogic: Failed to write contraction hierarchy cache (continuing without it).";
+                    }
+                }
+                pfContext.contraction = &contraction;
+                qDebug() << "PathfindingLogic: Contraction hierarchy ready:" << contraction.contractionRounds() << "rounds,"
+                    << contraction.shortcutCount() << "shortcuts," << contraction.arcCount() << "arcs ("
+                    << (contraction.memoryBytes() / (1024.0 * 1024.0)) << "MB, peak during build"
+                    << (contraction.peakBuildBytes() / (1024.0 * 1024.0)) << "MB).";
+            }
+            auto end_context = std::chrono::high_resolution_clock::now();
+            qDebug() << "PathfindingLogic: Pathfinding context built in"
+                << std::chrono::duration<double, std::milli>(end_context - start_context).count() << "ms.";
+
+            // --- Optional all-pairs cost matrix between the waypoints (course setting) ---
+            if (params.computeLegCostMatrix) {
+                auto start_matrix = std::chrono::high_resolution_clock::now();
+                LegCostMatrix matrix = computeLegCostMatrix(pfContext, waypoints, params.legCostMatrixPaths);
+                result.legCostMatrixDurationMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start_matrix).count();
+                size_t unreachable = 0;
+                for (size_t from = 0; from < matrix.size; ++from) {
+                    for (size_t to = 0; to < matrix.size; ++to) {
+                        if (from != to && !matrix.reachable(from, to)) { ++unreachable; }
+                    }
+                }
+                qDebug() << "PathfindingLogic: Leg cost matrix" << matrix.size << "x" << matrix.size << "computed in"
+                    << result.legCostMatrixDurationMs << "ms (" << unreachable << "unreachable pairs).";
+                result.legCostMatrix = std::move(matrix.costs);
+                result.legCostMatrixPaths = std::move(matrix.paths);
+            }
+
+            // --- Optional travel-time field to the finish: heat-map output, and exact A* heuristic for the last leg ---
+            TravelTimeField travelTimeField;
+            if (params.computeTravelTimeField) {
+                auto start_field = std::chrono::high_resolution_clock::now();
+                travelTimeField = TravelTimeField::compute(pfContext, waypoints.back());
+                result.travelTimeFieldDurationMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start_field).count();
+                if (travelTimeField.isValid()) {
+                    pfContext.travel_time = &travelTimeField;
+                    qDebug() << "PathfindingLogic: Travel-time field to the finish computed in" << result.travelTimeFieldDurationMs
+                        << "ms (delta" << travelTimeField.delta() << "," << (travelTimeField.memoryBytes() / (1024.0 * 1024.0)) << "MB).";
+                    if (!params.travelTimeFieldPath.empty() &&
+                        !rasterexport::saveFloatRaster(params.travelTimeFieldPath, travelTimeField.times(), travelTimeField.width(), travelTimeField.height(), finalNormInfo)) {
+                        qWarning() << "PathfindingLogic: Failed to export the travel-time field to" << QString::fromStdString(params.travelTimeFieldPath);
+                    }
+                    result.travelTimeField = travelTimeField.times();
+                }
+                else {
+                    qWarning() << "PathfindingLogic: Could not compute the travel-time field (finish impassable or out of memory).";
+                }
+            }
+            // --- LPA*: the legs live in a session that outlives this call (see ReplanningSession) ---
+            if (params.algorithmName == "LPA* (Incremental)") {
+                auto session = std::make_shared<ReplanningSession>(grid, elevationRaster, log_cell_resolution_meters, waypoints);
+                // Without a key (a file could not be hashed) the session is never reused
+                session->setSource(params.mapFilePath, params.controlsFilePath, makeProcessorConfig(params), lpaSourceKey.value_or(0));
+                session->setRunInfo(result);
+                qDebug() << "PathfindingLogic: LPA* session created (" << (session->memoryBytes() / (1024.0 * 1024.0)) << "MB).";
+                applyReplanResult(result, session->replan(), session);
+                return result;
+            }
+
+            // --- Validate legs (serial, cheap) ---
+            // Legs are solved up to the first out-of-bounds one; its error is only reported if every
+            // earlier leg succeeded, matching the order in which a serial loop would hit the failures.
+            const size_t segment_count = waypoints.size() - 1;
+            size_t solvable_segments = segment_count;
+            for (size_t i = 0; i < segment_count; ++i) {
+                if (!grid.inBounds(waypoints[i].x, waypoints[i].y) || !grid.inBounds(waypoints[i + 1].x, waypoints[i + 1].y)) {
+                    solvable_segments = i;
+                    break;
+                }
+            }
+
+            // --- Solve legs concurrently ---
+            // Legs are independent given the shared read-only context. Each worker thread owns a
+            // forward/backward workspace pair (16 bytes per cell each, allocated on first use), so the
+            // thread count is capped by params.segmentWorkspaceBudgetMB.
+            std::vector<std::vector<int>> segment_paths(solvable_segments);
+            std::vector<double> segment_durations_ms(solvable_segments, 0.0);
+            std::vector<size_t> segment_touched_cells(solvable_segments, 0);
+            std::vector<std::pair<size_t, size_t>> segment_cache_stats(solvable_segments); // Theta* segment memo hits/misses
+            std::vector<std::string> segment_exceptions(solvable_segments);
+            std::vector<std::vector<AnytimeLegSolution>> segment_anytime_solutions(solvable_segments);
+
+            // The delta-stepping searches already spread each leg over all threads, so their legs run one by one
+            const bool algorithmIsParallel = params.algorithmName == "Delta Stepping - CPU" || params.algorithmName == "HADS - CPU";
+            int worker_count = 1;
+#ifdef _OPENMP
+            if (params.parallelSegments && !algorithmIsParallel) {
+                worker_count = std::max(1, std::min(omp_get_max_threads(), static_cast<int>(solvable_segments)));
+            }
+            if (worker_count > 1) {
+                const bool algorithmUsesBackward = params.algorithmName == "Bidirectional Dijkstra" || params.algorithmName == "Bidirectional A*" ||
+                    params.algorithmName == "Contraction Hierarchy";
+                const double workerBytes = static_cast<double>(grid.width()) * static_cast<double>(grid.height()) *
+                    static_cast<double>(SearchWorkspace::BYTES_PER_CELL) * (algorithmUsesBackward ? 2.0 : 1.0);
+                const double budgetBytes = std::max(0.0, params.segmentWorkspaceBudgetMB) * 1024.0 * 1024.0;
+                const int affordable = static_cast<int>(std::min(budgetBytes / workerBytes, static_cast<double>(worker_count)));
+                if (affordable < worker_count) {
+                    const int capped = std::max(1, affordable);
+                    qDebug() << "PathfindingLogic:" << worker_count << "concurrent legs would need"
+                        << (workerBytes * worker_count / (1024.0 * 1024.0)) << "MB of search workspaces (budget"
+                        << params.segmentWorkspaceBudgetMB << "MB);" << (capped > 1 ? "limiting to" : "solving legs serially, threads:")
+                        << capped;
+                    worker_count = capped;
+                }
+            }
+#endif
+            std::vector<SearchWorkspace> forwardWorkspaces(static_cast<size_t>(worker_count));
+            std::vector<SearchWorkspace> backwardWorkspaces(static_cast<size_t>(worker_count));
+            qDebug() << "PathfindingLogic: Solving" << solvable_segments << "segment(s) on" << worker_count << "thread(s).";
+
+            auto start_segments = std::chrono::high_resolution_clock::now();
+            // Dynamic schedule: leg costs vary wildly with leg length and terrain
+#pragma omp parallel for schedule(dynamic, 1) num_threads(worker_count)
+            for (long long leg = 0; leg < static_cast<long long>(solvable_segments); ++leg) {
+                const size_t i = static_cast<size_t>(leg);
+                const GridPoint& segment_start_point = waypoints[i];
+                const GridPoint& segment_end_point = waypoints[i + 1];
+
+                // Identical Point Check
+                if (segment_start_point == segment_end_point) {
+                    segment_paths[i].push_back(toIndex(segment_start_point.x, segment_start_point.y, grid.width()));
+                    continue;
+                }
+
+#ifdef _OPENMP
+                const size_t worker = static_cast<size_t>(omp_get_thread_num());
+#else
+                const size_t worker = 0;
+#endif
+                // Exceptions must not escape the parallel region; they are rethrown in leg order below
+                auto start_segment = std::chrono::high_resolution_clock::now();
+                try {
+                    segment_paths[i] = solveSegment(params, pfContext, forwardWorkspaces[worker], backwardWorkspaces[worker],
+                        segment_start_point, segment_end_point, i, segment_anytime_solutions[i]);
+                }
+                catch (const std::exception& e) {
+                    segment_exceptions[i] = e.what();
+                    if (segment_exceptions[i].empty()) segment_exceptions[i] = "Unknown error while solving segment.";
+                }
+                catch (...) {
+                    segment_exceptions[i] = "Unknown error while solving segment.";
+                }
+                auto end_segment = std::chrono::high_resolution_clock::now();
+                segment_durations_ms[i] = std::chrono::duration<double, std::milli>(end_segment - start_segment).count();
+                segment_touched_cells[i] = forwardWorkspaces[worker].touchedCount();
+                const SegmentCostCache& segment_cache = forwardWorkspaces[worker].segmentCache();
+                segment_cache_stats[i] = { segment_cache.hits(), segment_cache.misses() };
+            }
+            auto end_segments = std::chrono::high_resolution_clock::now();
+
+            // --- Stitch legs in order (first failing leg wins, as in the serial loop) ---
+            for (size_t i = 0; i < segment_count; ++i) {
                 GridPoint segment_start_point = waypoints[i];
                 GridPoint segment_end_point = waypoints[i + 1];
 
-                qDebug() << "PathfindingLogic: Calculating segment" << (i + 1) << "/" << (waypoints.size() - 1) << "from"
+                qDebug() << "PathfindingLogic: Segment" << (i + 1) << "/" << segment_count << "from"
                     << segment_start_point.x << "," << segment_start_point.y << "to"
                     << segment_end_point.x << "," << segment_end_point.y;
 
                 // Bounds Check
-                if (!grid.inBounds(segment_start_point.x, segment_start_point.y) || !grid.inBounds(segment_end_point.x, segment_end_point.y)) {
+                if (i >= solvable_segments) {
                     errorMsg = QString("Segment %1 start/end point (%2,%3 -> %4,%5) out of grid bounds (WxH: %6x%7).")
                         .arg(i + 1)
                         .arg(segment_start_point.x).arg(segment_start_point.y)
@@ -337,98 +897,30 @@ namespace app {
                 // Identical Point Check
                 if (segment_start_point == segment_end_point) {
                     qDebug() << "PathfindingLogic: Segment points identical, skipping calculation.";
-                    int pointIndex = toIndex(segment_start_point.x, segment_start_point.y, grid.width());
+                    int pointIndex = segment_paths[i].front();
                     if (full_path_indices.empty() || full_path_indices.back() != pointIndex) {
                         full_path_indices.push_back(pointIndex);
                     }
                     continue;
                 }
+                if (!segment_exceptions[i].empty()) {
+                    throw std::runtime_error(segment_exceptions[i]); // Same handling as a throw from the search itself
+                }
 
-                // --- Call Selected Pathfinding Function ---
-                auto start_segment = std::chrono::high_resolution_clock::now();
-                std::vector<int> segment_path_indices;
-                bool isGpuAlgorithm = params.algorithmName.find("GPU") != std::string::npos;
-                
-#ifdef USE_CUDA
-                //// --- GPU Algorithm Calls ---
-                //if (params.algorithmName == "Delta Stepping - GPU") {
-                //    segment_path_indices = findPathGPU_DeltaStepping(
-                //        grid, elevation_values_final, elevation_width_final, elevation_height_final,
-                //        log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
-                //        segment_start_point, segment_end_point, params.gpuDelta, params.gpuThreshold);
-                //}
-                //else if (params.algorithmName == "HADS - GPU") {
-                //    segment_path_indices = findPathGPU_HADS(
-                //        grid, elevation_values_final, elevation_width_final, elevation_height_final,
-                //        log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
-                //        segment_start_point, segment_end_point,
-                //        params.gpuDelta, params.gpuThreshold, params.hadsRadius, params.hadsPruneFactor, params.hadsHeuristicWeight);
-                //}
-                //else if (params.algorithmName == "A* - GPU") {
-                //    segment_path_indices = findPathGPU_AStar(
-                //        grid, elevation_values_final, elevation_width_final, elevation_height_final,
-                //        log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
-                //        segment_start_point, segment_end_point, params.heuristicType);
-                //}
-                //else
-#endif // USE_CUDA
-                    // --- CPU Algorithm Calls ---
-                    if (params.algorithmName == "Optimized A*") {
-                        segment_path_indices = findAStarPath_Tobler_Sampled(
-                            grid, elevation_values_final, elevation_width_final, elevation_height_final,
-                            log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
-                            segment_start_point, segment_end_point, params.heuristicType);
-                    }
-                    else if (params.algorithmName == "Dijkstra") {
-                        segment_path_indices = findDijkstraPath_Tobler_Sampled(
-                            grid, elevation_values_final, elevation_width_final, elevation_height_final,
-                            log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
-                            segment_start_point, segment_end_point);
-                    }
-                    else if (params.algorithmName == "BFS") {
-                        segment_path_indices = findBFSPath_Tobler_Sampled( // Ensure signature matches
-                            grid, elevation_values_final, elevation_width_final, elevation_height_final,
-                            log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
-                            segment_start_point, segment_end_point);
-                    }
-                    else if (params.algorithmName == "Theta*") {
-                        segment_path_indices = findThetaStarPath_Tobler_Sampled( // Ensure signature matches
-                            grid, elevation_values_final, elevation_width_final, elevation_height_final,
-                            log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
-                            segment_start_point, segment_end_point, params.heuristicType);
-                    }
-                    else if (params.algorithmName == "Lazy Theta*") {
-                        segment_path_indices = findLazyThetaStarPath_Tobler_Sampled( // Ensure signature matches
-                            grid, elevation_values_final, elevation_width_final, elevation_height_final,
-                            log_cell_resolution_meters, elevation_resolution_final, origin_offset_x, origin_offset_y,
-                            segment_start_point, segment_end_point, params.heuristicType);
-                    }
-                // --- Error Handling for Unknown Algorithm ---
-                    else {
-                        // This logic handles the case where the name is unrecognized,
-                        // considering whether CUDA is enabled or not.
-#ifdef USE_CUDA
-                        if (isGpuAlgorithm) { // Name contained GPU but didn't match known GPU types
-                            errorMsg = "Selected GPU algorithm '" + params.algorithmName + "' is not implemented.";
-                        }
-                        else { // Name did not contain GPU and didn't match known CPU types
-                            errorMsg = "Unsupported CPU algorithm selected: " + params.algorithmName;
-                        }
-#else // USE_CUDA not defined
-                        if (isGpuAlgorithm) { // Name contained GPU, but CUDA is off
-                            errorMsg = "GPU algorithm '" + params.algorithmName + "' selected, but CUDA is disabled in this build.";
-                        }
-                        else { // Name did not contain GPU and didn't match known CPU types
-                            errorMsg = "Unsupported CPU algorithm selected: " + params.algorithmName;
-                        }
-#endif // USE_CUDA
-                        throw std::runtime_error(errorMsg); // Throw exception for unsupported algorithm
-                    }
-
-                auto end_segment = std::chrono::high_resolution_clock::now();
-                double segment_duration_ms = std::chrono::duration<double, std::milli>(end_segment - start_segment).count();
+                std::vector<int>& segment_path_indices = segment_paths[i];
+                double segment_duration_ms = segment_durations_ms[i];
                 total_pathfinding_segment_duration_ms += segment_duration_ms;
-                qDebug() << "PathfindingLogic: Segment" << (i + 1) << "took" << segment_duration_ms << "ms.";
+                qDebug() << "PathfindingLogic: Segment" << (i + 1) << "took" << segment_duration_ms << "ms,"
+                    << segment_touched_cells[i] << "cells touched.";
+                if (segment_cache_stats[i].first + segment_cache_stats[i].second > 0) {
+                    qDebug() << "PathfindingLogic:   Segment cache:" << segment_cache_stats[i].first << "hits,"
+                        << segment_cache_stats[i].second << "misses (line-of-sight traversals).";
+                }
+                for (AnytimeLegSolution& published : segment_anytime_solutions[i]) {
+                    qDebug() << "PathfindingLogic:   ARA* route at" << published.elapsedMs << "ms: epsilon" << published.epsilon
+                        << ", cost" << published.cost << "<=" << published.suboptimalityBound << "x optimal.";
+                    result.anytimeSolutions.push_back(std::move(published));
+                }
 
                 // Check Segment Result & Concatenate
                 if (segment_path_indices.empty()) {
@@ -468,10 +960,12 @@ namespace app {
                         }
                     }
                 }
-            } // End waypoint loop
+            } // End stitch loop
 
-            result.pathfindingDurationMs = total_pathfinding_segment_duration_ms;
-            qDebug() << "PathfindingLogic: Pathfinding loop finished. Total segment time:" << result.pathfindingDurationMs << "ms.";
+            // Legs overlap in time, so report wall-clock time; the per-leg sum shows the work done
+            result.pathfindingDurationMs = std::chrono::duration<double, std::milli>(end_segments - start_segments).count();
+            qDebug() << "PathfindingLogic: Pathfinding loop finished. Wall time:" << result.pathfindingDurationMs
+                << "ms, summed segment time:" << total_pathfinding_segment_duration_ms << "ms.";
 
             //--------------------------------------------
             // 5. Finalize Result
@@ -0,0 +1,202 @@
+#include "logic/ReplanningSession.hpp"
+#include "algoritms/ToblerKernel.hpp" // For isPassable
+
+#include <stdexcept>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+#include <iterator>
+
+#include <QDebug>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace mapgeo;
+using namespace Pathfinding;
+
+namespace app {
+
+    namespace {
+        // Exact: an approximately equal value still changes the edge costs a planner has stored
+        bool sameCell(const GridCellData& a, const GridCellData& b) {
+            return a.value == b.value && a.flags == b.flags;
+        }
+    } // end anonymous namespace
+
+    ReplanningSession::ReplanningSession(Grid_V3 grid, ElevationRaster elevation, float log_cell_resolution,
+        std::vector<GridPoint> waypoints)
+        : grid_(std::move(grid)), elevation_(std::move(elevation)), waypoints_(std::move(waypoints))
+    {
+        context_ = makePathfindingContext(grid_, &elevation_, log_cell_resolution);
+        if (waypoints_.size() < 2) { return; }
+        planners_.reserve(waypoints_.size() - 1);
+        for (size_t i = 0; i + 1 < waypoints_.size(); ++i) {
+            planners_.emplace_back(context_, waypoints_[i], waypoints_[i + 1]);
+        }
+    }
+
+    void ReplanningSession::setSource(const std::string& mapFilePath, const std::string& controlsFilePath, const MapProcessorConfig& processorConfig,
+        std::uint64_t sourceKey)
+    {
+        // The parsed map is only valid for the exact file contents and config it was loaded with
+        if (mapFilePath != map_file_path_ || sourceKey != source_key_) { processor_.reset(); }
+        map_file_path_ = mapFilePath;
+        controls_file_path_ = controlsFilePath;
+        processor_config_ = processorConfig;
+        source_key_ = sourceKey;
+    }
+
+    void ReplanningSession::setRunInfo(BackendResult runInfo) {
+        // Paths and grids are produced per replan; keep only the echoed inputs and elevation outputs
+        runInfo.processedGrid.reset();
+        runInfo.fullPathIndices.clear();
+        runInfo.legCostMatrix.clear();
+        runInfo.legCostMatrixPaths.clear();
+        runInfo.travelTimeField.clear();
+        runInfo.anytimeSolutions.clear();
+        runInfo.replanningSession.reset();
+        run_info_ = std::move(runInfo);
+    }
+
+    bool ReplanningSession::matches(const std::string& mapFilePath, const std::string& controlsFilePath, int gridWidth, int gridHeight,
+        std::uint64_t sourceKey) const
+    {
+        return !map_file_path_.empty() && mapFilePath == map_file_path_ && controlsFilePath == controls_file_path_ &&
+            static_cast<size_t>(gridWidth) == grid_.width() && static_cast<size_t>(gridHeight) == grid_.height() &&
+            sourceKey == source_key_;
+    }
+
+    void ReplanningSession::notifyAll(int idx) {
+        ++pending_changes_;
+        const GridCellData& cell = grid_.data()[static_cast<size_t>(idx)];
+        // Keep the context's heuristic bound valid for anything built from it later
+        if (isPassable(cell) && cell.value < context_.min_terrain_cost) { context_.min_terrain_cost = cell.value; }
+        for (LPAStarPlanner& planner : planners_) { planner.notifyCellChanged(idx); }
+    }
+
+    size_t ReplanningSession::updateCells(const std::vector<CellUpdate>& updates) {
+        std::vector<GridCellData>& cells = grid_.data();
+        size_t changed = 0;
+        for (const CellUpdate& update : updates) {
+            if (update.index < 0 || static_cast<size_t>(update.index) >= cells.size()) { continue; }
+            GridCellData& cell = cells[static_cast<size_t>(update.index)];
+            if (sameCell(cell, update.cell)) { continue; }
+            cell = update.cell;
+            notifyAll(update.index);
+            ++changed;
+        }
+        return changed;
+    }
+
+    size_t ReplanningSession::updateGrid(const Grid_V3& newGrid) {
+        if (newGrid.width() != grid_.width() || newGrid.height() != grid_.height()) {
+            throw std::runtime_error("Replanning session: replacement grid has a different size.");
+        }
+        std::vector<GridCellData>& cells = grid_.data();
+        const std::vector<GridCellData>& newCells = newGrid.data();
+        size_t changed = 0;
+        for (size_t i = 0; i < cells.size(); ++i) {
+            if (sameCell(cells[i], newCells[i])) { continue; }
+            cells[i] = newCells[i];
+            notifyAll(static_cast<int>(i));
+            ++changed;
+        }
+        return changed;
+    }
+
+    size_t ReplanningSession::markRegionImpassable(int x0, int y0, int x1, int y1) {
+        if (x0 > x1) { std::swap(x0, x1); }
+        if (y0 > y1) { std::swap(y0, y1); }
+        const int width = static_cast<int>(grid_.width());
+        const int height = static_cast<int>(grid_.height());
+        x0 = std::max(x0, 0); y0 = std::max(y0, 0);
+        x1 = std::min(x1, width - 1); y1 = std::min(y1, height - 1);
+        size_t changed = 0;
+        for (int y = y0; y <= y1; ++y) {
+            for (int x = x0; x <= x1; ++x) {
+                GridCellData& cell = grid_.at(static_cast<size_t>(x), static_cast<size_t>(y));
+                if (cell.hasFlag(GridFlags::FLAG_IMPASSABLE)) { continue; }
+                cell.setFlag(GridFlags::FLAG_IMPASSABLE);
+                notifyAll(PathfindingUtils::toIndex(x, y, width));
+                ++changed;
+            }
+        }
+        return changed;
+    }
+
+    size_t ReplanningSession::updateObstacleCosts(const ObstacleConfigMap& obstacleCosts) {
+        if (map_file_path_.empty()) {
+            throw std::runtime_error("Replanning session: no map source set, cannot regenerate the grid.");
+        }
+        if (!processor_) {
+            auto processor = std::make_unique<MapProcessor>(processor_config_);
+            if (!processor->loadMap(map_file_path_)) {
+                throw std::runtime_error("Map load failed: " + map_file_path_);
+            }
+            processor_ = std::move(processor);
+        }
+        std::optional<Grid_V3> newGrid = processor_->generateGrid(obstacleCosts);
+        if (!newGrid) { throw std::runtime_error("Grid generation failed"); }
+        return updateGrid(*newGrid);
+    }
+
+    ReplanResult ReplanningSession::replan() {
+        ReplanResult result;
+        result.changedCells = pending_changes_;
+        pending_changes_ = 0;
+        if (planners_.empty()) {
+            result.errorMessage = "Not enough waypoints for pathfinding.";
+            return result;
+        }
+        auto start_replan = std::chrono::high_resolution_clock::now();
+
+        // Each planner owns its search state and only reads the shared grid, so legs repair independently
+        const size_t leg_count = planners_.size();
+        std::vector<std::vector<int>> leg_paths(leg_count);
+        std::vector<size_t> leg_expansions(leg_count, 0);
+#pragma omp parallel for schedule(dynamic, 1)
+        for (long long leg = 0; leg < static_cast<long long>(leg_count); ++leg) {
+            const size_t i = static_cast<size_t>(leg);
+            leg_paths[i] = planners_[i].computePath();
+            leg_expansions[i] = planners_[i].lastExpansions();
+        }
+
+        // --- Stitch legs in order (first failing leg wins) ---
+        result.legCosts.resize(leg_count, std::numeric_limits<float>::max());
+        for (size_t i = 0; i < leg_count; ++i) {
+            result.expandedCells += leg_expansions[i];
+            std::vector<int>& leg_path = leg_paths[i];
+            if (leg_path.empty()) {
+                if (result.errorMessage.empty()) {
+                    result.errorMessage = QString("Path not found for segment %1 (Start: %2,%3 End: %4,%5).")
+                        .arg(i + 1)
+                        .arg(waypoints_[i].x).arg(waypoints_[i].y)
+                        .arg(waypoints_[i + 1].x).arg(waypoints_[i + 1].y)
+                        .toStdString();
+                }
+                continue;
+            }
+            result.legCosts[i] = planners_[i].pathCost();
+            if (!result.errorMessage.empty()) { continue; }
+            auto first = leg_path.begin();
+            if (!result.fullPathIndices.empty() && result.fullPathIndices.back() == leg_path.front()) { ++first; }
+            result.fullPathIndices.insert(result.fullPathIndices.end(), std::make_move_iterator(first), std::make_move_iterator(leg_path.end()));
+        }
+        result.success = result.errorMessage.empty();
+        if (!result.success) { result.fullPathIndices.clear(); }
+
+        result.durationMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start_replan).count();
+        qDebug() << "ReplanningSession: Replanned" << leg_count << "leg(s) after" << result.changedCells << "changed cells in"
+            << result.durationMs << "ms," << result.expandedCells << "cells expanded.";
+        return result;
+    }
+
+    size_t ReplanningSession::memoryBytes() const {
+        size_t bytes = grid_.data().size() * sizeof(GridCellData) + elevation_.memoryBytes();
+        for (const LPAStarPlanner& planner : planners_) { bytes += planner.memoryBytes(); }
+        return bytes;
+    }
+
+} // namespace app
@@ -0,0 +1,110 @@
+// File: CompactGrid.cpp
+
+#include "map/CompactGrid.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <omp.h>
+
+namespace mapgeo {
+
+    namespace {
+
+        // Palette key: the value's bit pattern and the flags, so -0.0f, 0.0f and NaN payloads stay distinct
+        inline std::uint64_t cellKey(const GridCellData& cell) {
+            std::uint32_t bits;
+            std::memcpy(&bits, &cell.value, sizeof(bits));
+            return (static_cast<std::uint64_t>(bits) << 8) | cell.flags;
+        }
+
+        inline float terrainOf(const GridCellData& cell) {
+            return (cell.value <= 0.0f || cell.hasFlag(GridFlags::FLAG_IMPASSABLE)) ? 0.0f : cell.value;
+        }
+
+        template <typename Code>
+        void encodeRows(const Grid_V3& grid, const std::unordered_map<std::uint64_t, std::uint16_t>& codes, std::vector<Code>& out) {
+            const std::size_t width = grid.width();
+            const GridCellData* cells = grid.data().data();
+            out.resize(width * grid.height());
+
+            // Rows are independent; neighbouring cells mostly repeat, so each row remembers its last key
+#pragma omp parallel for schedule(static)
+            for (long long y = 0; y < static_cast<long long>(grid.height()); ++y) {
+                const std::size_t rowStart = static_cast<std::size_t>(y) * width;
+                std::uint64_t lastKey = ~std::uint64_t(0);
+                Code lastCode = 0;
+                for (std::size_t i = rowStart; i < rowStart + width; ++i) {
+                    const std::uint64_t key = cellKey(cells[i]);
+                    if (key != lastKey) {
+                        lastKey = key;
+                        lastCode = static_cast<Code>(codes.find(key)->second);
+                    }
+                    out[i] = lastCode;
+                }
+            }
+        }
+
+    } // end anonymous namespace
+
+    CompactGrid CompactGrid::fromGrid(const Grid_V3& grid) {
+        CompactGrid compact;
+        if (!grid.isValid()) { return compact; }
+
+        // Palette in first-occurrence order (serial, so the codes do not depend on the thread count)
+        std::unordered_map<std::uint64_t, std::uint16_t> codes;
+        std::vector<GridCellData> palette;
+        std::uint64_t lastKey = ~std::uint64_t(0);
+        for (const GridCellData& cell : grid.data()) {
+            const std::uint64_t key = cellKey(cell);
+            if (key == lastKey) { continue; }
+            lastKey = key;
+            if (codes.find(key) != codes.end()) { continue; }
+            if (palette.size() == WIDE_PALETTE_LIMIT) { return compact; } // Too many distinct cells
+            codes.emplace(key, static_cast<std::uint16_t>(palette.size()));
+            palette.push_back(cell);
+        }
+
+        compact.width_ = grid.width();
+        compact.height_ = grid.height();
+        compact.terrain_.assign(std::max(palette.size(), NARROW_PALETTE_LIMIT), 0.0f);
+        for (std::size_t code = 0; code < palette.size(); ++code) { compact.terrain_[code] = terrainOf(palette[code]); }
+        if (palette.size() <= NARROW_PALETTE_LIMIT) {
+            encodeRows(grid, codes, compact.narrow_codes_);
+        }
+        else {
+            encodeRows(grid, codes, compact.wide_codes_);
+        }
+        compact.palette_ = std::move(palette);
+        return compact;
+    }
+
+    std::size_t CompactGrid::memoryBytes() const {
+        return narrow_codes_.capacity() * sizeof(std::uint8_t) + wide_codes_.capacity() * sizeof(std::uint16_t) +
+            palette_.capacity() * sizeof(GridCellData) + terrain_.capacity() * sizeof(float);
+    }
+
+    Grid_V3 CompactGrid::toGrid() const {
+        Grid_V3 grid(width_, height_);
+        if (!isValid()) { return grid; }
+        GridCellData* cells = grid.data().data();
+        const long long size = static_cast<long long>(width_ * height_);
+#pragma omp parallel for schedule(static)
+        for (long long i = 0; i < size; ++i) {
+            cells[i] = cellAt(static_cast<std::size_t>(i));
+        }
+        return grid;
+    }
+
+    CompactGridView CompactGrid::view() const {
+        CompactGridView view;
+        if (!isNarrow()) { return view; }
+        view.codes = narrow_codes_.data();
+        view.terrain = terrain_.data();
+        view.width = static_cast<int>(width_);
+        view.height = static_cast<int>(height_);
+        return view;
+    }
+
+} // namespace mapgeo
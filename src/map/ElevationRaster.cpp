@@ -0,0 +1,48 @@
+// File: ElevationRaster.cpp
+
+#include "map/ElevationRaster.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <omp.h>
+
+namespace mapgeo {
+
+    ElevationRaster::ElevationRaster(std::size_t width, std::size_t height, float cell_resolution, std::vector<float> values)
+        : width_(width), height_(height), cell_resolution_(cell_resolution), values_(std::move(values))
+    {
+        if (values_.size() != width_ * height_) {
+            throw std::invalid_argument("ElevationRaster: Data size (" + std::to_string(values_.size()) +
+                ") does not match dimensions (" + std::to_string(width_) + "x" + std::to_string(height_) + ")");
+        }
+    }
+
+    ElevationRaster ElevationRaster::fromSampler(const ElevationSampler& sampler, std::size_t width, std::size_t height, float log_cell_resolution) {
+        std::vector<float> values(width * height);
+
+        // Rows are independent; static schedule since every row costs the same
+#pragma omp parallel for schedule(static)
+        for (long long cy = 0; cy < static_cast<long long>(height); ++cy) {
+            const float wy = (static_cast<float>(cy) + 0.5f) * log_cell_resolution;
+            float* row = values.data() + static_cast<std::size_t>(cy) * width;
+            for (std::size_t cx = 0; cx < width; ++cx) {
+                const float wx = (static_cast<float>(cx) + 0.5f) * log_cell_resolution;
+                row[cx] = sampler.getElevationAt(wx, wy);
+            }
+        }
+
+        return ElevationRaster(width, height, log_cell_resolution, std::move(values));
+    }
+
+    ElevationRaster ElevationRaster::constant(std::size_t width, std::size_t height, float cell_resolution, float elevation) {
+        ElevationRaster raster;
+        raster.width_ = width;
+        raster.height_ = height;
+        raster.cell_resolution_ = cell_resolution;
+        raster.values_.assign(1, elevation);
+        raster.index_mask_ = 0;
+        return raster;
+    }
+
+} // namespace mapgeo
@@ -1,11 +1,11 @@
 #include "map/MapProcessor.hpp"
 #include "map/ParallelProcessorFlags.hpp" // Needed for Pass 1 processing
+#include "map/TileBinning.hpp"            // Tile-binned merge mode for Pass 2
 #include "IO/tinyxml2.h"               // XML parsing library implementation detail
 
 #include <iostream>
 #include <sstream>
-#include <set>          // Used by MinimalRasterizer
-#include <queue>        // Used by MinimalRasterizer (flood fill)
+#include <iterator>     // For std::back_inserter
 #include <stdexcept>
 #include <vector>
 #include <cmath>
@@ -27,7 +27,6 @@ namespace mapgeo {
         // (Code for MinimalRasterizer as provided previously - ensure height_ fix is applied)
         class MinimalRasterizer {
             using VertexData = FinalFeatureData::VertexData;
-            using IntPointSet = std::set<IntPoint>;
 
 
             // --- Edge structure for Scanline ---
@@ -50,18 +49,8 @@ namespace mapgeo {
             MinimalRasterizer(size_t grid_width, size_t grid_height)
                 : grid_width_(grid_width),
                 grid_height_(grid_height),
-                visited_(grid_width* grid_height, false),
                 total_grid_cells_(grid_width* grid_height)
             {
-                // Ensure width/height are non-zero before allocating visited_
-                if (grid_width == 0 || grid_height == 0) {
-                    // Handle error or default construction state
-                    total_grid_cells_ = 0;
-                    // Potentially throw or set an error flag
-                }
-                else {
-                    visited_.assign(grid_width * grid_height, false);
-                }
             }
             //OLD getCoveredCells for flood fill
             //IntPointSet getCoveredCells(const std::vector<VertexData>& outer_boundary_vd,
@@ -148,77 +137,87 @@ namespace mapgeo {
             //}
             // --- Main Public Method (Refactored Orchestration) ---
             // --- Main Public Method (Refactored Orchestration - Option 2: Fill First) ---
-            IntPointSet getCoveredCells(const std::vector<VertexData>& outer_boundary_vd,
+            /**
+             * @brief Rasterizes a feature into sorted, non-overlapping row spans.
+             * @return Reference to an internal buffer that stays valid until the next call.
+             */
+            const std::vector<RowSpan>& getCoveredCells(const std::vector<VertexData>& outer_boundary_vd,
                 const std::vector<std::vector<VertexData>>& hole_boundaries_vd,
                 int effective_object_type,
                 const std::string& feature_sym_id = "")
             {
-                // Reset state for this feature - only the result set now
-                coveredCellsSet_.clear();
+                // Reset state for this feature - only the result buffers now
+                coveredSpans_.clear();
+                boundaryCells_.clear();
 
                 if (outer_boundary_vd.empty() || total_grid_cells_ == 0) {
                     if (!outer_boundary_vd.empty()) {
                         fprintf(stderr, "Warning (Rasterizer): Grid has zero cells, cannot process feature %s\n", feature_sym_id.c_str());
                     }
-                    return coveredCellsSet_;
+                    return coveredSpans_;
                 }
 
-                // Initialize sets
-                IntPointSet boundaryPoints;
-                IntPointSet interiorPoints;
-
                 // --- Handle different object types ---
                 if (effective_object_type != 1) { // 0=Point, 2=Line
                     // Only draw boundary (respecting open loops for lines)
-                    drawBoundary(outer_boundary_vd, boundaryPoints, effective_object_type);
+                    drawBoundary(outer_boundary_vd, boundaryCells_, effective_object_type);
                     // For points/lines, the result *is* the boundary. No interior.
-                    coveredCellsSet_ = boundaryPoints;
+                    cellsToSpans(boundaryCells_, coveredSpans_);
                 }
                 else { // 1=Area
                     // --- Step 1: Perform Scanline Fill for Area interior ---
-                    interiorPoints = scanlineFillInternal(outer_boundary_vd, hole_boundaries_vd);
+                    scanlineFillInternal(outer_boundary_vd, hole_boundaries_vd, interiorSpans_);
 
                     // --- Step 2: Draw boundaries *after* filling ---
-                    // We still calculate boundaryPoints separately for potential use in checks or if scanline fails.
-                    drawBoundary(outer_boundary_vd, boundaryPoints, 1); // Draw outer closed
+                    // We still calculate the boundary separately for the excessive-fill fallback below.
+                    drawBoundary(outer_boundary_vd, boundaryCells_, 1); // Draw outer closed
                     for (const auto& hole_vd : hole_boundaries_vd) {
                         if (hole_vd.size() >= 3) {
-                            drawBoundary(hole_vd, boundaryPoints, 1); // Draw holes closed
+                            drawBoundary(hole_vd, boundaryCells_, 1); // Draw holes closed
                         }
                     }
+                    cellsToSpans(boundaryCells_, boundarySpans_);
 
-                    // --- Step 3: Combine Results (Prioritize Interior, then add Boundary) ---
-                    coveredCellsSet_ = interiorPoints; // Start with interior pixels
-                    // Add boundary points. If a pixel was both interior and boundary,
-                    // it remains in the set, effectively prioritizing the boundary's presence
-                    // in the final set, although it was added second. std::set handles uniqueness.
-                    coveredCellsSet_.insert(boundaryPoints.begin(), boundaryPoints.end());
+                    // --- Step 3: Combine Results (union of interior and boundary spans) ---
+                    coveredSpans_.reserve(interiorSpans_.size() + boundarySpans_.size());
+                    std::merge(interiorSpans_.begin(), interiorSpans_.end(),
+                        boundarySpans_.begin(), boundarySpans_.end(), std::back_inserter(coveredSpans_));
+                    normalizeRowSpans(coveredSpans_);
 
                     // --- Step 4: Excessive Fill Check (Optional but Recommended) ---
-                    // Note: The check condition `coveredCellsSet_.size() > boundaryPoints.size()` might need adjustment
-                    // if scanline fill *perfectly* fills up to but not including the boundary.
-                    // A safer check might be if interiorPoints is not empty.
+                    // Only meaningful if filling actually happened.
                     const double fill_threshold = 0.95; // Example threshold
-                    if (total_grid_cells_ > 0 && !interiorPoints.empty() && // Check if filling actually happened
-                        (double)coveredCellsSet_.size() / total_grid_cells_ > fill_threshold)
+                    const size_t covered_cell_count = countSpanCells(coveredSpans_);
+                    if (total_grid_cells_ > 0 && !interiorSpans_.empty() && // Check if filling actually happened
+                        (double)covered_cell_count / total_grid_cells_ > fill_threshold)
                     {
                         fprintf(stderr, "ERROR: Feature (SymID: %s, Type: %d) scanline fill covered %zu cells (%.1f%% of grid), likely error. DISCARDING FILL, using boundary only (%zu cells).\n",
                             feature_sym_id.c_str(), effective_object_type,
-                            coveredCellsSet_.size(), 100.0 * coveredCellsSet_.size() / total_grid_cells_,
-                            boundaryPoints.size());
-                        coveredCellsSet_ = boundaryPoints; // Revert to boundary only if fill seems excessive
+                            covered_cell_count, 100.0 * covered_cell_count / total_grid_cells_,
+                            countSpanCells(boundarySpans_));
+                        coveredSpans_.swap(boundarySpans_); // Revert to boundary only if fill seems excessive
                     }
                 }
 
-                return coveredCellsSet_;
+                return coveredSpans_;
             }
+
+            /** @brief Total number of cells covered by a list of spans. */
+            static size_t countSpanCells(const std::vector<RowSpan>& spans) {
+                size_t count = 0;
+                for (const auto& span : spans) count += span.length();
+                return count;
+            }
+
         private:
             size_t grid_width_;
             size_t grid_height_;
             size_t total_grid_cells_;
-            std::vector<bool> visited_; // Size matches grid_width_ * grid_height_
-            IntPointSet coveredCellsSet_;
-            //IntPointSet coveredCellsSet_; // Stores the combined result for the current feature
+            // Reused per-feature buffers; their size tracks the feature, not the grid
+            std::vector<IntPoint> boundaryCells_;  // Raw boundary cells (may contain duplicates)
+            std::vector<RowSpan> boundarySpans_;   // Boundary cells as spans
+            std::vector<RowSpan> interiorSpans_;   // Scanline fill output
+            std::vector<RowSpan> coveredSpans_;    // Combined result for the current feature
             const double FP_EPSILON = 1e-9; // Epsilon for floating point checks
 
             inline bool inBounds(int x, int y) const {
@@ -226,8 +225,32 @@ namespace mapgeo {
                 return static_cast<unsigned>(x) < grid_width_ && static_cast<unsigned>(y) < grid_height_;
             }
 
+            /**
+             * @brief Sorts and de-duplicates cells, then collapses horizontal runs into spans.
+             * @param cells Cell buffer (reordered in place).
+             * @param spans Output; cleared first. Sorted and non-overlapping.
+             */
+            static void cellsToSpans(std::vector<IntPoint>& cells, std::vector<RowSpan>& spans) {
+                spans.clear();
+                if (cells.empty()) return;
+                std::sort(cells.begin(), cells.end());
+                cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+
+                RowSpan current{ cells.front().y, cells.front().x, cells.front().x + 1 };
+                for (size_t i = 1; i < cells.size(); ++i) {
+                    const IntPoint& p = cells[i];
+                    if (p.y == current.y && p.x == current.x_end) {
+                        ++current.x_end;
+                    }
+                    else {
+                        spans.push_back(current);
+                        current = { p.y, p.x, p.x + 1 };
+                    }
+                }
+                spans.push_back(current);
+            }
 
-            void drawBoundary(const std::vector<VertexData>& polygon_vd, IntPointSet& boundarySet, int effective_object_type) {
+            void drawBoundary(const std::vector<VertexData>& polygon_vd, std::vector<IntPoint>& boundaryCells, int effective_object_type) {
                 if (polygon_vd.size() < 2 || grid_width_ == 0 || grid_height_ == 0) return; // Check grid dims
 
                 int max_x_idx = static_cast<int>(grid_width_ - 1);
@@ -251,7 +274,7 @@ namespace mapgeo {
                     p2_int.x = std::max(0, std::min(p2_int.x, max_x_idx));
                     p2_int.y = std::max(0, std::min(p2_int.y, max_y_idx));
 
-                    bresenhamLineToSet(p1_int, p2_int, boundarySet);
+                    bresenhamLineToCells(p1_int, p2_int, boundaryCells);
                 }
 
                 // Draw the closing segment ONLY if it's an Area type (1) and has enough points
@@ -270,13 +293,13 @@ namespace mapgeo {
                         p_first_int.y = std::max(0, std::min(p_first_int.y, max_y_idx));
 
 
-                        bresenhamLineToSet(p_last_int, p_first_int, boundarySet); // Connect last to first
+                        bresenhamLineToCells(p_last_int, p_first_int, boundaryCells); // Connect last to first
                     }
                 }
                 
             }
 
-            void bresenhamLineToSet(IntPoint p1, IntPoint p2, IntPointSet& pointSet) {
+            void bresenhamLineToCells(IntPoint p1, IntPoint p2, std::vector<IntPoint>& cells) {
                 int dx = std::abs(p2.x - p1.x), sx = (p1.x < p2.x) ? 1 : -1;
                 int dy = -std::abs(p2.y - p1.y), sy = (p1.y < p2.y) ? 1 : -1;
                 int err = dx + dy;
@@ -284,7 +307,7 @@ namespace mapgeo {
                 while (true) {
                     // inBounds check inside the loop is necessary
                     if (inBounds(p1.x, p1.y)) {
-                        pointSet.insert(p1);
+                        cells.push_back(p1); // Duplicates are removed in cellsToSpans
                     }
                     if (p1.x == p2.x && p1.y == p2.y) break;
 
@@ -302,190 +325,6 @@ namespace mapgeo {
                 }
             }
 
-            // --- NEW Scanline Fill Implementation ---
-    /**
-     * @brief Fills the interior of a polygon (defined by outer and hole boundaries)
-     *        using a scanline algorithm with an Edge Table and Active Edge Table.
-     * @param outer_boundary_vd The vertices defining the outer boundary.
-     * @param hole_boundaries_vd A list of vertex lists defining the holes.
-     * @return An IntPointSet containing the integer coordinates of the filled interior pixels.
-     *         Boundary pixels themselves are NOT included in this set.
-     */
-
-            /* // workin same what
-            IntPointSet scanlineFillInternal(const std::vector<VertexData>& outer_boundary_vd,
-                const std::vector<std::vector<VertexData>>& hole_boundaries_vd, const std::string& feature_sym_id) const
-            {
-                IntPointSet filledInteriorPoints;
-                if (outer_boundary_vd.size() < 3 || grid_width_ == 0 || grid_height_ == 0) {
-                    return filledInteriorPoints; // Cannot fill if outer loop is not at least a triangle or grid invalid
-                }
-                const std::string target_sym_id = "106"; // The ID of the problematic feature
-                const bool enable_logging = (feature_sym_id == target_sym_id);
-                EdgeTable edgeTable;
-                double global_min_y = std::numeric_limits<double>::max();
-                double global_max_y = std::numeric_limits<double>::lowest();
-
-                // --- Lambda to process one loop (outer or hole) and add edges to ET ---
-                auto buildEdgesForLoop = [&](const std::vector<VertexData>& loop_vd) {
-                    if (loop_vd.size() < 2) return; // Need at least 2 points for an edge
-
-                    for (size_t i = 0; i < loop_vd.size(); ++i) {
-                        const VertexData& vd1 = loop_vd[i];
-                        const VertexData& vd2 = loop_vd[(i + 1) % loop_vd.size()]; // Wrap around
-
-                        const Point_float<float>& p1 = vd1.pos;
-                        const Point_float<float>& p2 = vd2.pos;
-
-                        // Skip segments marked as gaps/dashes (relevant for outer loop, less so for holes?)
-                        // Check the *end* point flag of the segment (vd2)
-                        if ((vd2.original_flag & CoordFlags::GapPoint) || (vd2.original_flag & CoordFlags::DashPoint)) {
-                            continue;
-                        }
-
-
-                        // Determine ymin/ymax points and values using double
-                        double y1 = static_cast<double>(p1.y);
-                        double y2 = static_cast<double>(p2.y);
-                        double x1 = static_cast<double>(p1.x);
-                        double x2 = static_cast<double>(p2.x);
-
-                        // Ignore Horizontal Edges for Edge Table
-                        if (std::abs(y1 - y2) < FP_EPSILON) {
-                            continue;
-                        }
-
-                        // Find edge endpoints and min/max y
-                        double ymin, ymax, x_at_ymin;
-                        if (y1 < y2) {
-                            ymin = y1; ymax = y2; x_at_ymin = x1;
-                        }
-                        else {
-                            ymin = y2; ymax = y1; x_at_ymin = x2;
-                        }
-
-                        // Update global y bounds (use vertex coordinates directly)
-                        global_min_y = std::min({ global_min_y, ymin });
-                        global_max_y = std::max({ global_max_y, ymax });
-
-                        // Calculate inverse slope (dx/dy)
-                        double inv_slope;
-                        double dx = x2 - x1;
-                        double dy = y2 - y1; // Already checked dy != 0
-
-                        if (std::abs(dx) < FP_EPSILON) { // Vertical edge
-                            inv_slope = std::numeric_limits<double>::infinity();
-                        }
-                        else {
-                            inv_slope = dx / dy;
-                        }
-
-                        // Determine starting scanline index (use ceil for robustness)
-                        int start_y_index = static_cast<int>(std::ceil(ymin));
-                        // Clip start index to grid bounds just in case float precision pushed it slightly below 0
-                        start_y_index = std::max(0, start_y_index);
-
-                        // Add edge info to the map
-                        // The ymax here defines when the edge should be REMOVED.
-                        // Standard scanline removes when scanline y >= ymax.
-                        edgeTable[start_y_index].emplace_back(ymax, x_at_ymin, inv_slope);
-
-                    } // End loop through segments
-                    }; // End lambda buildEdgesForLoop
-
-
-                // --- Build Edge Table for outer and hole boundaries ---
-                buildEdgesForLoop(outer_boundary_vd);
-                for (const auto& hole_loop : hole_boundaries_vd) {
-                    buildEdgesForLoop(hole_loop); // Treat hole edges exactly the same
-                }
-
-                // --- Scanline Processing ---
-                if (edgeTable.empty()) {
-                    // Likely only horizontal edges, no interior to fill
-                    return filledInteriorPoints;
-                }
-
-                std::vector<EdgeInfo> aet; // Active Edge Table (store structs directly)
-
-                int min_scanline_y = std::max(0, static_cast<int>(std::ceil(global_min_y)));
-                int max_scanline_y = std::min(static_cast<int>(grid_height_ - 1), static_cast<int>(std::floor(global_max_y)));
-                if (max_scanline_y < min_scanline_y) return filledInteriorPoints; // Handle cases where polygon is tiny or outside grid after clamping
-
-
-                for (int y = min_scanline_y; y <= max_scanline_y; ++y) {
-
-                    if (enable_logging) {
-                        fprintf(stderr, "\n--- Scanline y=%d (Feature %s) ---\n", y, feature_sym_id.c_str());
-                        // Log AET before/after sort, fill spans, updates etc.
-                    }
-                        
-
-                    double current_scanline_y_double = static_cast<double>(y);
-
-                    // i. Remove finished edges from AET
-                    // Remove if edge ends *strictly before* this scanline? Or at/before?
-                    // Standard: Remove if ymax <= current_scanline_y. Let's stick to that.
-                    aet.erase(std::remove_if(aet.begin(), aet.end(),
-                        [&](const EdgeInfo& edge) { return edge.ymax <= current_scanline_y_double; }),
-                        aet.end());
-
-                    // ii. Add new edges starting at this scanline from ET
-                    auto et_it = edgeTable.find(y);
-                    if (et_it != edgeTable.end()) {
-                        aet.insert(aet.end(), et_it->second.begin(), et_it->second.end());
-                    }
-
-                    if (aet.empty()) continue; // Nothing to fill on this line if AET empty
-
-                    // iii. Sort AET by current_x
-                    std::sort(aet.begin(), aet.end(), [](const EdgeInfo& a, const EdgeInfo& b) {
-                        // Handle potential exact ties carefully if needed, maybe add secondary sort key?
-                        if (std::abs(a.current_x - b.current_x) < 1e-9) {
-                            // Optional tie-breaker using slope? Can help with vertices touching scanline.
-                            return a.inv_slope < b.inv_slope;
-                        }
-                        return a.current_x < b.current_x;
-                        });
-
-                    // iv. Fill spans using sorted AET (odd/even pairs)
-                    for (size_t i = 0; i + 1 < aet.size(); i += 2) {
-                        double x_start = aet[i].current_x;
-                        double x_end = aet[i + 1].current_x;
-
-                        // Convert float x range to integer pixel range
-                        // Use ceil for start, floor for end to fill pixels whose centers are within the span
-                        int fill_x_min = static_cast<int>(std::ceil(x_start));
-                        int fill_x_max = static_cast<int>(std::floor(x_end));
-
-                        // Ensure max isn't less than min after conversion (can happen for thin vertical slivers)
-                        if (fill_x_min > fill_x_max) continue;
-
-                        // Clip fill range to grid bounds
-                        fill_x_min = std::max(0, fill_x_min);
-                        fill_x_max = std::min(static_cast<int>(grid_width_ - 1), fill_x_max);
-
-
-                        // Fill pixels within the span for the current scanline y
-                        for (int x = fill_x_min; x <= fill_x_max; ++x) {
-                            // No need to check bounds again if fill_x_* are clipped
-                            // The check against boundaryPoints is done *outside* this function now
-                            filledInteriorPoints.insert({ x, y });
-                        }
-                    }
-
-                    // v. Update current_x for next scanline for all edges remaining in AET
-                    for (EdgeInfo& edge : aet) {
-                        // Only update if slope is finite (not a vertical edge)
-                        if (std::isfinite(edge.inv_slope)) {
-                            edge.current_x += edge.inv_slope;
-                        }
-                    }
-                } // End scanline loop y
-
-                return filledInteriorPoints;
-            }*/
-
             // --- Scanline Fill Implementation with Refined AET Removal & Minimal Logging ---
             //IntPointSet scanlineFillInternal(const std::vector<VertexData>& outer_boundary_vd,
             //    const std::vector<std::vector<VertexData>>& hole_boundaries_vd,
@@ -580,12 +419,13 @@ namespace mapgeo {
             //    return filledInteriorPoints;
             //} // End scanlineFillInternal
             
-        IntPointSet scanlineFillInternal(const std::vector<VertexData>& outer_boundary_vd,
-            const std::vector<std::vector<VertexData>>& hole_boundaries_vd) const
+        void scanlineFillInternal(const std::vector<VertexData>& outer_boundary_vd,
+            const std::vector<std::vector<VertexData>>& hole_boundaries_vd,
+            std::vector<RowSpan>& filledInteriorSpans) const
         {
-            IntPointSet filledInteriorPoints;
+            filledInteriorSpans.clear();
             if (outer_boundary_vd.size() < 3 || grid_width_ == 0 || grid_height_ == 0) {
-                return filledInteriorPoints;
+                return;
             }
 
             EdgeTable edgeTable;
@@ -629,13 +469,13 @@ namespace mapgeo {
             buildEdgesForLoop(outer_boundary_vd);
             for (const auto& hole_loop : hole_boundaries_vd) buildEdgesForLoop(hole_loop);
 
-            if (edgeTable.empty()) return filledInteriorPoints;
+            if (edgeTable.empty()) return;
 
             // Scanline Processing
             std::vector<EdgeInfo> aet;
             int min_scanline_y = std::max(0, static_cast<int>(std::ceil(global_min_y)));
             int max_scanline_y = std::min(static_cast<int>(grid_height_ - 1), static_cast<int>(std::floor(global_max_y)));
-            if (max_scanline_y < min_scanline_y) return filledInteriorPoints;
+            if (max_scanline_y < min_scanline_y) return;
 
             for (int y = min_scanline_y; y <= max_scanline_y; ++y) {
                 // Add new edges for scanline y
@@ -670,8 +510,8 @@ namespace mapgeo {
                     if (fill_x_min > fill_x_max) continue;
                     fill_x_min = std::max(0, fill_x_min);
                     fill_x_max = std::min(static_cast<int>(grid_width_ - 1), fill_x_max);
-                    for (int x = fill_x_min; x <= fill_x_max; ++x) {
-                        if (inBounds(x, y)) filledInteriorPoints.insert({ x, y });
+                    if (fill_x_min <= fill_x_max) {
+                        filledInteriorSpans.push_back({ y, fill_x_min, fill_x_max + 1 }); // Half-open span
                     }
                 }
 
@@ -683,57 +523,10 @@ namespace mapgeo {
                 }
             } // End scanline loop y
 
-            return filledInteriorPoints;
+            // Rows are produced in order; merge spans that overlap after clipping
+            normalizeRowSpans(filledInteriorSpans);
         } // End scanlineFillInternal
 
-            IntPoint findInteriorPoint(const std::vector<IntPoint>& polygon) {
-                if (polygon.empty()) return { -1, -1 };
-                if (polygon.size() == 1) return polygon[0];
-
-                long long sum_x = 0, sum_y = 0;
-                size_t count = (polygon.size() > 1 && polygon.front() == polygon.back()) ? polygon.size() - 1 : polygon.size();
-
-                if (count == 0) return { -1,-1 };
-
-                for (size_t i = 0; i < count; ++i) {
-                    sum_x += polygon[i].x;
-                    sum_y += polygon[i].y;
-                }
-                return { static_cast<int>(sum_x / count), static_cast<int>(sum_y / count) };
-            }
-
-            IntPoint findValidFillStart(const std::vector<IntPoint>& polygon, const IntPointSet& boundarySet) {
-                if (polygon.size() < 3 || grid_width_ == 0 || grid_height_ == 0) return { -1, -1 }; // Check grid dims
-
-                IntPoint centroid = findInteriorPoint(polygon);
-                if (centroid.x != -1) {
-                    const int offsets[] = { 0, 0,  1, 0,  -1, 0,  0, 1,  0, -1,  1, 1,  -1, -1,  1, -1,  -1, 1 };
-                    const int num_offsets = sizeof(offsets) / (sizeof(int) * 2);
-                    for (int i = 0; i < num_offsets; ++i) {
-                        IntPoint test_pt = { centroid.x + offsets[i * 2], centroid.y + offsets[i * 2 + 1] };
-                        if (inBounds(test_pt.x, test_pt.y) && boundarySet.find(test_pt) == boundarySet.end()) {
-                            return test_pt;
-                        }
-                    }
-                }
-
-                if (polygon.size() >= 2) { // Should always be true
-                    IntPoint p1 = polygon[0];
-                    IntPoint p2 = polygon[1];
-                    if (p1.x == p2.x && p1.y == p2.y && polygon.size() >= 3) p2 = polygon[2];
-                    int mid_x = p1.x + (p2.x - p1.x) / 2;
-                    int mid_y = p1.y + (p2.y - p1.y) / 2;
-                    const int fallback_offsets[] = { 0, 0,  1, 0,  -1, 0,  0, 1,  0, -1,  1, 1,  -1, -1,  1, -1,  -1, 1 };
-                    const int num_fb_offsets = sizeof(fallback_offsets) / (sizeof(int) * 2);
-                    for (int i = 0; i < num_fb_offsets; ++i) {
-                        IntPoint test_pt = { mid_x + fallback_offsets[i * 2], mid_y + fallback_offsets[i * 2 + 1] };
-                        if (inBounds(test_pt.x, test_pt.y) && boundarySet.find(test_pt) == boundarySet.end()) {
-                            return test_pt;
-                        }
-                    }
-                }
-                return { -1,-1 };
-            }
             // Old floodFill function (commented out)
             //void floodFill(IntPoint start, const IntPointSet& boundaryPoints) {
             //    if (!inBounds(start.x, start.y) || grid_width_ == 0 || grid_height_ == 0) return; // Check grid dims
@@ -806,6 +599,80 @@ namespace mapgeo {
             return flags;
         }
 
+        /**
+         * @brief Applies the Pass 2 feature rules to one covered grid cell.
+         *        The result depends on the order features are applied in, so callers
+         *        that need a reproducible grid must apply features in input order.
+         */
+        void applyPass2Rules(GridCellData& gridCell, const FinalFeatureData& feature) {
+            const float MIN_PASSABLE_VALUE = 0.01f;
+            const float BACKGROUND_VALUE = 1.0f;
+            const bool is_multiplicative = (feature.specific_flags & (GridFlags::FLAG_UNDERGROWTH | GridFlags::FLAG_WATER_MARSH)) != 0;
+            const float feature_value = feature.value;
+            const uint8_t feature_flags = feature.specific_flags;
+            const bool feature_is_impassable = (feature_value <= 0.0f || (feature_flags & GridFlags::FLAG_IMPASSABLE));
+
+            // Rule 1: If the FEATURE is impassable, make the grid cell impassable.
+            if (feature_is_impassable) {
+                gridCell.value = -1.0f; // Standard impassable value
+                gridCell.flags |= (GridFlags::FLAG_IMPASSABLE | feature_flags); // OR flags
+                return; // Skip other rules for this cell
+            }
+
+            // Rule 2: If the grid cell is ALREADY impassable, don't change its value, just OR flags.
+            if (gridCell.value <= 0.0f || gridCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) {
+                gridCell.flags |= feature_flags; // Only OR flags
+                return; // Skip other rules for this cell
+            }
+
+            // Rule 3 & 4: Apply feature value based on type (Multiplicative vs. Overwrite)
+            if (is_multiplicative) {
+                // Apply multiplicative cost only if grid cell is not impassable
+                if (approx_equal_float(gridCell.value, BACKGROUND_VALUE)) {
+                    // If cell is background, set to feature value directly
+                    gridCell.value = feature_value;
+                }
+                else {
+                    // Otherwise, multiply existing cost by feature cost
+                    // Avoid multiplying by zero or negative; ensure minimum passable value
+                    if (feature_value > 0) {
+                        gridCell.value *= feature_value;
+                    }
+                    else {
+                        // If multiplicative feature has invalid value, maybe just set to min passable?
+                        gridCell.value = MIN_PASSABLE_VALUE;
+                    }
+                }
+                // Clamp to minimum positive value if it became zero or negative through multiplication
+                gridCell.value = std::max(MIN_PASSABLE_VALUE, gridCell.value);
+            }
+            else {
+                // Apply overwrite cost (non-multiplicative)
+                // Only overwrite if the cell is currently background (1.0)
+                // This preserves values from potentially more important features applied earlier (like boundaries from Pass 1)
+                // Or values from other overlapping features (order is only guaranteed in tile-binned mode)
+                if (approx_equal_float(gridCell.value, BACKGROUND_VALUE) && !approx_equal_float(feature_value, BACKGROUND_VALUE)) {
+                    gridCell.value = feature_value;
+                }
+                // Ensure value is at least the minimum passable if it wasn't background
+                gridCell.value = std::max(MIN_PASSABLE_VALUE, gridCell.value);
+            }
+
+            // Rule 5: Always OR the specific flags from the feature onto the cell.
+            gridCell.flags |= feature_flags;
+        }
+
+        /** @brief Applies the Pass 2 rules to every cell of a row span (clipped to the grid). */
+        void applyPass2RulesToSpan(Grid_V3& grid, const RowSpan& span, const FinalFeatureData& feature) {
+            if (span.y < 0 || static_cast<size_t>(span.y) >= grid.height()) return;
+            const int x_begin = std::max(0, span.x_begin);
+            const int x_end = std::min(static_cast<int>(grid.width()), span.x_end);
+            GridCellData* row = grid.data().data() + static_cast<size_t>(span.y) * grid.width();
+            for (int x = x_begin; x < x_end; ++x) {
+                applyPass2Rules(row[x], feature);
+            }
+        }
+
     } // End anonymous namespace
 
     // =================== MapProcessor Method Implementations ===================
@@ -1198,10 +1065,39 @@ namespace mapgeo {
             return;
         }
 
-        const float MIN_PASSABLE_VALUE = 0.01f;
-        const float BACKGROUND_VALUE = 1.0f;
         const size_t num_features = features.size();
 
+        if (config_.use_tile_binned_merge) {
+            // --- Tile-binned merge: each tile owned by one thread, features applied in input order ---
+            const TileLayout layout(grid.width(), grid.height(), static_cast<std::size_t>(std::max(0, config_.merge_tile_size)));
+            std::vector<MinimalRasterizer> rasterizers;
+            rasterizers.reserve(static_cast<std::size_t>(omp_get_max_threads()));
+            for (int t = 0; t < omp_get_max_threads(); ++t) {
+                rasterizers.emplace_back(grid.width(), grid.height());
+            }
+
+            runTileBinnedMerge<RowSpan>(layout, num_features,
+                [&](std::size_t feature_idx, std::vector<RowSpan>& outSpans) {
+                    const auto& feature = features[feature_idx];
+                    int effective_object_type = determineEffectiveObjectType(feature.object_type, feature.specific_flags);
+                    // Full (unclipped) rasterization keeps the excessive-fill check identical to serial mode
+                    outSpans = rasterizers[omp_get_thread_num()].getCoveredCells(
+                        feature.outer_boundary,
+                        feature.hole_boundaries,
+                        effective_object_type,
+                        feature.original_symbol_id
+                    );
+                },
+                [&](std::size_t feature_idx, const RowSpan* first, const RowSpan* last) {
+                    const auto& feature = features[feature_idx];
+                    for (const RowSpan* span = first; span != last; ++span) {
+                        applyPass2RulesToSpan(grid, *span, feature);
+                    }
+                });
+            std::cout << "Info: Pass 2 complete (tile-binned merge, " << layout.tileCount() << " tiles).\n";
+            return;
+        }
+
 #pragma omp parallel // Start parallel region
         {
             // --- Thread-Local Rasterizer ---
@@ -1220,19 +1116,18 @@ namespace mapgeo {
                 //if ((feature.specific_flags & GridFlags::FLAG_ROAD_PATH) != 0 && effective_object_type == 1) {
                 //    effective_object_type = 2; // Example: Treat area roads like lines for rule application? Adjust if needed.
                 //}
-                bool is_multiplicative = (feature.specific_flags & (GridFlags::FLAG_UNDERGROWTH | GridFlags::FLAG_WATER_MARSH)) != 0;
                 uint8_t feature_flags = feature.specific_flags;
                 int effective_object_type = determineEffectiveObjectType(feature.object_type, feature_flags);
 
                 // This call uses the thread-local rasterizer's state
-                auto coveredCells = rasterizer.getCoveredCells(
+                const std::vector<RowSpan>& coveredSpans = rasterizer.getCoveredCells(
                     feature.outer_boundary,
                     feature.hole_boundaries,
                     effective_object_type,
                     feature.original_symbol_id // Pass symbol ID for potential debug messages inside rasterizer
                 );
 
-                if (coveredCells.empty()) {
+                if (coveredSpans.empty()) {
                     continue; // Skip grid update if this feature covers no cells
                 }
 
@@ -1241,68 +1136,10 @@ namespace mapgeo {
                 // on the shared 'grid' object.
 #pragma omp critical (GridUpdatePass2)
                 {
-                    const bool is_multiplicative = (feature.specific_flags & (GridFlags::FLAG_UNDERGROWTH | GridFlags::FLAG_WATER_MARSH)) != 0;
-                    const float feature_value = feature.value;
-                    const uint8_t feature_flags = feature.specific_flags;
-                    const bool feature_is_impassable = (feature_value <= 0.0f || (feature_flags & GridFlags::FLAG_IMPASSABLE));
-
-                    // Apply rules to each covered cell for this feature
-                    for (const auto& p : coveredCells) {
-                        // Bounds check (should be redundant if rasterizer is correct, but safe)
-                        if (!grid.inBounds(p.x, p.y)) continue;
-
-                        GridCellData& gridCell = grid.at(p.x, p.y);
-
-                        // Rule 1: If the FEATURE is impassable, make the grid cell impassable.
-                        if (feature_is_impassable) {
-                            gridCell.value = -1.0f; // Standard impassable value
-                            gridCell.flags |= (GridFlags::FLAG_IMPASSABLE | feature_flags); // OR flags
-                            continue; // Skip other rules for this cell
-                        }
-
-                        // Rule 2: If the grid cell is ALREADY impassable, don't change its value, just OR flags.
-                        if (gridCell.value <= 0.0f || gridCell.hasFlag(GridFlags::FLAG_IMPASSABLE)) {
-                            gridCell.flags |= feature_flags; // Only OR flags
-                            continue; // Skip other rules for this cell
-                        }
-
-                        // Rule 3 & 4: Apply feature value based on type (Multiplicative vs. Overwrite)
-                        if (is_multiplicative) {
-                            // Apply multiplicative cost only if grid cell is not impassable
-                            if (approx_equal_float(gridCell.value, BACKGROUND_VALUE)) {
-                                // If cell is background, set to feature value directly
-                                gridCell.value = feature_value;
-                            }
-                            else {
-                                // Otherwise, multiply existing cost by feature cost
-                                // Avoid multiplying by zero or negative; ensure minimum passable value
-                                if (feature_value > 0) {
-                                    gridCell.value *= feature_value;
-                                }
-                                else {
-                                    // If multiplicative feature has invalid value, maybe just set to min passable?
-                                    gridCell.value = MIN_PASSABLE_VALUE;
-                                }
-                            }
-                            // Clamp to minimum positive value if it became zero or negative through multiplication
-                            gridCell.value = std::max(MIN_PASSABLE_VALUE, gridCell.value);
-                        }
-                        else {
-                            // Apply overwrite cost (non-multiplicative)
-                            // Only overwrite if the cell is currently background (1.0)
-                            // This preserves values from potentially more important features applied earlier (like boundaries from Pass 1)
-                            // Or values from other overlapping features (though order is less defined now)
-                            if (approx_equal_float(gridCell.value, BACKGROUND_VALUE) && !approx_equal_float(feature_value, BACKGROUND_VALUE)) {
-                                gridCell.value = feature_value;
-                            }
-                            // Ensure value is at least the minimum passable if it wasn't background
-                            gridCell.value = std::max(MIN_PASSABLE_VALUE, gridCell.value);
-                        }
-
-                        // Rule 5: Always OR the specific flags from the feature onto the cell.
-                        gridCell.flags |= feature_flags;
-
-                    } // End loop through coveredCells
+                    // Apply rules to each covered span for this feature
+                    for (const auto& span : coveredSpans) {
+                        applyPass2RulesToSpan(grid, span, feature);
+                    } // End loop through coveredSpans
                 } // End critical section for grid update
             } // End parallel for loop over features
         } // End parallel region
@@ -1325,7 +1162,7 @@ namespace mapgeo {
         auto processorValueInputList = preparePass1InputInternal(featuresForRasterization);
         Grid_V3 pathfindingGrid(config_.grid_width, config_.grid_height);
         if (!pathfindingGrid.isValid()) { std::cerr << "Error: Failed to create valid grid.\n"; return std::nullopt; } // Check grid creation
-        ParallelPolygonProcessorFlags pass1_processor;
+        ParallelPolygonProcessorFlags pass1_processor(config_.use_tile_binned_merge ? static_cast<std::size_t>(std::max(1, config_.merge_tile_size)) : 0);
         // std::cout << "\nInfo: Starting Pass 1...\n";
         pass1_processor.process(pathfindingGrid, processorValueInputList);
         // std::cout << "Info: Pass 1 complete.\n";
@@ -4,6 +4,7 @@
  */
 #include "map/ParallelProcessorFlags.hpp" // Corresponding header
 #include "map/MapProcessingCommon.h"    // For Grid_V3, Point_float etc.
+#include "map/TileBinning.hpp"          // For the tile-binned merge mode
 
 #include <vector>
 #include <cmath>
@@ -26,12 +27,6 @@ namespace mapgeo {
             float impassable_boundary_value = -1.0f;        // Value to set for impassable boundaries
             float background_value = 1.0f;                // Default background grid value
             GridFlags boundary_flags = FLAG_BOUNDARY;     // Flag to set on boundary cells
-            GridCellData background_cell_template;        // Template cell for resetting temp grids
-
-            FillerConfig() {
-                background_cell_template.value = background_value;
-                background_cell_template.flags = FLAG_NONE;
-            }
 
             /** @brief Validates that configuration values are finite numbers. */
             bool validate() const {
@@ -41,8 +36,11 @@ namespace mapgeo {
 
         /**
          * @class BoundaryOnlyRasterizer
-         * @brief Rasterizes only the boundary lines of polygons/lines onto a grid.
+         * @brief Rasterizes only the boundary lines of polygons/lines into a cell buffer.
          *        Used internally by ParallelPolygonProcessorFlags during Pass 1.
+         *        Holds no grid-sized state: each feature produces a list of touched cells
+         *        plus a single boundary value, so the cost is proportional to the boundary
+         *        length rather than the grid area.
          *        Does *not* handle flags like GapPoint/DashPoint or perform filling.
          * @tparam CoordType The floating-point type for input vertex coordinates (default float).
          */
@@ -62,64 +60,72 @@ namespace mapgeo {
                     throw std::invalid_argument("Invalid filler config for BoundaryOnlyRasterizer");
                 }
                 // Pre-allocate some space assuming boundary won't exceed perimeter roughly
-                modifiedCells_.reserve(grid_width + grid_height);
+                boundaryCells_.reserve(grid_width + grid_height);
             }
 
             /** @brief Sets the value to apply to boundary cells for the current feature. */
             void setFeatureValue(float value) {
-                // Ensure the value is valid; default to 0.0f if not (though should be caught later).
-                feature_value_ = std::isfinite(value) ? value : -1.0f; // Default to impassable if value is bad
+                // Ensure the value is valid; default to impassable if not (though should be caught later).
+                feature_value_ = std::isfinite(value) ? value : -1.0f;
             }
 
+            /**
+             * @brief Gets the value every cell emitted for the current feature carries.
+             *        Impassable features are standardized to the configured impassable value.
+             */
+            float boundaryValue() const {
+                return (feature_value_ <= 0.0f) ? config_.impassable_boundary_value : feature_value_;
+            }
 
             /**
-             * @brief Draws the boundary of the given polygon onto the temporary grid.
-             * @param tempGrid The grid to draw onto (typically a thread-local temporary grid).
+             * @brief Rasterizes the boundary of the given polygon into the thread-local cell buffer.
              * @param polygon_vertices The normalized vertices of the polygon/line boundary.
-             * @return A vector of integer grid points that were modified by this operation.
+             * @param effective_object_type 0=Point, 1=Area (closed loop), 2=Line (open).
+             * @return The grid cells covered by the boundary. Consecutive duplicates (shared segment
+             *         endpoints) are dropped; a cell revisited later in the same feature may appear
+             *         twice, which is harmless because the merge rules are idempotent per value.
              */
-            const std::vector<IntPoint>& processBoundary(Grid_V3& tempGrid, const std::vector<Point_float<CoordType>>& polygon_vertices, int effective_object_type) {
-                modifiedCells_.clear(); // Clear results from previous feature
+            const std::vector<IntPoint>& processBoundary(const std::vector<Point_float<CoordType>>& polygon_vertices, int effective_object_type) {
+                boundaryCells_.clear(); // Clear results from previous feature
                 if (polygon_vertices.size() < 2) {
-                    return modifiedCells_; // Need at least two points for a line
+                    return boundaryCells_; // Need at least two points for a line
                 }
 
                 // Convert float vertices to integer grid points, removing duplicates
-                auto grid_poly = convertToIntPoints(polygon_vertices);
+                convertToIntPoints(polygon_vertices);
 
-                if (grid_poly.size() >= 2) {
-                    //drawPolygonEdges(tempGrid, grid_poly);
-                    drawPolygonEdges(tempGrid, grid_poly, effective_object_type);
+                if (gridPoly_.size() >= 2) {
+                    drawPolygonEdges(gridPoly_, effective_object_type);
                 }
-                return modifiedCells_;
+                return boundaryCells_;
             }
 
         private:
             const FillerConfig& config_;        // Rasterizer configuration
             std::size_t grid_width_;            // Target grid width
             std::size_t grid_height_;           // Target grid height
-            std::vector<IntPoint> modifiedCells_; // Stores grid cells modified in the last call
+            std::vector<IntPoint> boundaryCells_; // Cells emitted for the last processed feature
+            std::vector<IntPoint> gridPoly_;    // Reused integer vertex buffer
             float feature_value_ = 1.0f;      // Value to apply for the current feature
 
             /** @brief Checks if integer coordinates (x, y) are within the grid bounds. */
             inline bool inBounds(int x, int y) const {
-                return static_cast<unsigned>(x) < grid_width_ && static_cast<unsigned>(y) < grid_height_; // Use grid_height_
+                return static_cast<unsigned>(x) < grid_width_ && static_cast<unsigned>(y) < grid_height_;
             }
 
 
             /**
              * @brief Converts floating-point vertices to integer grid coordinates, clamping to bounds
-             *        and removing consecutive duplicate points.
+             *        and removing consecutive duplicate points. Result is stored in gridPoly_.
              * @param poly The input vector of normalized floating-point vertices.
-             * @return A vector of integer grid points.
              */
-            std::vector<IntPoint> convertToIntPoints(const std::vector<Point_float<CoordType>>& poly) const {
-                std::vector<IntPoint> result;
-                if (poly.empty()) return result;
+            void convertToIntPoints(const std::vector<Point_float<CoordType>>& poly) {
+                gridPoly_.clear();
+                if (poly.empty()) return;
 
-                result.reserve(poly.size());
+                gridPoly_.reserve(poly.size());
                 int max_x_idx = static_cast<int>(grid_width_ - 1);
-                int max_y_idx = static_cast<int>(grid_height_ - 1); // Use grid_height_
+                int max_y_idx = static_cast<int>(grid_height_ - 1);
                 if (max_x_idx < 0) max_x_idx = 0; // Handle 1-cell wide grid case
                 if (max_y_idx < 0) max_y_idx = 0; // Handle 1-cell high grid case
 
@@ -133,62 +139,46 @@ namespace mapgeo {
                     iy = std::max(0, std::min(iy, max_y_idx));
 
                     // Add the point only if it's different from the last one added
-                    if (result.empty() || !(result.back().x == ix && result.back().y == iy)) {
-                        result.push_back({ ix, iy });
+                    if (gridPoly_.empty() || !(gridPoly_.back().x == ix && gridPoly_.back().y == iy)) {
+                        gridPoly_.push_back({ ix, iy });
                     }
                 }
-                return result;
             }
 
             /**
-             * @brief Draws all edges of a polygon (represented by integer points) onto the grid.
-             *        Connects the last point back to the first.
-             * @param grid The grid to draw onto.
+             * @brief Draws all edges of a polygon (represented by integer points) into the cell buffer.
+             *        Connects the last point back to the first for closed areas.
              * @param polygon The vertices of the polygon as integer points.
              */
-            void drawPolygonEdges(Grid_V3& grid, const std::vector<IntPoint>& polygon, int effective_object_type) {
+            void drawPolygonEdges(const std::vector<IntPoint>& polygon, int effective_object_type) {
                 if (polygon.size() < 2) return;
                 for (std::size_t i = 0; i < polygon.size() - 1; ++i) {
-                    bresenhamLine(grid, polygon[i], polygon[i + 1]);
+                    bresenhamLine(polygon[i], polygon[i + 1]);
                 }
 
                 // Draw the closing segment ONLY if it's an Area type (1) and has enough points
                 bool close_loop = (effective_object_type == 1 && polygon.size() >= 3);
                 if (close_loop) {
-                    bresenhamLine(grid, polygon.back(), polygon.front()); // Connect last to first
+                    bresenhamLine(polygon.back(), polygon.front()); // Connect last to first
                 }
             }
 
             /**
-             * @brief Draws a line segment between two integer points using Bresenham's line algorithm.
-             *        Sets the grid cell value and boundary flag for each point on the line.
-             * @param grid The grid to modify.
+             * @brief Walks a line segment between two integer points using Bresenham's line algorithm
+             *        and appends every in-bounds cell to the buffer.
              * @param p1 Starting point of the line.
              * @param p2 Ending point of the line.
              */
-            void bresenhamLine(Grid_V3& grid, IntPoint p1, IntPoint p2) {
+            void bresenhamLine(IntPoint p1, IntPoint p2) {
                 int dx = std::abs(p2.x - p1.x), sx = (p1.x < p2.x) ? 1 : -1;
                 int dy = -std::abs(p2.y - p1.y), sy = (p1.y < p2.y) ? 1 : -1;
                 int err = dx + dy; // error value e_xy
 
                 while (true) {
                     if (inBounds(p1.x, p1.y)) {
-                        GridCellData& cell = grid.at(p1.x, p1.y);
-                        float value_to_set;
-
-                        // Determine the value: impassable takes priority
-                        if (feature_value_ <= 0.0f) { // Feature itself is impassable (or invalid)
-                            value_to_set = config_.impassable_boundary_value; // Should be -1.0f
-                        }
-                        else {
-                            value_to_set = feature_value_; // Use the feature's base terrain cost
-                        }
-
-                        // Update cell only if value or flag changes (optimization)
-                        if (!approx_equal_float(cell.value, value_to_set) || !cell.hasFlag(config_.boundary_flags)) {
-                            cell.value = value_to_set;
-                            cell.flags = config_.boundary_flags; // ONLY set boundary flag in Pass 1
-                            modifiedCells_.push_back({ p1.x, p1.y }); // Record modification
+                        // Segment endpoints are shared by consecutive segments; skip the repeat
+                        if (boundaryCells_.empty() || !(boundaryCells_.back() == p1)) {
+                            boundaryCells_.push_back(p1);
                         }
                     }
 
@@ -209,6 +199,39 @@ namespace mapgeo {
             }
         }; // End class BoundaryOnlyRasterizer
 
+        /**
+         * @brief Merges one boundary cell of a feature into the final grid cell.
+         *        Impassable boundaries always win, impassable cells keep their value,
+         *        otherwise the value with the larger magnitude (or any value over background) is kept.
+         * @param final_cell The shared grid cell to update.
+         * @param boundary_value The value carried by the feature's boundary (see boundaryValue()).
+         * @param config Pass 1 configuration.
+         */
+        inline void mergeBoundaryCell(GridCellData& final_cell, float boundary_value, const FillerConfig& config) {
+            // Rule 1: Impassable boundaries always overwrite final grid
+            if (boundary_value <= 0.0f) {
+                final_cell.value = config.impassable_boundary_value; // Standardize to -1.0f
+                final_cell.setFlag(config.boundary_flags);
+                return;
+            }
+
+            // Rule 2: If final grid cell is already impassable, don't change value
+            if (final_cell.value <= 0.0f) {
+                final_cell.setFlag(config.boundary_flags);
+                return;
+            }
+
+            // Rule 3: Apply boundary value if final is background OR boundary value has larger magnitude
+            if (approx_equal_float(final_cell.value, config.background_value) ||
+                std::fabs(boundary_value) > std::fabs(final_cell.value))
+            {
+                final_cell.value = boundary_value;
+            }
+
+            // Rule 4: Always set the boundary flag on cells touched by a boundary
+            final_cell.setFlag(config.boundary_flags);
+        }
+
     } // anonymous namespace
 
     // --- Public Method Implementation ---
@@ -224,89 +247,81 @@ namespace mapgeo {
 
         const FillerConfig config; // Use default config for Pass 1
 
-        // Filter out invalid polygons (less than 2 vertices) beforehand
-        std::vector<PolygonInputData> validPolygonData;
-        validPolygonData.reserve(polygonDataList.size());
-        for (const auto& data : polygonDataList) {
-            if (data.polygon_vertices.size() >= 2) {
-                validPolygonData.push_back(data);
+        // Collect indices of valid polygons (at least 2 vertices) instead of copying their vertex data
+        std::vector<std::size_t> validPolygonIndices;
+        validPolygonIndices.reserve(polygonDataList.size());
+        for (std::size_t i = 0; i < polygonDataList.size(); ++i) {
+            if (polygonDataList[i].polygon_vertices.size() >= 2) {
+                validPolygonIndices.push_back(i);
             }
         }
 
-        const std::size_t num_valid_polygons = validPolygonData.size();
+        const std::size_t num_valid_polygons = validPolygonIndices.size();
         if (num_valid_polygons == 0) {
             std::cout << "Info (ParallelProcessorFlags): No valid lines/polygons (>= 2 vertices) found for Pass 1 processing." << std::endl;
             return;
         }
 
-        // Start parallel region
+        if (merge_tile_size_ > 0) {
+            // --- Tile-binned merge: deterministic, no shared-grid locking ---
+            const TileLayout layout(grid_width, grid_height, merge_tile_size_);
+            std::vector<BoundaryOnlyRasterizer<float>> rasterizers;
+            rasterizers.reserve(static_cast<std::size_t>(omp_get_max_threads()));
+            for (int t = 0; t < omp_get_max_threads(); ++t) {
+                rasterizers.emplace_back(config, grid_width, grid_height);
+            }
+            std::vector<float> boundaryValues(num_valid_polygons);
+
+            runTileBinnedMerge<IntPoint>(layout, num_valid_polygons,
+                [&](std::size_t i, std::vector<IntPoint>& outCells) {
+                    const auto& polyData = polygonDataList[validPolygonIndices[i]];
+                    auto& rasterizer = rasterizers[omp_get_thread_num()];
+                    rasterizer.setFeatureValue(polyData.replacement_value);
+                    outCells = rasterizer.processBoundary(polyData.polygon_vertices, polyData.effective_object_type);
+                    boundaryValues[i] = rasterizer.boundaryValue();
+                },
+                [&](std::size_t i, const IntPoint* first, const IntPoint* last) {
+                    const float boundary_value = boundaryValues[i];
+                    for (const IntPoint* p = first; p != last; ++p) {
+                        mergeBoundaryCell(finalGrid.at(p->x, p->y), boundary_value, config);
+                    }
+                });
+        }
+        else {
+            // Start parallel region
 #pragma omp parallel
-        {
-            // Thread-local resources: each thread gets its own temporary grid and rasterizer
-            Grid_V3 tempGrid(grid_width, grid_height, config.background_cell_template);
-            BoundaryOnlyRasterizer<float> boundary_rasterizer(config, grid_width, grid_height);
+            {
+                // Thread-local resources: only the rasterizer and its cell buffer, no grid-sized state
+                BoundaryOnlyRasterizer<float> boundary_rasterizer(config, grid_width, grid_height);
 
-            // Distribute polygon processing among threads
-            // dynamic schedule useful if polygons have vastly different vertex counts
+                // Distribute polygon processing among threads
+                // dynamic schedule useful if polygons have vastly different vertex counts
 #pragma omp for schedule(dynamic)
-            for (long long i = 0; i < static_cast<long long>(num_valid_polygons); ++i) {
-                const auto& polyData = validPolygonData[i];
-
-                // Reset temp grid for the current polygon (optional, could reuse but reset is safer)
-                tempGrid.reset(config.background_cell_template);
+                for (long long i = 0; i < static_cast<long long>(num_valid_polygons); ++i) {
+                    const auto& polyData = polygonDataList[validPolygonIndices[i]];
 
-                // Set the value this feature will draw
-                boundary_rasterizer.setFeatureValue(polyData.replacement_value);
+                    // Set the value this feature will draw
+                    boundary_rasterizer.setFeatureValue(polyData.replacement_value);
 
-                // Draw the boundary onto the thread-local temporary grid
-                const std::vector<IntPoint>& modifiedBoundaryCoords = boundary_rasterizer.processBoundary(
-                    tempGrid,
-                    polyData.polygon_vertices,
-                    polyData.effective_object_type // <-- Pass the type here
-                );
+                    // Rasterize the boundary into the thread-local cell buffer
+                    const std::vector<IntPoint>& boundaryCells = boundary_rasterizer.processBoundary(
+                        polyData.polygon_vertices,
+                        polyData.effective_object_type
+                    );
+                    const float boundary_value = boundary_rasterizer.boundaryValue();
 
-                // --- Critical Section: Merge results onto the shared final grid ---
-                // Only one thread can execute this block at a time to prevent race conditions
+                    // --- Critical Section: Merge results onto the shared final grid ---
+                    // Only one thread can execute this block at a time to prevent race conditions
 #pragma omp critical (FinalGridUpdate)
-                {
-                    for (const auto& p : modifiedBoundaryCoords) {
-                        // Double-check bounds just in case (should be guaranteed by rasterizer)
-                        if (finalGrid.inBounds(p.x, p.y)) {
-                            const GridCellData& temp_cell = tempGrid.at(p.x, p.y); // Cell from thread's rasterization
-                            GridCellData& final_cell = finalGrid.at(p.x, p.y);   // Corresponding cell in the shared grid
-
-                            bool temp_is_impassable = temp_cell.value <= 0.0f; // Use <= 0 as impassable marker
-                            bool final_is_impassable = final_cell.value <= 0.0f;
-
-                            // Rule 1: Impassable boundaries from temp grid always overwrite final grid
-                            if (temp_is_impassable) {
-                                final_cell.value = config.impassable_boundary_value; // Standardize to -1.0f
-                                final_cell.setFlag(config.boundary_flags); // Ensure flag is set
-                                continue; // Skip other rules
-                            }
-
-                            // Rule 2: If final grid cell is already impassable, don't change value
-                            if (final_is_impassable) {
-                                final_cell.setFlag(config.boundary_flags); // Still set flag if temp wasn't impassable
-                                continue; // Skip other rules
-                            }
-
-                            // Rule 3: Apply temp value if final is background OR temp value has larger magnitude
-                            // Compare absolute values, ignore sign (since both are positive here)
-                            if (approx_equal_float(final_cell.value, config.background_value) ||
-                                std::fabs(temp_cell.value) > std::fabs(final_cell.value))
-                            {
-                                final_cell.value = temp_cell.value;
-                            }
-
-                            // Rule 4: Always set the boundary flag if we modified this cell in temp grid
-                            final_cell.setFlag(config.boundary_flags);
+                    {
+                        for (const auto& p : boundaryCells) {
+                            mergeBoundaryCell(finalGrid.at(p.x, p.y), boundary_value, config);
                         }
-                    } // End loop through modified coordinates
-                } // End critical section
-            } // End parallel for loop
-        } // End parallel region
+                    } // End critical section
+                } // End parallel for loop
+            } // End parallel region
+        }
 
     } // End ParallelPolygonProcessorFlags::process
 
-} // namespace mapgeo
\ No newline at end of file
+} // namespace mapgeo
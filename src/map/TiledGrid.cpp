@@ -0,0 +1,43 @@
+// File: TiledGrid.cpp
+
+#include "map/TiledGrid.hpp"
+
+namespace mapgeo {
+
+    TiledGrid TiledGrid::build(const CompactGrid& compact, const ElevationRaster* elevation) {
+        TiledGrid tiled;
+        if (!compact.isValid() || !compact.isNarrow()) { return tiled; }
+        const CompactGridView source = compact.view();
+        tiled.layout_ = TiledLayout(source.width, source.height);
+
+        // Padding cells lie outside the grid and are never read (the kernels bounds-check (x, y) first)
+        tiled.codes_ = toTiledOrder<std::uint8_t>(source.codes, tiled.layout_, 0);
+        tiled.terrain_.assign(source.terrain, source.terrain + CompactGrid::NARROW_PALETTE_LIMIT);
+        if (elevation != nullptr && elevation->isValid() &&
+            elevation->width() == compact.width() && elevation->height() == compact.height()) {
+            if (elevation->isConstant()) {
+                tiled.elevation_ = elevation->values();
+                tiled.elevation_mask_ = 0;
+            }
+            else {
+                tiled.elevation_ = toTiledOrder<float>(elevation->values().data(), tiled.layout_, 0.0f);
+            }
+        }
+        return tiled;
+    }
+
+    std::size_t TiledGrid::memoryBytes() const {
+        return codes_.capacity() * sizeof(std::uint8_t) + terrain_.capacity() * sizeof(float) + elevation_.capacity() * sizeof(float);
+    }
+
+    TiledGridView TiledGrid::view() const {
+        TiledGridView view;
+        view.layout = layout_;
+        view.codes = codes_.data();
+        view.terrain = terrain_.data();
+        view.elevation = elevation_.empty() ? nullptr : elevation_.data();
+        view.elevation_mask = elevation_mask_;
+        return view;
+    }
+
+} // namespace mapgeo
@@ -0,0 +1,91 @@
+// File: BoundaryRasterBenchmark.cpp
+//
+// Pass 1 (ParallelPolygonProcessorFlags) on a fixed 4096x4096 grid with one closed square boundary of
+// growing length, in both merge modes. Prints the time per boundary cell; the cost must follow the
+// boundary length, not the grid area.
+//
+// Fails (exit code 1) if a boundary is not rasterized to exactly its cells, or if the shortest boundary
+// takes longer than a single pass over the grid (a sign of per-feature grid-sized work).
+
+#include "map/ParallelProcessorFlags.hpp"
+#include "map/MapProcessingCommon.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+using namespace mapgeo;
+
+namespace {
+
+    constexpr std::size_t GRID_SIZE = 4096;
+    constexpr int REPEATS = 5;
+
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Closed square of side cells (corners at cell centres), centred on the grid
+    std::vector<PolygonInputData> squareFeature(int side) {
+        const float lo = static_cast<float>(GRID_SIZE / 2 - static_cast<std::size_t>(side) / 2) + 0.5f;
+        const float hi = lo + static_cast<float>(side - 1);
+        std::vector<Point_float<float>> vertices = { { lo, lo }, { hi, lo }, { hi, hi }, { lo, hi } };
+        return { PolygonInputData(std::move(vertices), 2.0f, 1) };
+    }
+
+    std::size_t countBoundaryCells(const Grid_V3& grid) {
+        std::size_t count = 0;
+        for (const GridCellData& cell : grid.data()) {
+            if (cell.hasFlag(GridFlags::FLAG_BOUNDARY)) { ++count; }
+        }
+        return count;
+    }
+
+} // end anonymous namespace
+
+int main() {
+    Grid_V3 grid(GRID_SIZE, GRID_SIZE);
+
+    // Reference: one read pass over every cell of the grid
+    double sweep_ms = 1e300;
+    for (int r = 0; r < REPEATS; ++r) {
+        const auto start = std::chrono::steady_clock::now();
+        const std::size_t touched = countBoundaryCells(grid);
+        sweep_ms = std::min(sweep_ms, elapsedMs(start));
+        if (touched != 0) { return 1; }
+    }
+    std::printf("Grid %zux%zu, one pass over all cells: %.3f ms\n\n", GRID_SIZE, GRID_SIZE, sweep_ms);
+    std::printf("%-10s %12s %12s %12s\n", "merge", "boundary", "ms", "ns/cell");
+
+    bool ok = true;
+    const int sides[] = { 16, 64, 256, 1024, 4000 };
+    for (const std::size_t merge_tile_size : { std::size_t(0), std::size_t(256) }) {
+        const ParallelPolygonProcessorFlags processor(merge_tile_size);
+        for (const int side : sides) {
+            const std::vector<PolygonInputData> features = squareFeature(side);
+            const std::size_t expected_cells = 4 * static_cast<std::size_t>(side - 1);
+            double best_ms = 1e300;
+            for (int r = 0; r < REPEATS; ++r) {
+                grid = Grid_V3(GRID_SIZE, GRID_SIZE);
+                const auto start = std::chrono::steady_clock::now();
+                processor.process(grid, features);
+                best_ms = std::min(best_ms, elapsedMs(start));
+            }
+
+            const std::size_t cells = countBoundaryCells(grid);
+            std::printf("%-10s %12zu %12.4f %12.2f\n", merge_tile_size > 0 ? "tiles" : "critical", cells, best_ms,
+                best_ms * 1.0e6 / static_cast<double>(std::max<std::size_t>(cells, 1)));
+            if (cells != expected_cells) {
+                std::printf("  FAIL: expected %zu boundary cells\n", expected_cells);
+                ok = false;
+            }
+            if (side == sides[0] && best_ms > sweep_ms) {
+                std::printf("  FAIL: a %zu-cell boundary took longer than one pass over the grid\n", cells);
+                ok = false;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
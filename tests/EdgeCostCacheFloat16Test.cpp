@@ -0,0 +1,115 @@
+// File: EdgeCostCacheFloat16Test.cpp
+//
+// The Float16 EdgeCostCache against the Float32 one on hilly terrain whose values span from 1e-7 to 1e3,
+// so some costs fall below FLOAT16_MIN_NORMAL * scale(), plus a sweep of floatToHalf() over the normal
+// half range.
+//
+// Fails (exit code 1) if the caches disagree on impassability, if a normal-range cost is off by more than
+// FLOAT16_MAX_RELATIVE_ERROR, if a cost below the normal range is not stored as the smallest normal half,
+// or if any stored cost is below cost * (1 - FLOAT16_MAX_RELATIVE_ERROR).
+
+#include "algoritms/EdgeCostCache.hpp"
+#include "map/ElevationRaster.hpp"
+#include "map/MapProcessingCommon.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace mapgeo;
+using namespace Pathfinding;
+using namespace PathfindingUtils;
+
+namespace {
+
+    constexpr int GRID_SIZE = 256;
+    constexpr float CELL_RESOLUTION = 2.0f;
+
+} // end anonymous namespace
+
+int main() {
+    bool ok = true;
+
+    // --- floatToHalf over the normal half range (2^-14 .. 65504) ---
+    float max_sweep_error = 0.0f;
+    for (float v = EdgeCostCache::FLOAT16_MIN_NORMAL; v <= 65504.0f; v *= 1.0001f) {
+        const float back = EdgeCostCache::halfToFloat(EdgeCostCache::floatToHalf(v));
+        max_sweep_error = std::max(max_sweep_error, std::fabs(back - v) / v);
+    }
+    std::printf("floatToHalf sweep: max relative error %.3g (limit %.3g)\n",
+        static_cast<double>(max_sweep_error), static_cast<double>(EdgeCostCache::FLOAT16_MAX_RELATIVE_ERROR));
+    if (max_sweep_error > EdgeCostCache::FLOAT16_MAX_RELATIVE_ERROR) {
+        std::printf("  FAIL: normal-range rounding above FLOAT16_MAX_RELATIVE_ERROR\n");
+        ok = false;
+    }
+
+    // --- Cache against cache: terrain values log-uniform in [1e-7, 1e3], a few impassable cells ---
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    Grid_V3 grid(GRID_SIZE, GRID_SIZE);
+    for (GridCellData& cell : grid.data()) {
+        cell.value = (unit(rng) < 0.05f) ? -1.0f : std::pow(10.0f, -7.0f + 10.0f * unit(rng));
+    }
+    std::vector<float> heights(static_cast<std::size_t>(GRID_SIZE) * GRID_SIZE);
+    for (int y = 0; y < GRID_SIZE; ++y) {
+        for (int x = 0; x < GRID_SIZE; ++x) {
+            heights[static_cast<std::size_t>(y) * GRID_SIZE + x] = 20.0f * std::sin(x * 0.05f) * std::cos(y * 0.07f) + unit(rng);
+        }
+    }
+    const ElevationRaster elevation(GRID_SIZE, GRID_SIZE, CELL_RESOLUTION, std::move(heights));
+    const EdgeCostCache exact = EdgeCostCache::build(grid, elevation, CELL_RESOLUTION, EdgeCostCache::Precision::Float32);
+    const EdgeCostCache half = EdgeCostCache::build(grid, elevation, CELL_RESOLUTION, EdgeCostCache::Precision::Float16);
+    if (!exact.isValid() || !half.isValid()) {
+        std::printf("FAIL: cache build failed\n");
+        return 1;
+    }
+
+    const float min_normal_cost = EdgeCostCache::FLOAT16_MIN_NORMAL * half.scale();
+    const float max_cost = std::numeric_limits<float>::max();
+    float max_relative_error = 0.0f;
+    std::size_t normal = 0, clamped = 0, impassable_mismatches = 0, clamp_mismatches = 0, below_bound = 0;
+    for (int idx = 0; idx < GRID_SIZE * GRID_SIZE; ++idx) {
+        for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+            const float reference = exact.cost(idx, dir);
+            const float stored = half.cost(idx, dir);
+            if ((reference >= max_cost) != (stored >= max_cost)) { ++impassable_mismatches; continue; }
+            if (reference >= max_cost) { continue; }
+            if (stored < reference * (1.0f - EdgeCostCache::FLOAT16_MAX_RELATIVE_ERROR)) { ++below_bound; }
+            if (reference >= min_normal_cost) {
+                ++normal;
+                max_relative_error = std::max(max_relative_error, std::fabs(stored - reference) / reference);
+            }
+            else {
+                ++clamped;
+                if (stored != min_normal_cost) { ++clamp_mismatches; }
+            }
+        }
+    }
+
+    std::printf("Float16 cache: scale %g, %zu normal costs (max relative error %.3g), %zu below %g rounded up\n",
+        static_cast<double>(half.scale()), normal, static_cast<double>(max_relative_error), clamped, static_cast<double>(min_normal_cost));
+    if (max_relative_error > EdgeCostCache::FLOAT16_MAX_RELATIVE_ERROR) {
+        std::printf("  FAIL: normal-range cost above FLOAT16_MAX_RELATIVE_ERROR\n");
+        ok = false;
+    }
+    if (clamped == 0) {
+        std::printf("  FAIL: no cost fell below the normal range; the terrain does not exercise the clamp\n");
+        ok = false;
+    }
+    if (clamp_mismatches != 0) {
+        std::printf("  FAIL: %zu costs below the normal range not stored as FLOAT16_MIN_NORMAL * scale()\n", clamp_mismatches);
+        ok = false;
+    }
+    if (below_bound != 0) {
+        std::printf("  FAIL: %zu stored costs below cost * (1 - FLOAT16_MAX_RELATIVE_ERROR)\n", below_bound);
+        ok = false;
+    }
+    if (impassable_mismatches != 0) {
+        std::printf("  FAIL: %zu edges impassable in only one cache\n", impassable_mismatches);
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}
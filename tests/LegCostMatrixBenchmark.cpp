@@ -0,0 +1,203 @@
+// File: LegCostMatrixBenchmark.cpp
+//
+// computeLegCostMatrix() on synthetic hilly terrain with 12 waypoints, against one point-to-point search
+// per ordered pair. Checks every pair against findDijkstraPath_Tobler_Sampled under each cost model,
+// connectivity and grid storage the legs can use, then times the matrix against 132 separate A*
+// (MIN_COST) calls on the default context. Optional argument: grid side (default 500).
+//
+// Fails (exit code 1) if a matrix path differs from the point-to-point Dijkstra path, or if a matrix
+// cost and the cost of that path differ by more than the float summation error.
+
+#include "algoritms/LegCostMatrix.hpp"
+#include "algoritms/AStarToblerSampled.hpp"
+#include "algoritms/DijkstraToblerSampled.hpp"
+#include "algoritms/EdgeCostCache.hpp"
+#include "algoritms/ToblerKernel.hpp"
+#include "map/CompactGrid.hpp"
+#include "map/ElevationRaster.hpp"
+#include "map/ElevationSampler.hpp"
+#include "map/TiledGrid.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace mapgeo;
+using namespace Pathfinding;
+using namespace PathfindingUtils;
+
+namespace {
+
+    constexpr int NUM_POINTS = 12;
+    constexpr float CELL_RESOLUTION = 2.0f;
+
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Four terrain classes, scattered impassable blobs; the waypoints themselves are kept passable
+    Grid_V3 makeTerrain(int size, std::mt19937& rng, std::vector<GridPoint>& points) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const float classes[] = { 1.0f, 1.25f, 1.6f, 3.0f };
+        Grid_V3 grid(static_cast<std::size_t>(size), static_cast<std::size_t>(size));
+        for (GridCellData& cell : grid.data()) { cell.value = classes[static_cast<int>(unit(rng) * 3.999f)]; }
+        for (int blob = 0; blob < size / 5; ++blob) {
+            const int cx = static_cast<int>(unit(rng) * size);
+            const int cy = static_cast<int>(unit(rng) * size);
+            const int r = 2 + static_cast<int>(unit(rng) * size / 50);
+            for (int y = std::max(0, cy - r); y < std::min(size, cy + r); ++y) {
+                for (int x = std::max(0, cx - r); x < std::min(size, cx + r); ++x) { grid.at(x, y).value = -1.0f; }
+            }
+        }
+        points.clear();
+        for (int i = 0; i < NUM_POINTS; ++i) {
+            const GridPoint p{ static_cast<int>(unit(rng) * (size - 2)) + 1, static_cast<int>(unit(rng) * (size - 2)) + 1 };
+            grid.at(p.x, p.y).value = 1.0f;
+            points.push_back(p);
+        }
+        return grid;
+    }
+
+    // Smooth hills of up to ~60 m on a 1 m DEM grid per cell
+    std::vector<float> makeElevation(int size, std::mt19937& rng) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        const float fx = 0.5f + unit(rng), fy = 0.5f + unit(rng);
+        std::vector<float> dem(static_cast<std::size_t>(size) * size);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const float u = static_cast<float>(x) / size * 6.2832f;
+                const float v = static_cast<float>(y) / size * 6.2832f;
+                dem[static_cast<std::size_t>(y) * size + x] = 30.0f * std::sin(fx * u) * std::cos(fy * v) + 10.0f * std::sin(3.0f * u + 2.0f * v);
+            }
+        }
+        return dem;
+    }
+
+    // Tobler cost of a row-major path under the full (8-connected, sloped) model
+    float toblerPathCost(const PathfindingContext& context, const std::vector<int>& path) {
+        const int width = static_cast<int>(context.grid->width());
+        float total = 0.0f;
+        for (std::size_t i = 1; i < path.size(); ++i) {
+            int x, y, nx, ny;
+            toCoords(path[i - 1], width, x, y);
+            toCoords(path[i], width, nx, ny);
+            int dir = 0;
+            while (dx[dir] != nx - x || dy[dir] != ny - y) { ++dir; }
+            total += stepCost(context, nullptr, x, y, dir);
+        }
+        return total;
+    }
+
+    // Every pair of the matrix against the point-to-point Dijkstra leg on the same context
+    bool checkAgainstLegs(const char* name, const PathfindingContext& context, const std::vector<GridPoint>& points) {
+        const auto start = std::chrono::steady_clock::now();
+        const LegCostMatrix matrix = computeLegCostMatrix(context, points, true);
+        const double matrix_ms = elapsedMs(start);
+
+        SearchWorkspace workspace;
+        std::size_t path_mismatches = 0, reachable = 0;
+        for (std::size_t from = 0; from < points.size(); ++from) {
+            for (std::size_t to = 0; to < points.size(); ++to) {
+                const std::vector<int> leg = findDijkstraPath_Tobler_Sampled(context, workspace, points[from], points[to]);
+                if (leg != matrix.path(from, to) || leg.empty() != !matrix.reachable(from, to)) { ++path_mismatches; }
+                if (matrix.reachable(from, to)) { ++reachable; }
+            }
+        }
+        std::printf("%-30s matrix %8.1f ms, %3zu reachable pairs, %zu paths differ from Dijkstra legs\n",
+            name, matrix_ms, reachable, path_mismatches);
+        return path_mismatches == 0;
+    }
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+    const int size = (argc > 1) ? std::max(64, std::atoi(argv[1])) : 500;
+    std::mt19937 rng(14);
+    std::vector<GridPoint> points;
+    const Grid_V3 grid = makeTerrain(size, rng, points);
+    const std::vector<float> dem = makeElevation(size, rng);
+    const ElevationRaster elevation = ElevationRaster::fromSampler(
+        ElevationSampler(dem, size, size, CELL_RESOLUTION), grid.width(), grid.height(), CELL_RESOLUTION);
+    const EdgeCostCache edge_costs = EdgeCostCache::build(grid, elevation, CELL_RESOLUTION);
+    const CompactGrid compact = CompactGrid::fromGrid(grid);
+    const TiledGrid tiled = TiledGrid::build(compact, &elevation);
+    std::printf("Grid %dx%d, %d waypoints\n\n", size, size, NUM_POINTS);
+
+    bool ok = true;
+    PathfindingContext tobler = makePathfindingContext(grid, &elevation, CELL_RESOLUTION);
+    tobler.queue_type = QueueType::RadixHeap;
+    ok &= checkAgainstLegs("Tobler, 8-connected", tobler, points);
+
+    PathfindingContext cached = tobler;
+    cached.edge_costs = &edge_costs;
+    ok &= checkAgainstLegs("Tobler, edge-cost cache", cached, points);
+
+    PathfindingContext compact_tobler = tobler;
+    compact_tobler.compact_grid = &compact;
+    compact_tobler.queue_type = QueueType::BinaryHeap;
+    ok &= checkAgainstLegs("Tobler, compact grid", compact_tobler, points);
+
+    PathfindingContext tiled_tobler = tobler;
+    tiled_tobler.tiled_grid = &tiled;
+    ok &= checkAgainstLegs("Tobler, tiled grid", tiled_tobler, points);
+
+    PathfindingContext terrain4 = tobler;
+    terrain4.cost_model = CostModel::TerrainOnly;
+    terrain4.connectivity = 4;
+    ok &= checkAgainstLegs("Terrain only, 4-connected", terrain4, points);
+
+    PathfindingContext flat = tobler;
+    flat.cost_model = CostModel::FlatTobler;
+    flat.compact_grid = &compact;
+    ok &= checkAgainstLegs("Flat Tobler, compact grid", flat, points);
+
+    // Matrix against one A* call per ordered pair (what a caller without the matrix would run)
+    auto start = std::chrono::steady_clock::now();
+    const LegCostMatrix matrix = computeLegCostMatrix(tobler, points, true);
+    const double matrix_ms = elapsedMs(start);
+
+    SearchWorkspace workspace;
+    float max_relative_error = 0.0f;
+    std::size_t calls = 0, cost_mismatches = 0;
+    start = std::chrono::steady_clock::now();
+    std::vector<std::vector<int>> astar_paths;
+    for (std::size_t from = 0; from < points.size(); ++from) {
+        for (std::size_t to = 0; to < points.size(); ++to) {
+            if (from == to) { continue; }
+            astar_paths.push_back(findAStarPath_Tobler_Sampled(tobler, workspace, points[from], points[to], HEURISTIC_MIN_COST));
+            ++calls;
+        }
+    }
+    const double astar_ms = elapsedMs(start);
+
+    std::size_t call = 0;
+    for (std::size_t from = 0; from < points.size(); ++from) {
+        for (std::size_t to = 0; to < points.size(); ++to) {
+            if (from == to) { continue; }
+            const std::vector<int>& astar_path = astar_paths[call++];
+            if (!matrix.reachable(from, to)) { continue; }
+            // Both sums run over up to path-length steps, each rounding by at most FLT_EPSILON / 2
+            const float path_cost = toblerPathCost(tobler, matrix.path(from, to));
+            const float astar_cost = toblerPathCost(tobler, astar_path);
+            const float tolerance = static_cast<float>(matrix.path(from, to).size() + 1) * std::numeric_limits<float>::epsilon();
+            const float relative = std::fabs(path_cost - matrix.cost(from, to)) / matrix.cost(from, to);
+            if (relative > tolerance) { ++cost_mismatches; }
+            if (!astar_path.empty()) { max_relative_error = std::max(max_relative_error, std::fabs(astar_cost - matrix.cost(from, to)) / matrix.cost(from, to)); }
+        }
+    }
+
+    std::printf("\nMatrix with paths: %.1f ms; %zu separate A* (MIN_COST) calls: %.1f ms\n", matrix_ms, calls, astar_ms);
+    std::printf("A* costs vs matrix: max relative difference %.3g; matrix costs off their own path: %zu\n",
+        static_cast<double>(max_relative_error), cost_mismatches);
+    if (cost_mismatches != 0) {
+        std::printf("  FAIL: matrix cost differs from the cost of its path\n");
+        ok = false;
+    }
+    if (!ok) { std::printf("  FAIL: matrix and point-to-point legs disagree\n"); }
+    return ok ? 0 : 1;
+}
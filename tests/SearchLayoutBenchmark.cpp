@@ -0,0 +1,173 @@
+// File: SearchLayoutBenchmark.cpp
+//
+// A* and Dijkstra over the compact grid in the row-major and the 8x8 tiled layout, with Tobler and flat
+// Tobler costs, then the flat-terrain 2D mode (constant elevation raster) against Tobler costs on the
+// same raster. Prints time and closed cells per second per configuration.
+// Optional arguments: grid side (default 2048; the layouts only separate on much larger grids, e.g. 8192)
+// and the number of Dijkstra legs (default 1).
+//
+// Fails (exit code 1) if the layouts disagree on a path or on the number of closed cells, or if the 2D
+// mode returns different paths than the Tobler costs it replaces.
+
+#include "algoritms/AStarToblerSampled.hpp"
+#include "algoritms/DijkstraToblerSampled.hpp"
+#include "map/CompactGrid.hpp"
+#include "map/ElevationRaster.hpp"
+#include "map/TiledGrid.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace mapgeo;
+using namespace Pathfinding;
+using namespace PathfindingUtils;
+
+namespace {
+
+    constexpr float CELL_RESOLUTION = 2.0f;
+    constexpr int ASTAR_LEGS = 3;
+
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    struct RunResult {
+        std::vector<std::vector<int>> paths;
+        std::size_t closed = 0;
+        double ms = 0.0;
+    };
+
+    // Banded terrain classes from a smooth pattern, scattered expensive cells and impassable blocks;
+    // a 5x5 passable patch around every waypoint
+    Grid_V3 makeTerrain(int size, const std::vector<GridPoint>& points) {
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        Grid_V3 grid(static_cast<std::size_t>(size), static_cast<std::size_t>(size));
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                const float n = std::sin(x * 0.013f) * std::cos(y * 0.017f) + 0.5f * std::sin((x + y) * 0.031f);
+                float value = (n > 0.9f) ? -1.0f : (n > 0.4f) ? 2.5f : (n > -0.3f) ? 1.25f : 1.0f;
+                if (unit(rng) < 0.02f) { value = 5.0f; }
+                grid.at(x, y).value = value;
+            }
+        }
+        for (int block = 0; block < size / 20; ++block) {
+            const int cx = static_cast<int>(unit(rng) * size);
+            const int cy = static_cast<int>(unit(rng) * size);
+            const int r = 3 + static_cast<int>(unit(rng) * 40);
+            for (int y = std::max(0, cy - r); y < std::min(size, cy + r); ++y) {
+                for (int x = std::max(0, cx - r); x < std::min(size, cx + r); ++x) { grid.at(x, y).setFlag(GridFlags::FLAG_IMPASSABLE); }
+            }
+        }
+        for (const GridPoint& p : points) {
+            for (int y = p.y - 2; y <= p.y + 2; ++y) {
+                for (int x = p.x - 2; x <= p.x + 2; ++x) { grid.at(x, y) = GridCellData(); }
+            }
+        }
+        return grid;
+    }
+
+    ElevationRaster makeHills(int size) {
+        std::vector<float> values(static_cast<std::size_t>(size) * size);
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                values[static_cast<std::size_t>(y) * size + x] = 40.0f * std::sin(x * 0.004f) * std::cos(y * 0.006f) + 3.0f * std::sin(x * 0.05f + y * 0.03f);
+            }
+        }
+        return ElevationRaster(static_cast<std::size_t>(size), static_cast<std::size_t>(size), CELL_RESOLUTION, std::move(values));
+    }
+
+    RunResult runLegs(const char* name, const PathfindingContext& context, bool dijkstra, int legs, const std::vector<GridPoint>& points) {
+        static SearchWorkspace workspace;
+        RunResult result;
+        for (int leg = 0; leg < legs; ++leg) {
+            const auto start = std::chrono::steady_clock::now();
+            result.paths.push_back(dijkstra
+                ? findDijkstraPath_Tobler_Sampled(context, workspace, points[leg], points[leg + 1])
+                : findAStarPath_Tobler_Sampled(context, workspace, points[leg], points[leg + 1], HEURISTIC_MIN_COST));
+            result.ms += elapsedMs(start);
+            for (std::size_t idx = 0; idx < workspace.capacity(); ++idx) {
+                if (workspace.isClosed(static_cast<int>(idx))) { ++result.closed; }
+            }
+        }
+        std::printf("%-32s %9.1f ms %11zu closed %6.2f M closed/s\n",
+            name, result.ms, result.closed, static_cast<double>(result.closed) / (result.ms * 1e3));
+        std::fflush(stdout);
+        return result;
+    }
+
+} // end anonymous namespace
+
+int main(int argc, char** argv) {
+    const int size = (argc > 1) ? std::max(128, std::atoi(argv[1])) : 2048;
+    const int dijkstra_legs = (argc > 2) ? std::min(ASTAR_LEGS, std::max(1, std::atoi(argv[2]))) : 1;
+    const std::vector<GridPoint> points = { { 20, 20 }, { size - 30, size / 2 }, { size / 3, size - 30 }, { size - 40, size - 40 } };
+    const Grid_V3 grid = makeTerrain(size, points);
+    const ElevationRaster hills = makeHills(size);
+
+    auto start = std::chrono::steady_clock::now();
+    const CompactGrid compact = CompactGrid::fromGrid(grid);
+    const double compact_ms = elapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    const TiledGrid tiled = TiledGrid::build(compact, &hills);
+    const double tiled_ms = elapsedMs(start);
+    std::printf("Grid %dx%d: compact grid %.0f ms %.1f MB, tiled copies %.0f ms %.1f MB\n\n", size, size,
+        compact_ms, compact.memoryBytes() / 1048576.0, tiled_ms, tiled.memoryBytes() / 1048576.0);
+
+    bool ok = true;
+    const CostModel models[] = { CostModel::Tobler, CostModel::FlatTobler };
+    for (const CostModel model : models) {
+        for (const bool dijkstra : { false, true }) {
+            const char* search = dijkstra ? "Dijkstra" : "A*";
+            const char* costs = (model == CostModel::Tobler) ? "Tobler" : "flat";
+            const int legs = dijkstra ? dijkstra_legs : ASTAR_LEGS;
+            PathfindingContext context = makePathfindingContext(grid, &hills, CELL_RESOLUTION);
+            context.queue_type = QueueType::RadixHeap;
+            context.cost_model = model;
+            context.compact_grid = &compact;
+
+            char name[64];
+            std::snprintf(name, sizeof(name), "%s %s row-major", search, costs);
+            const RunResult row_major = runLegs(name, context, dijkstra, legs, points);
+            context.tiled_grid = &tiled;
+            std::snprintf(name, sizeof(name), "%s %s tiled", search, costs);
+            const RunResult tiled_run = runLegs(name, context, dijkstra, legs, points);
+            if (row_major.paths != tiled_run.paths || row_major.closed != tiled_run.closed) {
+                std::printf("  FAIL: layouts disagree\n");
+                ok = false;
+            }
+        }
+    }
+
+    // 2D mode: a constant raster makes every slope zero, so FlatTobler must give the Tobler paths
+    std::printf("\n");
+    const ElevationRaster flat_raster = ElevationRaster::constant(grid.width(), grid.height(), CELL_RESOLUTION, 100.0f);
+    const TiledGrid flat_tiled = TiledGrid::build(compact, &flat_raster);
+    for (const bool dijkstra : { false, true }) {
+        const char* search = dijkstra ? "Dijkstra" : "A*";
+        const int legs = dijkstra ? dijkstra_legs : ASTAR_LEGS;
+        PathfindingContext context = makePathfindingContext(grid, &flat_raster, CELL_RESOLUTION);
+        context.queue_type = QueueType::RadixHeap;
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s constant raster, Tobler", search);
+        const RunResult tobler = runLegs(name, context, dijkstra, legs, points);
+        context.cost_model = CostModel::FlatTobler;
+        std::snprintf(name, sizeof(name), "%s 2D (FlatTobler)", search);
+        const RunResult flat = runLegs(name, context, dijkstra, legs, points);
+        context.compact_grid = &compact;
+        context.tiled_grid = &flat_tiled;
+        std::snprintf(name, sizeof(name), "%s 2D tiled", search);
+        const RunResult flat_tiled_run = runLegs(name, context, dijkstra, legs, points);
+        if (tobler.paths != flat.paths || flat.paths != flat_tiled_run.paths) {
+            std::printf("  FAIL: 2D mode paths differ from Tobler costs on the constant raster\n");
+            ok = false;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+// File: ToblerKernelAccuracyTest.cpp
+//
+// Every toblerEdgeCosts8() variant the CPU can run against PathfindingUtils::toblerEdgeCost (std::exp).
+// Sweeps every direction over slopes from -5 to 5 (past the impassable limit on both sides, away from the
+// ln(1 / EPSILON) boundary itself) at several resolutions.
+//
+// Fails (exit code 1) if the relative error exceeds TOBLER_KERNEL_MAX_RELATIVE_ERROR, if a variant and
+// the reference disagree on impassability, or if the variants and toblerStepCost() are not bit-identical.
+
+#include "algoritms/ToblerKernel.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace Pathfinding;
+using namespace PathfindingUtils;
+
+namespace {
+
+    bool sameBits(float a, float b) {
+        std::uint32_t ua, ub;
+        std::memcpy(&ua, &a, sizeof(ua));
+        std::memcpy(&ub, &b, sizeof(ub));
+        return ua == ub;
+    }
+
+} // end anonymous namespace
+
+int main() {
+    const std::vector<ToblerKernelVariant> variants = toblerKernelVariants();
+    const float resolutions[] = { 0.5f, 1.0f, 2.5f, 7.0f };
+    const float terrains[NUM_DIRECTIONS] = { 1.0f, 1.5f, 0.8f, 3.0f, 1.0f, 2.0f, 1.25f, 10.0f };
+    constexpr int SLOPE_STEPS = 20001; // S from -5 to 5
+    constexpr float MAX_SLOPE = 5.0f;
+    float delta_h[NUM_DIRECTIONS];
+    float out[NUM_DIRECTIONS];
+
+    float max_relative_error = 0.0f;
+    std::size_t samples = 0;
+    std::size_t impassable_mismatches = 0; // Finite in one, max() in the other
+    std::vector<std::size_t> variant_mismatches(variants.size(), 0);
+
+    for (const float res : resolutions) {
+        for (int step = 0; step < SLOPE_STEPS; ++step) {
+            const float S = -MAX_SLOPE + 2.0f * MAX_SLOPE * static_cast<float>(step) / static_cast<float>(SLOPE_STEPS - 1);
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) { delta_h[dir] = S * costs[dir] * res; }
+
+            float expected[NUM_DIRECTIONS];
+            bool on_boundary[NUM_DIRECTIONS];
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                expected[dir] = toblerStepCost(dir, res, delta_h[dir], terrains[dir]);
+                const float x = tobler_kernel_detail::SLOPE_RATE * std::fabs(delta_h[dir] / (costs[dir] * res) + tobler_kernel_detail::SLOPE_OFFSET);
+                on_boundary[dir] = std::fabs(x - tobler_kernel_detail::LN_INV_EPSILON) < 1e-5f;
+            }
+            for (std::size_t v = 0; v < variants.size(); ++v) {
+                variants[v].fn(res, delta_h, terrains, out);
+                for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                    if (!sameBits(out[dir], expected[dir])) { ++variant_mismatches[v]; }
+                }
+            }
+
+            for (int dir = 0; dir < NUM_DIRECTIONS; ++dir) {
+                if (on_boundary[dir]) { continue; } // Either answer is acceptable within an ulp of the cutoff
+                const float reference = toblerEdgeCost(dir, res, delta_h[dir], terrains[dir]);
+                ++samples;
+                const bool ref_blocked = reference >= std::numeric_limits<float>::max();
+                const bool got_blocked = expected[dir] >= std::numeric_limits<float>::max();
+                if (ref_blocked != got_blocked) { ++impassable_mismatches; continue; }
+                if (ref_blocked) { continue; }
+                max_relative_error = std::max(max_relative_error, std::fabs(expected[dir] - reference) / reference);
+            }
+        }
+    }
+
+    bool ok = true;
+    std::printf("Dispatch: %s\n", toblerKernelVariant());
+    for (std::size_t v = 0; v < variants.size(); ++v) {
+        std::printf("%-8s %zu costs differ from toblerStepCost\n", variants[v].name, variant_mismatches[v]);
+        if (variant_mismatches[v] != 0) { ok = false; }
+    }
+    std::printf("Samples %zu, max relative error %.3g (limit %.3g), impassable mismatches %zu\n",
+        samples, static_cast<double>(max_relative_error), static_cast<double>(TOBLER_KERNEL_MAX_RELATIVE_ERROR), impassable_mismatches);
+    if (max_relative_error > TOBLER_KERNEL_MAX_RELATIVE_ERROR) {
+        std::printf("  FAIL: relative error above TOBLER_KERNEL_MAX_RELATIVE_ERROR\n");
+        ok = false;
+    }
+    if (impassable_mismatches != 0) {
+        std::printf("  FAIL: kernel and reference disagree on impassable edges\n");
+        ok = false;
+    }
+    return ok ? 0 : 1;
+}